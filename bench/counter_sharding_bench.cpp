@@ -0,0 +1,87 @@
+// bench/counter_sharding_bench.cpp
+//
+// False-sharing microbenchmark for the miner's hot counters. "shared" is the
+// old Counters layout: adjacent atomics on one cache line, bumped with
+// fetch_add by every worker. "sharded" is one alignas(64) block per worker
+// written with single_writer_add. Both do the per-chunk update pattern
+// (progress store, hash total add, occasional share) back to back, so this is
+// the worst case; real workers update once per scan block.
+//
+// Compare items_per_second as threads grow, e.g. on a 16+ core machine:
+//   counter_sharding_bench --benchmark_filter=threads:16
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "util/sharded_counters.hpp"
+
+namespace {
+
+using cpu_miner::util::ShardedCounters;
+using cpu_miner::util::single_writer_add;
+
+constexpr int kMaxThreads = 64;
+
+struct SharedCounters {
+   std::atomic<std::uint64_t> hashes_done{0};
+   std::atomic<std::uint64_t> shares_found{0};
+   std::atomic<std::uint64_t> blocks_found{0};
+   std::atomic<std::uint64_t> current_scan_hashes_done{0};
+};
+
+struct alignas(cpu_miner::util::kCacheLineBytes) WorkerBlock {
+   std::atomic<std::uint64_t> hashes_done{0};
+   std::atomic<std::uint64_t> shares_found{0};
+   std::atomic<std::uint64_t> blocks_found{0};
+   std::atomic<std::uint64_t> current_scan_hashes_done{0};
+};
+
+SharedCounters g_shared;
+ShardedCounters<WorkerBlock> g_sharded(kMaxThreads);
+
+void BM_shared_counters(benchmark::State& state) {
+   std::uint64_t progress = 0;
+
+   for (auto _ : state) {
+      g_shared.current_scan_hashes_done.store(++progress,
+                                              std::memory_order_relaxed);
+      g_shared.hashes_done.fetch_add(64U, std::memory_order_relaxed);
+      if ((progress & 0xffU) == 0U) {
+         g_shared.shares_found.fetch_add(1U, std::memory_order_relaxed);
+      }
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_shared_counters)->ThreadRange(1, 32)->UseRealTime();
+
+void BM_sharded_counters(benchmark::State& state) {
+   WorkerBlock& block =
+      g_sharded[static_cast<std::size_t>(state.thread_index())];
+   std::uint64_t progress = 0;
+
+   for (auto _ : state) {
+      block.current_scan_hashes_done.store(++progress,
+                                           std::memory_order_relaxed);
+      single_writer_add(block.hashes_done, 64U);
+      if ((progress & 0xffU) == 0U) {
+         single_writer_add(block.shares_found, 1U);
+      }
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_sharded_counters)->ThreadRange(1, 32)->UseRealTime();
+
+// What the status line and metrics exporter pay per read.
+void BM_sharded_sum(benchmark::State& state) {
+   for (auto _ : state) {
+      benchmark::DoNotOptimize(g_sharded.sum(&WorkerBlock::hashes_done));
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_sharded_sum);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,181 @@
+// bench/cpu_miner_bench.cpp
+//
+// Google Benchmark suite covering each hashing layer, from the raw SHA-256
+// compression up to a full nonce scan, plus the job-preparation and parsing
+// steps that sit on the job-switch path. All inputs come from the accepted
+// ckpool fixture so numbers are comparable across machines and commits.
+//
+// JSON for tracking over time:
+//   cpu_miner_bench --benchmark_out=bench.json --benchmark_out_format=json
+// or build the cpu_miner_bench_json target.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/header.hpp"
+#include "mining_job/job.hpp"
+#include "mining_job/merkle.hpp"
+#include "mining_job/scan.hpp"
+#include "mining_job/work_state.hpp"
+#include "sha256/sha256.hpp"
+#include "stratum_client/messages.hpp"
+#include "util/hex.hpp"
+#include "util/log.hpp"
+#include "util/uint256.hpp"
+
+namespace {
+
+using namespace cpu_miner;
+
+const PreparedWork& fixture_work() {
+   static const PreparedWork prepared =
+      prepare_work(make_accepted_job(), make_accepted_subscription(), 0U);
+   return prepared;
+}
+
+void BM_compress_block(benchmark::State& state) {
+   const auto& header = fixture_work().header_template;
+   sha256::DigestWords digest = sha256::initial_state();
+
+   for (auto _ : state) {
+      digest = sha256::compress_block(digest, header.block0);
+      benchmark::DoNotOptimize(digest);
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_compress_block);
+
+void BM_dbl_sha256_two_block_header(benchmark::State& state) {
+   const auto& header = fixture_work().header_template;
+
+   for (auto _ : state) {
+      auto digest =
+         sha256::dbl_sha256_two_block_header(header.midstate, header.block1);
+      benchmark::DoNotOptimize(digest);
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_dbl_sha256_two_block_header);
+
+void BM_hash_header_template(benchmark::State& state) {
+   HeaderTemplate header = fixture_work().header_template;
+   std::uint32_t nonce = 0;
+
+   for (auto _ : state) {
+      set_header_nonce(header, nonce++);
+      auto digest = hash_header_template(header);
+      benchmark::DoNotOptimize(digest);
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_hash_header_template);
+
+void BM_scan_nonce_range(benchmark::State& state) {
+   const auto nonces = static_cast<std::uint64_t>(state.range(0));
+   // Zero targets never match, so the scan never leaves the hash loop.
+   const u256::uint256 no_match{};
+   const ScanControl control{};
+
+   for (auto _ : state) {
+      WorkState work = work_state_from_prepared(fixture_work(), 0U);
+      auto result = scan_nonce_range(work, no_match, no_match, 0U, nonces - 1U,
+                                     control, nullptr);
+      benchmark::DoNotOptimize(result);
+   }
+   state.SetItemsProcessed(state.iterations() *
+                           static_cast<std::int64_t>(nonces));
+}
+BENCHMARK(BM_scan_nonce_range)
+   ->Arg(1 << 20)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+void BM_prepare_work(benchmark::State& state) {
+   const MiningJob job = make_accepted_job();
+   const DecodedJob decoded = decode_job(job);
+   const SubscriptionContext subscription = make_accepted_subscription();
+   std::uint64_t extranonce2 = 0;
+
+   for (auto _ : state) {
+      auto prepared = prepare_work(job, decoded, subscription, extranonce2++);
+      benchmark::DoNotOptimize(prepared);
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_prepare_work);
+
+void BM_merkle_fold(benchmark::State& state) {
+   const auto branches = static_cast<std::size_t>(state.range(0));
+   const DecodedJob decoded = decode_job(make_accepted_job());
+
+   std::vector<HashBytes> branch;
+   branch.reserve(branches);
+   for (std::size_t i = 0; i < branches; ++i) {
+      branch.push_back(decoded.merkle_branch[i % decoded.merkle_branch.size()]);
+   }
+
+   const HashBytes coinbase_hash = fixture_work().coinbase.coinbase_hash;
+
+   for (auto _ : state) {
+      auto root = merkle_fold(coinbase_hash, branch);
+      benchmark::DoNotOptimize(root);
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_merkle_fold)->Arg(12);
+
+void BM_hex_to_bytes(benchmark::State& state) {
+   const std::string hex = make_accepted_job().coinb2;
+
+   for (auto _ : state) {
+      auto bytes = hex_to_bytes(hex);
+      benchmark::DoNotOptimize(bytes);
+   }
+   state.SetBytesProcessed(state.iterations() *
+                           static_cast<std::int64_t>(hex.size() / 2U));
+}
+BENCHMARK(BM_hex_to_bytes);
+
+void BM_parse_incoming_message(benchmark::State& state) {
+   const std::string line(kAcceptedNotifyLine);
+
+   for (auto _ : state) {
+      auto parsed = parse_incoming_message(line);
+      benchmark::DoNotOptimize(parsed);
+   }
+   state.SetBytesProcessed(state.iterations() *
+                           static_cast<std::int64_t>(line.size()));
+}
+BENCHMARK(BM_parse_incoming_message);
+
+// Producer side of the async logger: what a share-accepted line costs the
+// control thread. Back-to-back calls outrun the writer, so part of the run
+// takes the ring-full drop path, which is the overflow behaviour by design.
+void BM_log_share_accepted(benchmark::State& state) {
+   std::FILE* sink = std::tmpfile();
+   {
+      const util::LogWriter writer(sink);
+      const std::string job_id = make_accepted_job().job_id;
+      std::uint64_t generation = 0;
+
+      for (auto _ : state) {
+         CPU_MINER_LOG_INFO("share accepted: generation={} job_id={} "
+                            "extranonce2={} ntime={} nonce={}",
+                            ++generation, job_id, "0000000000000000",
+                            "69bccef7", "00293f3b");
+      }
+      state.SetItemsProcessed(state.iterations());
+   }
+   std::fclose(sink);
+}
+BENCHMARK(BM_log_share_accepted);
+
+} // namespace
+
+BENCHMARK_MAIN();
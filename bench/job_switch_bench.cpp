@@ -0,0 +1,224 @@
+// bench/job_switch_bench.cpp
+//
+// Fires synthetic mining.notify lines at a pool of scanning workers and
+// reports the notify -> publish -> adopt -> first hash latency distribution.
+// Publishing and adoption mirror the miner: one shared slot guarded by a
+// mutex, a condition variable for idle workers, and a per-worker abort flag
+// that the publisher sets and scan_nonce_range polls between check blocks.
+//
+// Usage: job_switch_bench [workers [notifies [interval_ms]]]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "mining_job/abort_flag.hpp"
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/coordinator.hpp"
+#include "mining_job/cpu_backend.hpp"
+#include "mining_job/job.hpp"
+#include "mining_job/scan.hpp"
+#include "mining_job/switch_latency.hpp"
+#include "stratum_client/messages.hpp"
+#include "stratum_client/notify_parser.hpp"
+#include "util/hex.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint64_t kChunkNonces = 1U << 20;
+
+struct Published {
+   cpu_miner::MiningJob job;
+   cpu_miner::DecodedJob decoded;
+   std::uint64_t generation{};
+};
+
+struct SharedSlot {
+   std::mutex mutex;
+   std::condition_variable_any cv;
+   std::optional<Published> published;
+   std::vector<cpu_miner::AbortFlag> aborts;
+};
+
+cpu_miner::MiningJob job_from_notify(const cpu_miner::NotifyMessage& msg) {
+   return cpu_miner::MiningJob{
+      .job_id = msg.job_id,
+      .prevhash = msg.prevhash,
+      .coinb1 = msg.coinb1,
+      .coinb2 = msg.coinb2,
+      .merkle_branch = msg.merkle_branch,
+      .version = msg.version,
+      .nbits = msg.nbits,
+      .ntime = msg.ntime,
+      .clean_jobs = msg.clean_jobs,
+   };
+}
+
+// The captured notify with its 16-hex job id replaced, so each line is new.
+std::string synthetic_notify(std::uint64_t index) {
+   std::string line(cpu_miner::kAcceptedNotifyLine);
+   const std::string_view old_id = "69b23e1000005c34";
+   line.replace(line.find(old_id), old_id.size(),
+                cpu_miner::hex_from_u64_be(index, 8U));
+   return line;
+}
+
+void run_worker(SharedSlot& slot, cpu_miner::SwitchLatencyRecorder& latency,
+                std::size_t worker, std::stop_token stop_token) {
+   cpu_miner::CpuHasherBackend backend;
+   cpu_miner::MiningCoordinator coordinator{backend};
+   const cpu_miner::SubscriptionContext subscription =
+      cpu_miner::make_accepted_subscription();
+   // A zero share target never matches, so no share callbacks run.
+   const cpu_miner::u256::uint256 no_shares{};
+
+   std::uint64_t seen = 0;
+   while (!stop_token.stop_requested()) {
+      Published published;
+      {
+         std::unique_lock<std::mutex> lock(slot.mutex);
+         slot.cv.wait(lock, stop_token, [&]() {
+            return slot.published && slot.published->generation != seen;
+         });
+         if (stop_token.stop_requested()) return;
+         slot.aborts[worker].clear_stale();
+         published = *slot.published;
+      }
+
+      seen = published.generation;
+      latency.note_adopted(seen, worker, Clock::now());
+
+      coordinator.set_job(published.job, published.decoded, subscription,
+                          worker);
+
+      const cpu_miner::ScanControl control{
+         .stop_token = stop_token,
+         .expected_generation = seen,
+         .abort = &slot.aborts[worker],
+      };
+
+      bool first_hash_noted = false;
+      for (std::uint64_t begin = 0;; begin += kChunkNonces) {
+         const auto result = coordinator.scan_range(
+            begin, begin + kChunkNonces - 1U, no_shares, no_shares, control);
+
+         if (!first_hash_noted && result.hashes_done != 0U) {
+            first_hash_noted = true;
+            latency.note_first_hash(seen, worker, result.first_hash_at);
+         }
+
+         if (result.stop_reason != cpu_miner::ScanStopReason::exhausted) {
+            break;
+         }
+      }
+   }
+}
+
+void print_summary(const char* label, const cpu_miner::LatencySummary& s) {
+   std::cout << std::left << std::setw(22) << label << std::right
+             << std::setw(6) << s.count << std::setw(11) << s.min_us
+             << std::setw(11) << s.p50_us << std::setw(11) << s.p90_us
+             << std::setw(11) << s.p99_us << std::setw(11) << s.max_us
+             << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+   const std::size_t workers =
+      (argc > 1) ? std::strtoull(argv[1], nullptr, 10)
+                 : std::max(1U, std::thread::hardware_concurrency());
+   const std::uint64_t notifies =
+      (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 200ULL;
+   const auto interval = std::chrono::milliseconds(
+      (argc > 3) ? std::strtoll(argv[3], nullptr, 10) : 20LL);
+
+   if (workers == 0U || notifies == 0U) {
+      std::cerr << "usage: job_switch_bench [workers [notifies "
+                   "[interval_ms]]]\n";
+      return 1;
+   }
+
+   SharedSlot slot;
+   slot.aborts = std::vector<cpu_miner::AbortFlag>(workers);
+   cpu_miner::SwitchLatencyRecorder latency(workers);
+
+   std::vector<std::jthread> threads;
+   threads.reserve(workers);
+   for (std::size_t worker = 0; worker < workers; ++worker) {
+      threads.emplace_back([&, worker](std::stop_token stop_token) {
+         const std::stop_callback abort_on_stop(
+            stop_token, [&]() { slot.aborts[worker].request_stop(); });
+         run_worker(slot, latency, worker, stop_token);
+      });
+   }
+
+   cpu_miner::NotifyMessage msg;
+   cpu_miner::DecodedJob decoded;
+
+   for (std::uint64_t i = 1; i <= notifies; ++i) {
+      const std::string line = synthetic_notify(i);
+
+      // The notify "arrives" when its line is complete, as in read_line().
+      const auto received = Clock::now();
+      if (!cpu_miner::parse_notify_line(line, msg, decoded)) {
+         std::cerr << "synthetic notify failed to parse\n";
+         return 1;
+      }
+
+      Published next{
+         .job = job_from_notify(msg),
+         .decoded = decoded,
+         .generation = i,
+      };
+
+      const auto published = Clock::now();
+      latency.note_published(i, received, published);
+      {
+         std::lock_guard<std::mutex> lock(slot.mutex);
+         slot.published = std::move(next);
+         for (auto& abort : slot.aborts) {
+            abort.request_stale();
+         }
+      }
+      slot.cv.notify_all();
+
+      std::this_thread::sleep_for(interval);
+   }
+
+   for (auto& thread : threads) {
+      thread.request_stop();
+   }
+   threads.clear();
+
+   const auto report = latency.report();
+
+   std::cout << "workers: " << workers << "  notifies: " << notifies
+             << "  interval: " << interval.count() << " ms\n";
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::left << std::setw(22) << "stage (us)" << std::right
+             << std::setw(6) << "n" << std::setw(11) << "min" << std::setw(11)
+             << "p50" << std::setw(11) << "p90" << std::setw(11) << "p99"
+             << std::setw(11) << "max" << '\n';
+   print_summary("notify->publish", report.notify_to_publish);
+   print_summary("publish->adopt", report.publish_to_adopt);
+   print_summary("adopt->first hash", report.adopt_to_first_hash);
+   print_summary("notify->all hashing", report.notify_to_all_hashing);
+   std::cout << "superseded generations: " << report.superseded << '\n';
+
+   return report.notify_to_all_hashing.count == 0U ? 1 : 0;
+}
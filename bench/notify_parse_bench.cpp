@@ -0,0 +1,83 @@
+// bench/notify_parse_bench.cpp
+//
+// Compares the boost::json DOM path (parse_incoming_message + decode_job)
+// with the streaming parse_notify_line fast path on a captured ckpool
+// mining.notify line.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/job.hpp"
+#include "stratum_client/messages.hpp"
+#include "stratum_client/notify_parser.hpp"
+
+namespace {
+
+template<class Fn>
+double ns_per_op(std::uint64_t iterations, Fn&& fn) {
+   const auto start = std::chrono::steady_clock::now();
+   for (std::uint64_t i = 0; i < iterations; ++i) {
+      fn();
+   }
+   const auto end = std::chrono::steady_clock::now();
+   const std::chrono::duration<double, std::nano> elapsed = end - start;
+   return elapsed.count() / static_cast<double>(iterations);
+}
+
+cpu_miner::MiningJob job_from_notify(const cpu_miner::NotifyMessage& msg) {
+   return cpu_miner::MiningJob{
+      .job_id = msg.job_id,
+      .prevhash = msg.prevhash,
+      .coinb1 = msg.coinb1,
+      .coinb2 = msg.coinb2,
+      .merkle_branch = msg.merkle_branch,
+      .version = msg.version,
+      .nbits = msg.nbits,
+      .ntime = msg.ntime,
+      .clean_jobs = msg.clean_jobs,
+   };
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+   const std::uint64_t iterations =
+      (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 200'000ULL;
+   const std::string line(cpu_miner::kAcceptedNotifyLine);
+
+   std::uint64_t sink = 0;
+
+   const double dom_ns = ns_per_op(iterations, [&]() {
+      const auto parsed = cpu_miner::parse_incoming_message(line);
+      const auto* notify = std::get_if<cpu_miner::NotifyMessage>(&*parsed);
+      const auto decoded = cpu_miner::decode_job(job_from_notify(*notify));
+      sink += decoded.ntime;
+   });
+
+   cpu_miner::NotifyMessage msg;
+   cpu_miner::DecodedJob decoded;
+
+   const double fast_ns = ns_per_op(iterations, [&]() {
+      if (cpu_miner::parse_notify_line(line, msg, decoded)) {
+         sink += decoded.ntime;
+      }
+   });
+
+   std::cout << "notify line bytes: " << line.size() << '\n';
+   std::cout << "iterations: " << iterations << '\n';
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << "dom parse + decode_job: " << dom_ns << " ns/op\n";
+   std::cout << "parse_notify_line:      " << fast_ns << " ns/op\n";
+   std::cout << "speedup: " << std::setprecision(2) << (dom_ns / fast_ns)
+             << "x\n";
+
+   return sink == 0U ? 1 : 0;
+}
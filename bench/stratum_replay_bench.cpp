@@ -0,0 +1,85 @@
+// bench/stratum_replay_bench.cpp
+//
+// Replays a captured Stratum session (cpu_miner --capture) through
+// StratumClient with no pool and no waiting, and reports how fast the
+// client consumes it as time per mining.notify, which covers read framing,
+// parsing and job adoption. Without a capture it replays the
+// accepted ckpool notify line repeated after a minimal handshake.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "stratum_client/stratum_client.hpp"
+#include "stratum_client/wire_capture.hpp"
+
+namespace {
+
+std::vector<cpu_miner::WireLine> synthetic_capture(std::uint64_t notifies) {
+   std::ostringstream capture;
+   capture << R"(0 < {"id":1,"result":[[["mining.notify","b2"]],)"
+           << R"("3f3eb26900000000",8],"error":null})" << '\n';
+   capture << R"(100 < {"id":2,"result":true,"error":null})" << '\n';
+   capture << R"(200 < {"id":null,"method":"mining.set_difficulty",)"
+           << R"("params":[10000]})" << '\n';
+   for (std::uint64_t i = 0; i < notifies; ++i) {
+      capture << 1000U + i * 1000U << " < "
+              << cpu_miner::kAcceptedNotifyLine << '\n';
+   }
+
+   std::istringstream in(capture.str());
+   return cpu_miner::parse_wire_capture(in);
+}
+
+} // namespace
+
+// Usage: stratum_replay_bench [CAPTURE [SPEED]]
+int main(int argc, char* argv[]) {
+   try {
+      auto lines = argc > 1 ? cpu_miner::load_wire_capture(argv[1])
+                            : synthetic_capture(20'000U);
+      const double speed = argc > 2 ? std::strtod(argv[2], nullptr) : 0.0;
+
+      cpu_miner::StratumClient client(
+         cpu_miner::WireReplay(std::move(lines), speed));
+
+      const auto start = std::chrono::steady_clock::now();
+      std::uint64_t polls = 0;
+      try {
+         client.connect();
+         client.subscribe();
+         client.authorize("bench.worker", "x");
+         client.run_until_ready();
+         for (;;) {
+            (void)client.poll();
+            ++polls;
+         }
+      } catch (const cpu_miner::WireReplayFinished&) {
+      }
+      const std::chrono::duration<double> elapsed =
+         std::chrono::steady_clock::now() - start;
+
+      const std::uint64_t notifies = client.notify_count();
+      std::cout << "polls: " << polls << '\n';
+      std::cout << "notifies: " << notifies << '\n';
+      std::cout << std::fixed << std::setprecision(3);
+      std::cout << "elapsed seconds: " << elapsed.count() << '\n';
+      if (notifies != 0U) {
+         std::cout << std::setprecision(2) << "per notify: "
+                   << elapsed.count() * 1e6 / static_cast<double>(notifies)
+                   << " us\n";
+      }
+      return notifies == 0U ? 1 : 0;
+   } catch (const std::exception& ex) {
+      std::cerr << "fatal: " << ex.what() << '\n';
+      return 1;
+   }
+}
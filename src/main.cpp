@@ -1,5 +1,7 @@
 // src/main.cpp
 
+#include <boost/system/system_error.hpp>
+
 #include <algorithm>
 #include <atomic>
 #include <chrono>
@@ -7,10 +9,12 @@
 #include <condition_variable>
 #include <csignal>
 #include <cstdint>
+#include <deque>
 #include <exception>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
@@ -18,19 +22,39 @@
 #include <stop_token>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include "mining_job/abort_flag.hpp"
+#include "mining_job/autotune.hpp"
 #include "mining_job/coinbase.hpp"
 #include "mining_job/coordinator.hpp"
-#include "mining_job/cpu_backend.hpp"
+#include "mining_job/event_journal.hpp"
+#include "mining_job/hashrate_benchmark.hpp"
 #include "mining_job/header.hpp"
+#include "mining_job/job_table.hpp"
 #include "mining_job/scan.hpp"
+#include "mining_job/seen_shares.hpp"
+#include "mining_job/share_target_slot.hpp"
+#include "mining_job/switch_latency.hpp"
 #include "mining_job/target.hpp"
+#include "mining_job/wasted_work.hpp"
 #include "mining_job/work_state.hpp"
 #include "sha256/sha256.hpp"
+#include "stratum_client/pool_set.hpp"
+#include "stratum_client/session.hpp"
 #include "stratum_client/stratum_client.hpp"
+#include "stratum_client/vardiff.hpp"
+#include "stratum_client/wire_capture.hpp"
+#include "util/cycles.hpp"
 #include "util/hex.hpp"
+#include "util/journal.hpp"
+#include "util/log.hpp"
+#include "util/metrics_server.hpp"
+#include "util/openmetrics.hpp"
+#include "util/sharded_counters.hpp"
 #include "util/uint256.hpp"
 
 namespace {
@@ -39,6 +63,11 @@ volatile std::sig_atomic_t g_sigint_requested = 0;
 
 void handle_sigint(int) { g_sigint_requested = 1; }
 
+// SIGUSR1 asks for a cycle counter dump; printed from the main loop.
+volatile std::sig_atomic_t g_cycle_dump_requested = 0;
+
+void handle_cycle_dump(int) { g_cycle_dump_requested = 1; }
+
 void print_startup_sanity(const cpu_miner::WorkState& work) {
    std::cout << "coinbase demo:\n";
    std::cout << "  extranonce2: " << work.coinbase.extranonce2_hex << '\n';
@@ -69,15 +98,11 @@ void print_startup_sanity(const cpu_miner::WorkState& work) {
 
    std::cout << "  merkle_root: " << work.merkle_root_raw_hex << '\n';
 
-   const std::uint32_t version = cpu_miner::u32_from_hex_be(work.job.version);
-   const std::uint32_t ntime = cpu_miner::u32_from_hex_be(work.job.ntime);
-   const std::uint32_t nbits = cpu_miner::u32_from_hex_be(work.job.nbits);
    const std::uint32_t nonce0 = 0U;
 
-   const auto header =
-      cpu_miner::make_sha_input_header_bytes(version, work.prevhash_sha_input,
-                                             work.merkle_root_sha_input, ntime,
-                                             nbits, nonce0);
+   const auto header = cpu_miner::make_sha_input_header_bytes(
+      work.decoded.version, work.prevhash_sha_input, work.merkle_root_sha_input,
+      work.decoded.ntime, work.decoded.nbits, nonce0);
 
    const std::string header_hex = cpu_miner::header_sha_input_hex(header);
    const auto header_hash_words = cpu_miner::sha256::dbl_sha256_words(header);
@@ -106,17 +131,66 @@ struct PublishedWork {
    cpu_miner::u256::uint256 share_target{};
    std::uint64_t generation{};
    double share_difficulty{};
+   // Originating pool connection; shares found on this work are submitted
+   // there while its job stays in the pool's JobTable.
+   std::size_t pool{};
 };
 
 struct SharedWorkState {
    std::mutex mutex;
    std::condition_variable cv;
    std::optional<PublishedWork> published;
+   // What the worker last took from `published`; it keeps hashing this
+   // until its range ends while newer work leaves the job valid.
+   std::optional<PublishedWork> adopted;
+   // Set when the worker must switch work and on shutdown; the worker's scan
+   // polls only this.
+   cpu_miner::AbortFlag worker_abort;
+   // Share target of the adopted work; set_difficulty replaces it under the
+   // running scan.
+   cpu_miner::ShareTargetSlot share_target;
+   // Notify-to-hashing latency for the single worker thread.
+   cpu_miner::SwitchLatencyRecorder latency{1U};
+   // Hashes and shares made worthless by newer work, per generation.
+   cpu_miner::WastedWorkRecorder waste;
+   // Copies of the published work's difficulty and notify time, readable
+   // without the mutex (metrics exporter).
+   std::atomic<double> share_difficulty{0.0};
+   std::atomic<std::int64_t> job_received_ns{0};
+};
+
+// Latest job from one pool connection, kept whether or not it is hashed.
+struct PoolWork {
+   cpu_miner::MiningJob job;
+   cpu_miner::DecodedJob decoded;
+   cpu_miner::SubscriptionContext subscription;
+   double share_difficulty{};
+   std::chrono::steady_clock::time_point notify_received{};
+};
+
+// Pool control threads report work and liveness here; the selector decides
+// which pool's work is published to the worker.
+struct PoolRouter {
+   explicit PoolRouter(cpu_miner::PoolSelector pool_selector)
+      : selector(std::move(pool_selector))
+      , latest(selector.size())
+      , valid_jobs(selector.size())
+      , epochs(selector.size(), 0U) {}
+
+   std::mutex mutex;
+   cpu_miner::PoolSelector selector;
+   std::vector<std::optional<PoolWork>> latest;
+   // Jobs each pool still takes shares for.
+   std::vector<cpu_miner::JobTable> valid_jobs;
+   // Bumped on every publish of a pool's work so a republished job resumes
+   // in unused extranonce2 space.
+   std::vector<std::uint64_t> epochs;
 };
 
 struct QueuedShare {
    cpu_miner::ShareSubmission submission;
    cpu_miner::ShareCandidate candidate;
+   std::chrono::steady_clock::time_point submitted_at{};
 };
 
 class ShareQueue {
@@ -138,25 +212,17 @@ class ShareQueue {
       return true;
    }
 
-   [[nodiscard]] bool wait_pop_for(QueuedShare& out, std::stop_token stop_token,
-                                   std::chrono::milliseconds timeout) {
+   // Waits until a share is queued, without taking it, so the caller pops
+   // shares in the order they were found. Returns false on timeout or stop.
+   [[nodiscard]] bool wait_for(std::stop_token stop_token,
+                               std::chrono::milliseconds timeout) {
       std::unique_lock<std::mutex> lock(mutex_);
 
       const auto pred = [this, &stop_token]() {
          return !queue_.empty() || stop_token.stop_requested();
       };
 
-      if (!cv_.wait_for(lock, timeout, pred)) {
-         return false;
-      }
-
-      if (stop_token.stop_requested() || queue_.empty()) {
-         return false;
-      }
-
-      out = std::move(queue_.front());
-      queue_.pop();
-      return true;
+      return cv_.wait_for(lock, timeout, pred) && !stop_token.stop_requested();
    }
 
  private:
@@ -165,13 +231,50 @@ class ShareQueue {
    std::queue<QueuedShare> queue_;
 };
 
-struct Counters {
+// One share queue per pool, indexed like PoolRouter::latest.
+using ShareQueues = std::deque<ShareQueue>;
+
+// The miner runs one worker thread; Counters and select_backend size for it.
+constexpr std::size_t kWorkerThreads = 1U;
+
+// Written only by its own worker thread, with single_writer_add or relaxed
+// stores; readers sum across workers.
+struct alignas(cpu_miner::util::kCacheLineBytes) WorkerCounters {
    std::atomic<std::uint64_t> hashes_done{0};
    std::atomic<std::uint64_t> shares_found{0};
    std::atomic<std::uint64_t> blocks_found{0};
+   std::atomic<std::uint64_t> current_scan_hashes_done{0};
+   // Pool whose work the current scan hashes.
+   std::atomic<std::size_t> current_scan_pool{0};
+   // Rate of the worker's last scan chunk.
+   std::atomic<double> hash_rate_hps{0.0};
+};
+
+// Completed-scan hashes on one pool's work. Written only by the (single)
+// worker thread, with single_writer_add; readers sum like WorkerCounters.
+struct alignas(cpu_miner::util::kCacheLineBytes) PoolCounters {
+   std::atomic<std::uint64_t> hashes_done{0};
+};
+
+struct Counters {
+   explicit Counters(std::size_t pool_count) : pools(pool_count) {}
+
+   // One block per worker thread.
+   cpu_miner::util::ShardedCounters<WorkerCounters> workers{kWorkerThreads};
+   // One block per pool connection, indexed like PoolRouter::latest.
+   cpu_miner::util::ShardedCounters<PoolCounters> pools;
+   // Pool-side counters, written by the control threads.
    std::atomic<std::uint64_t> shares_accepted{0};
    std::atomic<std::uint64_t> shares_rejected{0};
-   std::atomic<std::uint64_t> current_scan_hashes_done{0};
+   std::atomic<std::uint64_t> reconnects{0};
+   std::atomic<std::uint64_t> downtime_ms{0};
+   std::atomic<std::uint64_t> lost_hashes{0};
+   std::atomic<std::uint64_t> stale_discards{0};
+   std::atomic<std::uint64_t> duplicate_shares{0};
+   // Request plus response bytes of answered submits.
+   std::atomic<std::uint64_t> submit_wire_bytes{0};
+   std::atomic<std::uint64_t> difficulty_suggestions{0};
+   cpu_miner::util::LatencyHistogram submit_latency;
 };
 
 struct TotalsSnapshot {
@@ -181,19 +284,28 @@ struct TotalsSnapshot {
    std::uint64_t shares_accepted{};
    std::uint64_t shares_rejected{};
    std::uint64_t current_scan_hashes_done{};
+   std::uint64_t reconnects{};
+   std::uint64_t downtime_ms{};
+   std::uint64_t lost_hashes{};
+   std::uint64_t duplicate_shares{};
 };
 
 TotalsSnapshot snapshot_counters(const Counters& counters) {
    return TotalsSnapshot{
-      .hashes_done = counters.hashes_done.load(std::memory_order_relaxed),
-      .shares_found = counters.shares_found.load(std::memory_order_relaxed),
-      .blocks_found = counters.blocks_found.load(std::memory_order_relaxed),
+      .hashes_done = counters.workers.sum(&WorkerCounters::hashes_done),
+      .shares_found = counters.workers.sum(&WorkerCounters::shares_found),
+      .blocks_found = counters.workers.sum(&WorkerCounters::blocks_found),
       .shares_accepted =
          counters.shares_accepted.load(std::memory_order_relaxed),
       .shares_rejected =
          counters.shares_rejected.load(std::memory_order_relaxed),
       .current_scan_hashes_done =
-         counters.current_scan_hashes_done.load(std::memory_order_relaxed),
+         counters.workers.sum(&WorkerCounters::current_scan_hashes_done),
+      .reconnects = counters.reconnects.load(std::memory_order_relaxed),
+      .downtime_ms = counters.downtime_ms.load(std::memory_order_relaxed),
+      .lost_hashes = counters.lost_hashes.load(std::memory_order_relaxed),
+      .duplicate_shares =
+         counters.duplicate_shares.load(std::memory_order_relaxed),
    };
 }
 
@@ -204,6 +316,71 @@ void print_running_totals(const TotalsSnapshot& totals) {
    std::cout << "  blocks found: " << totals.blocks_found << '\n';
    std::cout << "  shares accepted: " << totals.shares_accepted << '\n';
    std::cout << "  shares rejected: " << totals.shares_rejected << '\n';
+   if (totals.reconnects != 0U) {
+      std::cout << "  reconnects: " << totals.reconnects << '\n';
+      std::cout << "  downtime ms: " << totals.downtime_ms << '\n';
+      std::cout << "  lost hashes: " << totals.lost_hashes << '\n';
+   }
+   if (totals.duplicate_shares != 0U) {
+      std::cout << "  duplicate shares dropped: " << totals.duplicate_shares
+                << '\n';
+   }
+}
+
+void print_latency_summary(const char* label,
+                           const cpu_miner::LatencySummary& summary) {
+   std::cout << "  " << label << ": ";
+   if (summary.count == 0U) {
+      std::cout << "no samples\n";
+      return;
+   }
+
+   std::cout << std::fixed << std::setprecision(1) << "n=" << summary.count
+             << " min=" << summary.min_us << " p50=" << summary.p50_us
+             << " p90=" << summary.p90_us << " p99=" << summary.p99_us
+             << " max=" << summary.max_us << '\n';
+}
+
+void print_switch_latency(const cpu_miner::SwitchLatencyReport& report) {
+   std::cout << "job switch latency (us):\n";
+   print_latency_summary("notify->publish", report.notify_to_publish);
+   print_latency_summary("publish->adopt", report.publish_to_adopt);
+   print_latency_summary("adopt->first hash", report.adopt_to_first_hash);
+   print_latency_summary("notify->all hashing", report.notify_to_all_hashing);
+   std::cout << "  superseded generations: " << report.superseded << '\n';
+}
+
+void print_wasted_work(const cpu_miner::WastedWorkReport& report) {
+   std::cout << "wasted work:\n";
+   std::cout << "  hashes: " << report.hashes << '\n';
+   std::cout << "  stale hashes: " << report.stale_hashes << " ("
+             << std::fixed << std::setprecision(3)
+             << report.wasted_fraction() * 100.0 << "%)\n";
+   std::cout << "  after clean_jobs: " << report.clean_jobs_hashes << '\n';
+   std::cout << "  discarded shares: " << report.discarded_shares << '\n';
+}
+
+// Submits and wire bytes saved by suggesting difficulty above 1, estimated
+// from the hashes done; each avoided submit is also one queue_share and one
+// response parse the control thread did not do.
+void print_vardiff_savings(const Counters& counters,
+                           std::uint64_t hashes_done) {
+   const std::uint64_t submits =
+      counters.shares_accepted.load(std::memory_order_relaxed) +
+      counters.shares_rejected.load(std::memory_order_relaxed);
+   const auto savings = cpu_miner::estimate_vardiff_savings(
+      hashes_done, 1.0, submits,
+      counters.submit_wire_bytes.load(std::memory_order_relaxed));
+
+   std::cout << "difficulty suggestions: "
+             << counters.difficulty_suggestions.load(std::memory_order_relaxed)
+             << '\n';
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << "  submits at difficulty 1 (expected): "
+             << savings.baseline_submits << '\n';
+   std::cout << "  submits: " << savings.submits << '\n';
+   std::cout << "  submits avoided: " << savings.avoided_submits << '\n';
+   std::cout << "  wire bytes avoided: " << savings.avoided_bytes << '\n';
 }
 
 void clear_status_line(bool& status_line_active) {
@@ -231,6 +408,85 @@ void print_status_line(const TotalsSnapshot& totals, bool& status_line_active) {
    status_line_active = true;
 }
 
+// Runs on the metrics server thread; reads atomics only, so a scrape never
+// contends with the worker or the pool control threads.
+std::string render_metrics(const Counters& counters,
+                           const SharedWorkState& shared_work,
+                           const std::atomic<std::uint64_t>& work_generation) {
+   const TotalsSnapshot totals = snapshot_counters(counters);
+   cpu_miner::util::OpenMetricsWriter out;
+
+   out.family("cpu_miner_hashes", "counter", "Hashes computed per worker.");
+   for (std::size_t i = 0; i < counters.workers.size(); ++i) {
+      const WorkerCounters& worker = counters.workers[i];
+      out.sample("cpu_miner_hashes_total", {{"worker", std::to_string(i)}},
+                 worker.hashes_done.load(std::memory_order_relaxed) +
+                    worker.current_scan_hashes_done.load(
+                       std::memory_order_relaxed));
+   }
+
+   out.family("cpu_miner_worker_hashrate", "gauge",
+              "Hashes per second over the worker's last scan chunk.");
+   for (std::size_t i = 0; i < counters.workers.size(); ++i) {
+      out.sample(
+         "cpu_miner_worker_hashrate", {{"worker", std::to_string(i)}},
+         counters.workers[i].hash_rate_hps.load(std::memory_order_relaxed));
+   }
+
+   out.counter("cpu_miner_shares_found", "Shares meeting the share target.",
+               totals.shares_found);
+   out.counter("cpu_miner_shares_accepted", "Shares accepted by the pool.",
+               totals.shares_accepted);
+   out.counter("cpu_miner_shares_rejected", "Shares rejected by the pool.",
+               totals.shares_rejected);
+   out.counter("cpu_miner_stale_shares_discarded",
+               "Shares dropped before submit because their job was replaced.",
+               counters.stale_discards.load(std::memory_order_relaxed));
+   out.counter("cpu_miner_duplicate_shares",
+               "Shares dropped before submit as duplicates of one already "
+               "submitted on the same job.",
+               counters.duplicate_shares.load(std::memory_order_relaxed));
+   const cpu_miner::WastedWorkReport waste = shared_work.waste.report();
+   out.counter("cpu_miner_stale_hashes",
+               "Hashes done after the notify replacing their job arrived.",
+               waste.stale_hashes);
+   out.counter("cpu_miner_clean_jobs_stale_hashes",
+               "Stale hashes on jobs replaced by a clean_jobs notify.",
+               waste.clean_jobs_hashes);
+   out.gauge("cpu_miner_wasted_work_ratio",
+             "Stale hashes as a fraction of all hashes.",
+             waste.wasted_fraction());
+   out.counter("cpu_miner_blocks_found", "Hashes meeting the network target.",
+               totals.blocks_found);
+   out.counter("cpu_miner_reconnects", "Pool reconnections.",
+               totals.reconnects);
+
+   out.gauge("cpu_miner_work_generation", "Generation of the published work.",
+             static_cast<double>(
+                work_generation.load(std::memory_order_relaxed)));
+   out.gauge("cpu_miner_share_difficulty",
+             "Share difficulty of the published work.",
+             shared_work.share_difficulty.load(std::memory_order_relaxed));
+
+   const std::int64_t received_ns =
+      shared_work.job_received_ns.load(std::memory_order_relaxed);
+   const std::int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch())
+         .count();
+   out.gauge("cpu_miner_job_age_seconds",
+             "Time since the published job's notify arrived.",
+             received_ns == 0 ? 0.0
+                              : static_cast<double>(now_ns - received_ns) / 1e9,
+             "seconds");
+
+   out.histogram("cpu_miner_submit_latency_seconds",
+                 "Share submit to pool response.", "seconds",
+                 counters.submit_latency.snapshot());
+
+   return out.finish();
+}
+
 struct StartupEvent {
    cpu_miner::WorkState work;
    double difficulty{};
@@ -240,6 +496,8 @@ struct StartupEvent {
 };
 
 struct WorkUpdateEvent {
+   std::size_t pool{};
+   bool active{};
    std::string job_id;
    std::string ntime_hex;
    bool clean_jobs{};
@@ -249,28 +507,6 @@ struct WorkUpdateEvent {
    std::string parsed_summary;
 };
 
-struct ChunkStartedEvent {
-   std::string job_id;
-   std::string extranonce2_hex;
-   std::uint64_t generation{};
-   std::uint64_t nonce_begin{};
-   std::uint64_t nonce_end{};
-};
-
-struct ShareFoundEvent {
-   std::string job_id;
-   std::string extranonce2_hex;
-   std::uint64_t generation{};
-   std::uint32_t nonce{};
-   cpu_miner::sha256::DigestBytes hash{};
-   cpu_miner::u256::uint256 share_target{};
-   cpu_miner::u256::uint256 network_target{};
-   bool block_candidate{};
-   std::string coinbase_hex;
-   std::string coinbase_hash_hex;
-   std::string merkle_root_raw_hex;
-};
-
 struct ShareSubmitEvent {
    std::string job_id;
    std::string extranonce2_hex;
@@ -284,18 +520,24 @@ struct ShareSubmitEvent {
    std::string raw_response;
 };
 
-struct StaleShareDiscardedEvent {
-   std::string job_id;
-   std::uint32_t nonce{};
-   std::uint64_t candidate_generation{};
-   std::uint64_t current_generation{};
+struct ConnectionLostEvent {
+   std::size_t pool{};
+   std::string message;
 };
 
-struct ScanFinishedEvent {
-   std::string job_id;
-   std::string extranonce2_hex;
-   std::uint64_t generation{};
-   cpu_miner::ScanResult result;
+struct ReconnectedEvent {
+   std::size_t pool{};
+   std::uint32_t attempts{};
+   double downtime_seconds{};
+   bool resumed{};
+   std::uint64_t lost_hashes{};
+   std::size_t dropped_submits{};
+   std::string session_id;
+};
+
+struct PoolSwitchEvent {
+   std::optional<std::size_t> from;
+   std::optional<std::size_t> to;
 };
 
 struct ShutdownEvent {
@@ -311,10 +553,10 @@ struct ThreadExitedEvent {
    std::string thread_name;
 };
 
-using AppEvent = std::variant<StartupEvent, WorkUpdateEvent, ChunkStartedEvent,
-                              ShareFoundEvent, ShareSubmitEvent,
-                              StaleShareDiscardedEvent, ScanFinishedEvent,
-                              ShutdownEvent, ErrorEvent, ThreadExitedEvent>;
+using AppEvent = std::variant<StartupEvent, WorkUpdateEvent, ShareSubmitEvent,
+                              ConnectionLostEvent, ReconnectedEvent,
+                              PoolSwitchEvent, ShutdownEvent, ErrorEvent,
+                              ThreadExitedEvent>;
 
 class EventQueue {
  public:
@@ -353,59 +595,157 @@ class EventQueue {
    std::queue<AppEvent> queue_;
 };
 
+// Shares written to the pool whose responses have not arrived, by request id.
+using InFlightShares = std::unordered_map<int, QueuedShare>;
+
+constexpr cpu_miner::WriteBatchConfig kShareWriteBatching{
+   .max_linger = std::chrono::microseconds(1000),
+   .max_messages = 16U,
+};
+
+enum class ShareAdmission {
+   submit,
+   stale,
+   duplicate,
+};
+
+// A share stays submittable while its job is in the pool's JobTable on the
+// same extranonce1 and it meets the pool's current difficulty, even if the
+// worker has since moved to other work. A share already submitted on that
+// job is a duplicate.
+ShareAdmission admit_share(PoolRouter& router, std::size_t pool,
+                           const QueuedShare& queued) {
+   const auto& candidate = queued.candidate;
+
+   std::lock_guard<std::mutex> lock(router.mutex);
+
+   const auto& latest = router.latest[pool];
+   const bool valid =
+      latest &&
+      latest->subscription.extranonce1 ==
+         candidate.work.subscription.extranonce1 &&
+      cpu_miner::hash_meets_target(
+         candidate.hash,
+         cpu_miner::share_target_from_difficulty(latest->share_difficulty));
+   if (!valid) return ShareAdmission::stale;
+
+   using ShareRecord = cpu_miner::JobTable::ShareRecord;
+   switch (router.valid_jobs[pool].note_share(
+      candidate.work.job.job_id,
+      cpu_miner::share_fingerprint(queued.submission))) {
+   case ShareRecord::recorded:
+      return ShareAdmission::submit;
+   case ShareRecord::duplicate:
+      return ShareAdmission::duplicate;
+   case ShareRecord::unknown_job:
+      break;
+   }
+   return ShareAdmission::stale;
+}
+
 bool drain_share_queue(cpu_miner::StratumClient& client,
-                       ShareQueue& share_queue, EventQueue& events,
-                       Counters& counters,
-                       const std::atomic<std::uint64_t>& work_generation) {
+                       ShareQueue& share_queue, InFlightShares& in_flight,
+                       Counters& counters, PoolRouter& router,
+                       std::size_t pool, cpu_miner::WastedWorkRecorder& waste) {
    bool did_work = false;
 
    QueuedShare queued;
    while (share_queue.try_pop(queued)) {
       did_work = true;
 
-      const std::uint64_t current_generation =
-         work_generation.load(std::memory_order_acquire);
-
       const auto& candidate = queued.candidate;
 
-      if (candidate.generation != current_generation) {
-         events.push(StaleShareDiscardedEvent{
-            .job_id = candidate.work.job.job_id,
-            .nonce = candidate.nonce,
-            .candidate_generation = candidate.generation,
-            .current_generation = current_generation,
-         });
+      const ShareAdmission admission = admit_share(router, pool, queued);
+      if (admission == ShareAdmission::duplicate) {
+         counters.duplicate_shares.fetch_add(1U, std::memory_order_relaxed);
+         CPU_MINER_LOG_INFO("duplicate share dropped: job_id={} nonce={} "
+                            "generation={}",
+                            candidate.work.job.job_id, candidate.nonce,
+                            candidate.generation);
+         continue;
+      }
+      if (admission == ShareAdmission::stale) {
+         counters.stale_discards.fetch_add(1U, std::memory_order_relaxed);
+         waste.note_discarded_share(candidate.generation);
+         CPU_MINER_LOG_INFO("stale share discarded: job_id={} nonce={} "
+                            "generation={}",
+                            candidate.work.job.job_id, candidate.nonce,
+                            candidate.generation);
          continue;
       }
 
-      const auto& submission = queued.submission;
-      const auto submit_result = client.submit_share(submission);
+      queued.submitted_at = std::chrono::steady_clock::now();
+      const int submit_id = client.queue_share(queued.submission);
+      in_flight.insert_or_assign(submit_id, std::move(queued));
+   }
 
+   if (client.flush_writes()) {
+      did_work = true;
+   }
+
+   return did_work;
+}
+
+bool collect_submit_results(cpu_miner::StratumClient& client,
+                            InFlightShares& in_flight, EventQueue& events,
+                            Counters& counters) {
+   bool did_work = false;
+
+   cpu_miner::SubmitShareResult submit_result;
+   while (client.take_submit_result(submit_result)) {
+      did_work = true;
+
+      const auto it = in_flight.find(submit_result.id);
+      if (it == in_flight.end()) continue;
+
+      const auto& submission = it->second.submission;
+      const auto& candidate = it->second.candidate;
+
+      counters.submit_latency.observe(std::chrono::steady_clock::now() -
+                                      it->second.submitted_at);
+      counters.submit_wire_bytes.fetch_add(
+         submit_result.request_bytes + submit_result.raw_response.size(),
+         std::memory_order_relaxed);
+
+      // Accepted shares are the bulk at high share rates, so they go to the
+      // async logger instead of the event queue; rejections keep the full
+      // event with raw wire text for diagnosis.
       if (submit_result.accepted) {
          counters.shares_accepted.fetch_add(1U, std::memory_order_relaxed);
-      } else {
-         counters.shares_rejected.fetch_add(1U, std::memory_order_relaxed);
+         CPU_MINER_LOG_INFO("share accepted: generation={} job_id={} "
+                            "extranonce2={} ntime={} nonce={}",
+                            candidate.generation, candidate.work.job.job_id,
+                            candidate.work.coinbase.extranonce2_hex,
+                            candidate.work.job.ntime, candidate.nonce);
+         CPU_MINER_LOG_DEBUG("share accepted: raw response {}",
+                             submit_result.raw_response);
+         in_flight.erase(it);
+         continue;
       }
 
+      counters.shares_rejected.fetch_add(1U, std::memory_order_relaxed);
       events.push(ShareSubmitEvent{
          .job_id = candidate.work.job.job_id,
          .extranonce2_hex = candidate.work.coinbase.extranonce2_hex,
          .ntime_hex = candidate.work.job.ntime,
-         .nonce_hex = submission.nonce_hex,
+         .nonce_hex = cpu_miner::hex_from_u32_be(candidate.nonce),
          .generation = candidate.generation,
          .nonce = candidate.nonce,
          .accepted = submit_result.accepted,
-         .error_text = submit_result.error_text,
-         .raw_request = submit_result.raw_request,
-         .raw_response = submit_result.raw_response,
+         .error_text = std::move(submit_result.error_text),
+         .raw_request =
+            client.submit_request_text(submission, submit_result.id),
+         .raw_response = std::move(submit_result.raw_response),
       });
+
+      in_flight.erase(it);
    }
 
    return did_work;
 }
 
 std::optional<PublishedWork>
-wait_for_published_work(SharedWorkState& shared_work,
+wait_for_published_work(SharedWorkState& shared_work, std::size_t worker,
                         std::stop_token stop_token) {
    for (;;) {
       if (stop_token.stop_requested()) {
@@ -414,7 +754,15 @@ wait_for_published_work(SharedWorkState& shared_work,
 
       std::unique_lock<std::mutex> lock(shared_work.mutex);
       if (shared_work.published.has_value()) {
-         return *shared_work.published;
+         shared_work.worker_abort.clear_stale();
+         PublishedWork published = *shared_work.published;
+         shared_work.adopted = published;
+         shared_work.share_target.store(published.share_target);
+         lock.unlock();
+
+         shared_work.latency.note_adopted(published.generation, worker,
+                                          std::chrono::steady_clock::now());
+         return published;
       }
 
       shared_work.cv.wait_for(lock, std::chrono::milliseconds(50));
@@ -423,71 +771,248 @@ wait_for_published_work(SharedWorkState& shared_work,
 
 void handle_found_share(const cpu_miner::ShareSubmission& submission,
                         const cpu_miner::ShareCandidate& candidate,
-                        const PublishedWork& published, ShareQueue& share_queue,
-                        EventQueue& events, Counters& counters) {
-   counters.shares_found.fetch_add(1U, std::memory_order_relaxed);
+                        const PublishedWork& published,
+                        const cpu_miner::ShareTargetSlot& share_target,
+                        ShareQueues& share_queues,
+                        cpu_miner::util::MappedJournal& journal,
+                        std::uint64_t work_id,
+                        WorkerCounters& worker_counters) {
+   const cpu_miner::util::CycleScope cycles(
+      cpu_miner::util::CycleStage::queue_share);
+
+   cpu_miner::util::single_writer_add(worker_counters.shares_found, 1U);
    if (candidate.is_block_candidate) {
-      counters.blocks_found.fetch_add(1U, std::memory_order_relaxed);
+      cpu_miner::util::single_writer_add(worker_counters.blocks_found, 1U);
    }
 
-   share_queue.push(QueuedShare{
+   share_queues[published.pool].push(QueuedShare{
       .submission = submission,
       .candidate = candidate,
    });
 
-   events.push(ShareFoundEvent{
-      .job_id = candidate.work.job.job_id,
-      .extranonce2_hex = candidate.work.coinbase.extranonce2_hex,
-      .generation = candidate.generation,
-      .nonce = candidate.nonce,
-      .hash = candidate.hash,
-      .share_target = published.share_target,
-      .network_target = published.network_target,
-      .block_candidate = candidate.is_block_candidate,
-      .coinbase_hex = candidate.work.coinbase.coinbase_hex,
-      .coinbase_hash_hex = cpu_miner::bytes_to_hex_fixed_msb(
-         candidate.work.coinbase.coinbase_hash),
-      .merkle_root_raw_hex = candidate.work.merkle_root_raw_hex,
-   });
+   cpu_miner::journal_share_found(journal, work_id, candidate,
+                                  share_target.load());
 }
 
-void publish_latest_work(SharedWorkState& shared_work,
-                         std::atomic<std::uint64_t>& work_generation,
-                         const cpu_miner::StratumClient& client,
-                         EventQueue& events) {
-   if (!(client.subscription() && client.current_job())) {
-      return;
-   }
+// Returns true if the newest published work is not `generation`.
+bool newer_work_published(SharedWorkState& shared_work,
+                          std::uint64_t generation) {
+   std::lock_guard<std::mutex> lock(shared_work.mutex);
+   return shared_work.published &&
+          shared_work.published->generation != generation;
+}
 
-   const auto& sub = *client.subscription();
-   const auto& job = *client.current_job();
+// Caller holds router.mutex and shared_work.mutex. A clean_jobs=false notify
+// leaves the worker's job valid, so the worker may finish its range before
+// adopting the new work, provided that job is still in the pool's table on
+// the same extranonce1 and the share difficulty is unchanged.
+bool worker_keeps_range_locked(const PoolRouter& router, std::size_t pool,
+                               const SharedWorkState& shared_work,
+                               const PoolWork& source) {
+   const auto& adopted = shared_work.adopted;
+   return !source.job.clean_jobs && adopted && adopted->pool == pool &&
+          adopted->share_difficulty == source.share_difficulty &&
+          adopted->work.subscription.extranonce1 ==
+             source.subscription.extranonce1 &&
+          router.valid_jobs[pool].contains(adopted->work.job.job_id);
+}
 
-   PublishedWork next;
-   next.work = cpu_miner::make_work_state(job, sub, 0U);
+// Caller holds router.mutex. Returns the published generation. With
+// from_notify the switch latency is measured from the pool's notify;
+// otherwise (failover, split rotation) from now. Work from a notify that
+// leaves the worker's job valid is published without interrupting the
+// worker's scan, and neither latency nor wasted work counts it as a switch.
+std::uint64_t
+publish_pool_work_locked(PoolRouter& router, std::size_t pool,
+                         SharedWorkState& shared_work,
+                         std::atomic<std::uint64_t>& work_generation,
+                         bool from_notify) {
+   const PoolWork& source = *router.latest[pool];
+   const std::uint64_t epoch = router.epochs[pool]++;
 
-   const std::uint32_t nbits = cpu_miner::u32_from_hex_be(job.nbits);
-   next.network_target = cpu_miner::expand_compact_target(nbits);
+   PublishedWork next;
+   next.work = cpu_miner::make_work_state(
+      source.job, source.decoded, source.subscription,
+      cpu_miner::extranonce2_epoch_start(
+         epoch, source.subscription.extranonce2_size));
+   next.network_target = source.decoded.network_target;
 
-   next.share_difficulty = client.difficulty();
+   next.share_difficulty = source.share_difficulty;
    next.share_target =
       cpu_miner::share_target_from_difficulty(next.share_difficulty);
 
+   next.pool = pool;
    next.generation =
       work_generation.fetch_add(1U, std::memory_order_acq_rel) + 1U;
 
+   const std::uint64_t generation = next.generation;
+
+   const auto published_at = std::chrono::steady_clock::now();
+   const auto job_received = source.notify_received.time_since_epoch().count()
+                                ? source.notify_received
+                                : published_at;
+
    {
       std::lock_guard<std::mutex> lock(shared_work.mutex);
-      shared_work.published = next;
+
+      const bool keep_range =
+         from_notify &&
+         worker_keeps_range_locked(router, pool, shared_work, source);
+      if (!keep_range) {
+         shared_work.latency.note_published(
+            generation, from_notify ? source.notify_received : published_at,
+            published_at);
+      }
+      shared_work.waste.note_published(
+         generation,
+         keep_range ? std::nullopt
+                    : std::optional(from_notify ? job_received : published_at),
+         from_notify && source.job.clean_jobs);
+
+      shared_work.published = std::move(next);
+      if (!keep_range) {
+         shared_work.worker_abort.request_stale();
+      }
    }
 
+   shared_work.share_difficulty.store(source.share_difficulty,
+                                      std::memory_order_relaxed);
+   shared_work.job_received_ns.store(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+         job_received.time_since_epoch())
+         .count(),
+      std::memory_order_relaxed);
+
    shared_work.cv.notify_all();
+   return generation;
+}
+
+struct RouteResult {
+   std::uint64_t generation{};
+   bool switched{};
+   std::optional<std::size_t> from;
+   std::optional<std::size_t> to;
+};
+
+enum class PoolReport {
+   none,
+   notify,
+   down,
+};
+
+// Records `report` for `pool`, re-evaluates the selection and publishes the
+// active pool's work if the selection changed or `pool` itself is active and
+// sent new work.
+RouteResult route_pool_work(PoolRouter& router, std::optional<std::size_t> pool,
+                            PoolReport report, SharedWorkState& shared_work,
+                            std::atomic<std::uint64_t>& work_generation,
+                            EventQueue& events) {
+   const auto now = cpu_miner::PoolSelector::clock::now();
+
+   RouteResult result{};
+   {
+      std::lock_guard<std::mutex> lock(router.mutex);
+
+      if (pool && report == PoolReport::notify) {
+         router.selector.note_notify(*pool, now);
+      } else if (pool && report == PoolReport::down) {
+         router.selector.mark_down(*pool);
+      }
+
+      result.from = router.selector.active();
+      result.switched = router.selector.update(now);
+      result.to = router.selector.active();
+
+      const bool refresh =
+         report == PoolReport::notify && pool && result.to == pool;
+      if (result.to && router.latest[*result.to] &&
+          (result.switched || refresh)) {
+         result.generation = publish_pool_work_locked(
+            router, *result.to, shared_work, work_generation, refresh);
+      }
+   }
+
+   if (result.switched) {
+      events.push(PoolSwitchEvent{.from = result.from, .to = result.to});
+   }
+
+   return result;
+}
+
+// Applies a set_difficulty from `pool` without publishing a new generation:
+// the pool's latest work and any published or adopted work from it take the
+// new difficulty, and the worker's scan picks up the new share target at its
+// next check block, keeping its header, midstate and nonce position.
+void retarget_pool_work(PoolRouter& router, std::size_t pool,
+                        double difficulty, SharedWorkState& shared_work) {
+   const auto target = cpu_miner::share_target_from_difficulty(difficulty);
+
+   std::lock_guard<std::mutex> router_lock(router.mutex);
+   if (router.latest[pool]) {
+      router.latest[pool]->share_difficulty = difficulty;
+   }
+
+   std::lock_guard<std::mutex> lock(shared_work.mutex);
+   const auto retarget = [&](std::optional<PublishedWork>& work) {
+      if (!work || work->pool != pool) return false;
+      work->share_difficulty = difficulty;
+      work->share_target = target;
+      return true;
+   };
+
+   if (retarget(shared_work.published)) {
+      shared_work.share_difficulty.store(difficulty,
+                                         std::memory_order_relaxed);
+   }
+   if (retarget(shared_work.adopted)) {
+      shared_work.share_target.store(target);
+   }
+}
+
+// Stores the client's current job as the pool's latest work, notes it in
+// the pool's job table and routes it.
+void offer_pool_work(PoolRouter& router, std::size_t pool,
+                     const cpu_miner::StratumClient& client,
+                     SharedWorkState& shared_work,
+                     std::atomic<std::uint64_t>& work_generation,
+                     EventQueue& events) {
+   if (!(client.subscription() && client.current_job() &&
+         client.current_decoded_job())) {
+      return;
+   }
+
+   const auto& job = *client.current_job();
+
+   {
+      std::lock_guard<std::mutex> lock(router.mutex);
+      auto& jobs = router.valid_jobs[pool];
+      if (router.latest[pool] &&
+          router.latest[pool]->subscription.extranonce1 !=
+             client.subscription()->extranonce1) {
+         jobs.clear();
+      }
+      jobs.note_job(job.job_id, job.clean_jobs);
+
+      router.latest[pool] = PoolWork{
+         .job = job,
+         .decoded = *client.current_decoded_job(),
+         .subscription = *client.subscription(),
+         .share_difficulty = client.difficulty(),
+         .notify_received = client.last_notify_received(),
+      };
+   }
+
+   const auto routed = route_pool_work(router, pool, PoolReport::notify,
+                                       shared_work, work_generation, events);
 
    events.push(WorkUpdateEvent{
+      .pool = pool,
+      .active = routed.generation != 0U,
       .job_id = job.job_id,
       .ntime_hex = job.ntime,
       .clean_jobs = job.clean_jobs,
       .difficulty = client.difficulty(),
-      .generation = next.generation,
+      .generation = routed.generation,
       .raw_notify = client.last_raw_notify(),
       .parsed_summary = client.last_parsed_summary(),
    });
@@ -497,12 +1022,12 @@ void maybe_publish_startup_event(std::atomic<bool>& startup_announced,
                                  SharedWorkState& shared_work,
                                  const cpu_miner::StratumClient& client,
                                  EventQueue& events) {
-   if (startup_announced.exchange(true, std::memory_order_acq_rel)) {
+   std::lock_guard<std::mutex> lock(shared_work.mutex);
+   if (!shared_work.published.has_value()) {
       return;
    }
 
-   std::lock_guard<std::mutex> lock(shared_work.mutex);
-   if (!shared_work.published.has_value()) {
+   if (startup_announced.exchange(true, std::memory_order_acq_rel)) {
       return;
    }
 
@@ -517,15 +1042,104 @@ void maybe_publish_startup_event(std::atomic<bool>& startup_announced,
    });
 }
 
-void control_idle_wait(ShareQueue& share_queue, std::stop_token stop_token) {
-   QueuedShare queued;
-   (void)share_queue.wait_pop_for(queued, stop_token,
-                                  std::chrono::milliseconds(20));
-   if (!stop_token.stop_requested()) {
-      if (!queued.candidate.work.empty()) {
-         share_queue.push(std::move(queued));
+// Sleeps until a share is queued, but never past a pending write deadline so
+// a lingering batch still goes out within its configured linger.
+void control_idle_wait(ShareQueue& share_queue,
+                       const cpu_miner::StratumClient& client,
+                       std::stop_token stop_token) {
+   auto timeout = std::chrono::milliseconds(20);
+   if (const auto deadline = client.write_deadline()) {
+      const auto remaining =
+         std::chrono::ceil<std::chrono::milliseconds>(
+            *deadline - cpu_miner::WriteBatch::clock::now());
+      timeout = std::clamp(remaining, std::chrono::milliseconds(0), timeout);
+   }
+
+   (void)share_queue.wait_for(stop_token, timeout);
+}
+
+std::uint64_t live_hashes(const Counters& counters) {
+   return counters.workers.sum(&WorkerCounters::hashes_done) +
+          counters.workers.sum(&WorkerCounters::current_scan_hashes_done);
+}
+
+// Hashes done on `pool`'s work only. In split mode a connection gets a
+// weighted slice of the hashrate and a standby gets none, so each pool's
+// vardiff must see its own share rather than live_hashes().
+std::uint64_t pool_live_hashes(const Counters& counters, std::size_t pool) {
+   std::uint64_t hashes =
+      counters.pools[pool].hashes_done.load(std::memory_order_relaxed);
+   for (std::size_t i = 0; i < counters.workers.size(); ++i) {
+      const WorkerCounters& worker = counters.workers[i];
+      if (worker.current_scan_pool.load(std::memory_order_relaxed) == pool) {
+         hashes +=
+            worker.current_scan_hashes_done.load(std::memory_order_relaxed);
       }
    }
+   return hashes;
+}
+
+// The dropped pool is marked down first, so a healthy standby takes over
+// without waiting for the reconnect. If none does, workers keep hashing the
+// dropped pool's last work: valid if the pool resumes the session, otherwise
+// built on the old extranonce1 and counted as lost. Work is re-offered
+// whenever the handshake brought a new job or difficulty. Returns false if
+// stop was requested first.
+bool recover_connection(cpu_miner::StratumSession& session,
+                        const cpu_miner::StratumClient& client,
+                        InFlightShares& in_flight, PoolRouter& router,
+                        std::size_t pool, SharedWorkState& shared_work,
+                        std::atomic<std::uint64_t>& work_generation,
+                        EventQueue& events, Counters& counters,
+                        std::stop_token stop_token) {
+   const auto routed = route_pool_work(router, pool, PoolReport::down,
+                                       shared_work, work_generation, events);
+   const bool orphaned = routed.from == pool && !routed.to;
+
+   const std::uint64_t hashes_at_drop = live_hashes(counters);
+   const std::uint64_t notifies_at_drop = client.notify_count();
+   const double difficulty_at_drop = client.difficulty();
+   in_flight.clear();
+
+   const auto outcome = session.recover(stop_token);
+   if (!outcome) return false;
+
+   std::uint64_t lost = 0U;
+   if (orphaned && !outcome->resumed) {
+      const std::uint64_t now = live_hashes(counters);
+      lost = now > hashes_at_drop ? now - hashes_at_drop : 0U;
+   }
+
+   if (!outcome->resumed || client.notify_count() != notifies_at_drop ||
+       client.difficulty() != difficulty_at_drop) {
+      offer_pool_work(router, pool, client, shared_work, work_generation,
+                      events);
+   } else {
+      (void)route_pool_work(router, pool, PoolReport::notify, shared_work,
+                            work_generation, events);
+   }
+
+   const auto downtime_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(outcome->downtime);
+
+   counters.reconnects.fetch_add(1U, std::memory_order_relaxed);
+   counters.downtime_ms.fetch_add(
+      static_cast<std::uint64_t>(downtime_ms.count()),
+      std::memory_order_relaxed);
+   counters.lost_hashes.fetch_add(lost, std::memory_order_relaxed);
+
+   events.push(ReconnectedEvent{
+      .pool = pool,
+      .attempts = outcome->attempts,
+      .downtime_seconds =
+         std::chrono::duration<double>(outcome->downtime).count(),
+      .resumed = outcome->resumed,
+      .lost_hashes = lost,
+      .dropped_submits = outcome->dropped_submits,
+      .session_id = client.session_id(),
+   });
+
+   return true;
 }
 
 void record_thread_exception(std::mutex& error_mutex,
@@ -554,34 +1168,8 @@ void record_thread_exception(std::mutex& error_mutex,
    }
 }
 
-void print_scan_finished(const ScanFinishedEvent& event) {
-   std::cout << "scan result:\n";
-   std::cout << "  job_id: " << event.job_id << '\n';
-   std::cout << "  extranonce2: " << event.extranonce2_hex << '\n';
-   std::cout << "  generation: " << event.generation << '\n';
-   std::cout << "  scanned hashes: " << event.result.hashes_done << '\n';
-   std::cout << "  shares found: " << event.result.shares_found << '\n';
-   std::cout << "  blocks found: " << event.result.blocks_found << '\n';
-   std::cout << "  elapsed seconds: " << std::fixed << std::setprecision(3)
-             << event.result.elapsed_seconds << '\n';
-   std::cout << "  average rate: " << std::setprecision(0)
-             << event.result.hash_rate_hps << " H/s\n";
-   std::cout << "  stop reason: ";
-   switch (event.result.stop_reason) {
-   case cpu_miner::ScanStopReason::exhausted:
-      std::cout << "exhausted\n";
-      break;
-   case cpu_miner::ScanStopReason::stale:
-      std::cout << "stale\n";
-      break;
-   case cpu_miner::ScanStopReason::stop_requested:
-      std::cout << "stop_requested\n";
-      break;
-   }
-}
-
 struct EventRenderOutcome {
-   bool control_exited{};
+   std::size_t controls_exited{};
    bool worker_exited{};
 };
 
@@ -602,17 +1190,19 @@ EventRenderOutcome render_event(const AppEvent& event, const Counters& counters,
             std::cout << "  extranonce1: " << e.extranonce1 << '\n';
             std::cout << "  extranonce2_size: " << e.extranonce2_size << '\n';
 
-            const std::uint32_t nbits =
-               cpu_miner::u32_from_hex_be(e.work.job.nbits);
-
             std::cout << "mining setup:\n";
             std::cout << "  nbits: 0x" << std::hex << std::setw(8)
-                      << std::setfill('0') << nbits << std::dec
+                      << std::setfill('0') << e.work.decoded.nbits << std::dec
                       << std::setfill(' ') << '\n';
             std::cout << "  share difficulty: " << e.share_difficulty << '\n';
          } else if constexpr (std::is_same_v<T, WorkUpdateEvent>) {
             std::cout << "work update:\n";
-            std::cout << "  generation: " << e.generation << '\n';
+            std::cout << "  pool: " << e.pool << '\n';
+            if (e.active) {
+               std::cout << "  generation: " << e.generation << '\n';
+            } else {
+               std::cout << "  generation: standby\n";
+            }
             std::cout << "  job_id: " << e.job_id << '\n';
             std::cout << "  ntime: " << e.ntime_hex << '\n';
             std::cout << "  clean_jobs: " << (e.clean_jobs ? "true" : "false")
@@ -625,44 +1215,6 @@ EventRenderOutcome render_event(const AppEvent& event, const Counters& counters,
                std::cout << "  parsed notify summary:\n";
                std::cout << e.parsed_summary;
             }
-         } else if constexpr (std::is_same_v<T, ChunkStartedEvent>) {
-            std::cout << "mining chunk:\n";
-            std::cout << "  generation: " << e.generation << '\n';
-            std::cout << "  job_id: " << e.job_id << '\n';
-            std::cout << "  extranonce2: " << e.extranonce2_hex << '\n';
-            std::cout << "  nonce range: [" << e.nonce_begin << ", "
-                      << e.nonce_end << "]\n";
-         } else if constexpr (std::is_same_v<T, ShareFoundEvent>) {
-            std::cout << "  "
-                      << (e.block_candidate ? "BLOCK CANDIDATE" : "SHARE HIT")
-                      << " generation=" << e.generation << " nonce=" << e.nonce
-                      << '\n';
-
-            std::cout << "    hash (display, BE):  "
-                      << cpu_miner::bytes_to_hex_fixed_msb(e.hash) << '\n';
-            std::cout << "    hash (raw bytes):    "
-                      << cpu_miner::bytes_to_hex(e.hash) << '\n';
-
-            std::cout << "    share target:        "
-                      << e.share_target.to_hex_be_fixed() << '\n';
-            std::cout << "    network target:      "
-                      << e.network_target.to_hex_be_fixed() << '\n';
-
-            const auto meets_share =
-               cpu_miner::hash_meets_target(e.hash, e.share_target);
-            const auto meets_network =
-               cpu_miner::hash_meets_target(e.hash, e.network_target);
-
-            std::cout << "    meets share target:  "
-                      << (meets_share ? "true" : "false") << '\n';
-            std::cout << "    meets network target:"
-                      << (meets_network ? " true" : " false") << '\n';
-
-            std::cout << "    coinbase hex:        " << e.coinbase_hex << '\n';
-            std::cout << "    coinbase hash (BE):  " << e.coinbase_hash_hex
-                      << '\n';
-            std::cout << "    merkle root (BE):    " << e.merkle_root_raw_hex
-                      << '\n';
          } else if constexpr (std::is_same_v<T, ShareSubmitEvent>) {
             std::cout << "  share submission: "
                       << (e.accepted ? "accepted" : "rejected") << '\n';
@@ -682,17 +1234,35 @@ EventRenderOutcome render_event(const AppEvent& event, const Counters& counters,
                std::cout << "    raw response: " << e.raw_response << '\n';
             }
             print_running_totals(snapshot_counters(counters));
-         } else if constexpr (std::is_same_v<T, StaleShareDiscardedEvent>) {
-            std::cout << "stale share candidate discarded:\n";
-            std::cout << "  job_id: " << e.job_id << '\n';
-            std::cout << "  nonce: " << e.nonce << '\n';
-            std::cout << "  candidate_generation: " << e.candidate_generation
+         } else if constexpr (std::is_same_v<T, ConnectionLostEvent>) {
+            std::cout << "connection lost: pool " << e.pool << ": " << e.message
                       << '\n';
-            std::cout << "  current_generation: " << e.current_generation
+         } else if constexpr (std::is_same_v<T, ReconnectedEvent>) {
+            std::cout << "reconnected:\n";
+            std::cout << "  pool: " << e.pool << '\n';
+            std::cout << "  attempts: " << e.attempts << '\n';
+            std::cout << "  downtime seconds: " << std::fixed
+                      << std::setprecision(3) << e.downtime_seconds << '\n';
+            std::cout << "  session: " << (e.resumed ? "resumed" : "new")
                       << '\n';
-         } else if constexpr (std::is_same_v<T, ScanFinishedEvent>) {
-            print_scan_finished(e);
-            print_running_totals(snapshot_counters(counters));
+            if (!e.session_id.empty()) {
+               std::cout << "  session_id: " << e.session_id << '\n';
+            }
+            std::cout << "  lost hashes: " << e.lost_hashes << '\n';
+            std::cout << "  dropped submits: " << e.dropped_submits << '\n';
+         } else if constexpr (std::is_same_v<T, PoolSwitchEvent>) {
+            std::cout << "pool switch: ";
+            if (e.from) {
+               std::cout << *e.from;
+            } else {
+               std::cout << "none";
+            }
+            std::cout << " -> ";
+            if (e.to) {
+               std::cout << *e.to << '\n';
+            } else {
+               std::cout << "none (hashing last work)\n";
+            }
          } else if constexpr (std::is_same_v<T, ShutdownEvent>) {
             std::cout << e.reason << '\n';
          } else if constexpr (std::is_same_v<T, ErrorEvent>) {
@@ -700,7 +1270,7 @@ EventRenderOutcome render_event(const AppEvent& event, const Counters& counters,
          } else if constexpr (std::is_same_v<T, ThreadExitedEvent>) {
             std::cout << "thread exited: " << e.thread_name << '\n';
             if (e.thread_name == "control") {
-               outcome.control_exited = true;
+               ++outcome.controls_exited;
             } else if (e.thread_name == "worker") {
                outcome.worker_exited = true;
             }
@@ -711,6 +1281,47 @@ EventRenderOutcome render_event(const AppEvent& event, const Counters& counters,
    return outcome;
 }
 
+// 64 Ki records (8 MiB): far more than the console falls behind by.
+constexpr std::size_t kJournalCapacity = std::size_t{1} << 16;
+
+// Prints the journal records appended since `next` and advances it.
+void render_journal(const cpu_miner::util::MappedJournal& journal,
+                    cpu_miner::JournalRenderer& renderer, std::uint64_t& next,
+                    const Counters& counters, bool& status_line_active) {
+   using cpu_miner::util::JournalReadStatus;
+
+   cpu_miner::util::JournalRecord record;
+   for (;;) {
+      const auto status = journal.read(next, record);
+      if (status == JournalReadStatus::pending) {
+         return;
+      }
+
+      if (status == JournalReadStatus::overwritten) {
+         const std::uint64_t resume =
+            std::max(journal.oldest_sequence(), next + 1U);
+         clear_status_line(status_line_active);
+         std::cout << "journal: " << (resume - next)
+                   << " records overwritten before display\n";
+         next = resume;
+         continue;
+      }
+
+      ++next;
+      const std::string text = renderer.render(record);
+      if (text.empty()) {
+         continue;
+      }
+
+      clear_status_line(status_line_active);
+      std::cout << text;
+      if (record.type ==
+          cpu_miner::util::journal_type<cpu_miner::JournalScanFinished>()) {
+         print_running_totals(snapshot_counters(counters));
+      }
+   }
+}
+
 struct ScanChunk {
    std::uint64_t nonce_begin{};
    std::uint64_t nonce_end{};
@@ -719,7 +1330,6 @@ struct ScanChunk {
 
 constexpr std::uint64_t kNonceChunkSize =
    static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max()) + 1ULL;
-constexpr std::uint64_t kProgressInterval = 1'000'000ULL;
 constexpr std::uint64_t kMaxNonce =
    static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max());
 
@@ -740,55 +1350,58 @@ cpu_miner::ScanControl
 make_scan_control(std::stop_token stop_token,
                   std::atomic<std::uint64_t>& work_generation,
                   std::uint64_t expected_generation,
+                  const cpu_miner::AbortFlag& abort,
+                  const cpu_miner::ShareTargetSlot& share_target,
                   std::atomic<std::uint64_t>& current_scan_hashes_done) {
    return cpu_miner::ScanControl{
       .stop_token = stop_token,
       .work_generation = &work_generation,
       .expected_generation = expected_generation,
-      .check_interval = 16'384U,
+      .abort = &abort,
       .progress_hashes_done = &current_scan_hashes_done,
+      .share_target = &share_target,
    };
 }
 
 cpu_miner::ScanResult run_scan_chunk(
    cpu_miner::MiningCoordinator& coordinator, const PublishedWork& published,
-   cpu_miner::WorkState& work, std::uint64_t nonce_begin,
-   std::uint64_t nonce_end, std::stop_token stop_token,
-   std::atomic<std::uint64_t>& work_generation, ShareQueue& share_queue,
-   EventQueue& events, Counters& counters) {
-   events.push(ChunkStartedEvent{
-      .job_id = work.job.job_id,
-      .extranonce2_hex = work.coinbase.extranonce2_hex,
-      .generation = published.generation,
-      .nonce_begin = nonce_begin,
-      .nonce_end = nonce_end,
-   });
+   std::uint64_t work_id, std::uint64_t nonce_begin, std::uint64_t nonce_end,
+   std::stop_token stop_token, std::atomic<std::uint64_t>& work_generation,
+   const cpu_miner::AbortFlag& abort,
+   const cpu_miner::ShareTargetSlot& share_target, ShareQueues& share_queues,
+   cpu_miner::util::MappedJournal& journal, WorkerCounters& worker_counters,
+   PoolCounters& pool_counters) {
+   cpu_miner::journal_chunk_started(journal, work_id, nonce_begin, nonce_end);
+   worker_counters.current_scan_pool.store(published.pool,
+                                           std::memory_order_relaxed);
 
    const auto control =
       make_scan_control(stop_token, work_generation, published.generation,
-                        counters.current_scan_hashes_done);
+                        abort, share_target,
+                        worker_counters.current_scan_hashes_done);
 
    coordinator.on_share_found([&](const cpu_miner::ShareSubmission& submission,
                                   const cpu_miner::ShareCandidate& candidate) {
-      handle_found_share(submission, candidate, published, share_queue, events,
-                         counters);
+      handle_found_share(submission, candidate, published, share_target,
+                         share_queues, journal, work_id, worker_counters);
    });
 
    const auto result =
       coordinator.scan_range(nonce_begin, nonce_end, published.network_target,
-                             published.share_target, kProgressInterval,
-                             control);
-
-   counters.hashes_done.fetch_add(result.hashes_done,
-                                  std::memory_order_relaxed);
-   counters.current_scan_hashes_done.store(0U, std::memory_order_relaxed);
-
-   events.push(ScanFinishedEvent{
-      .job_id = work.job.job_id,
-      .extranonce2_hex = work.coinbase.extranonce2_hex,
-      .generation = published.generation,
-      .result = result,
-   });
+                             published.share_target, control);
+
+   cpu_miner::util::single_writer_add(worker_counters.hashes_done,
+                                      result.hashes_done);
+   cpu_miner::util::single_writer_add(pool_counters.hashes_done,
+                                      result.hashes_done);
+   if (result.hashes_done != 0U) {
+      worker_counters.hash_rate_hps.store(result.hash_rate_hps,
+                                          std::memory_order_relaxed);
+   }
+   worker_counters.current_scan_hashes_done.store(0U,
+                                                  std::memory_order_relaxed);
+
+   cpu_miner::journal_scan_finished(journal, work_id, result);
 
    return result;
 }
@@ -803,6 +1416,8 @@ WorkerNextAction handle_scan_result(const cpu_miner::ScanResult& result,
                                     cpu_miner::WorkState& work,
                                     cpu_miner::MiningCoordinator& coordinator,
                                     std::uint64_t nonce_end,
+                                    SharedWorkState& shared_work,
+                                    std::uint64_t generation,
                                     EventQueue& events) {
    if (result.stop_reason == cpu_miner::ScanStopReason::stale) {
       return WorkerNextAction::adopt_new_work;
@@ -813,9 +1428,15 @@ WorkerNextAction handle_scan_result(const cpu_miner::ScanResult& result,
       return WorkerNextAction::exit_thread;
    }
 
+   // Work that left this job valid is taken up here, once the range is done
+   // and before another extranonce2 is prepared for the old job.
+   if (newer_work_published(shared_work, generation)) {
+      return WorkerNextAction::adopt_new_work;
+   }
+
    if (nonce_end == kMaxNonce) {
       cpu_miner::advance_extranonce2(work);
-      coordinator.set_job(work.job, work.subscription,
+      coordinator.set_job(work.job, work.decoded, work.subscription,
                           work.extranonce2_counter);
       return WorkerNextAction::continue_scanning;
    }
@@ -824,68 +1445,439 @@ WorkerNextAction handle_scan_result(const cpu_miner::ScanResult& result,
    return WorkerNextAction::continue_scanning;
 }
 
+struct MinerOptions {
+   std::vector<cpu_miner::PoolEndpoint> pools;
+   std::string user;
+   std::string password;
+   cpu_miner::PoolMode mode{cpu_miner::PoolMode::failover};
+   bool benchmark{};
+   std::chrono::seconds benchmark_duration{5};
+   bool retune{};
+   std::optional<std::uint16_t> metrics_port;
+   std::string metrics_bind{"127.0.0.1"};
+   std::string journal_path;
+   std::string capture_path;
+   std::string replay_path;
+   double replay_speed{1.0};
+   // Target shares per minute per connection; 0 keeps difficulty 1.
+   double share_rate{6.0};
+};
+
+// Usage: cpu_miner [host [port [user [password]]]] [--weight N]
+//                  [--pool host:port[,weight]]... [--split]
+//        [--retune] [--metrics-port N [--metrics-bind ADDR]]
+//        [--journal PATH] [--capture PATH] [--share-rate N]
+//        cpu_miner --replay PATH [--replay-speed X] [user [password]]
+//        cpu_miner --benchmark [--benchmark-seconds N]
+// The positional pool is the primary; each --pool adds a lower-priority pool
+// using the same credentials. --split shares hashrate by weight instead of
+// failing over. --retune ignores the cached startup calibration.
+// --metrics-port serves OpenMetrics on http://ADDR:N/metrics (default ADDR
+// 127.0.0.1).
+// --journal keeps the worker's event journal in PATH, where journal_dump can
+// read it after the miner exits; without it the journal is in memory only.
+// --capture writes every Stratum line with its timing to PATH (PATH.N for
+// pool N > 0). --replay mines against such a capture instead of a pool, at
+// X times the recorded pace (0: no waiting), and stops at its end; the host
+// and port positionals are then ignored.
+// --share-rate suggests difficulties that keep each connection near N shares
+// a minute at the measured hashrate (default 6); 0 keeps difficulty 1.
+// --benchmark measures hashrate offline and exits.
+MinerOptions parse_options(int argc, char* argv[]) {
+   MinerOptions options;
+   std::vector<std::string> positional;
+   std::vector<cpu_miner::PoolEndpoint> extra_pools;
+   std::uint32_t primary_weight = 1U;
+
+   for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+
+      if (arg == "--split") {
+         options.mode = cpu_miner::PoolMode::split;
+      } else if (arg == "--retune") {
+         options.retune = true;
+      } else if (arg == "--journal" || arg == "--capture" ||
+                 arg == "--replay") {
+         if (i + 1 >= argc) {
+            throw std::invalid_argument(arg + " needs a value");
+         }
+         std::string& path = arg == "--journal"   ? options.journal_path
+                             : arg == "--capture" ? options.capture_path
+                                                  : options.replay_path;
+         path = argv[++i];
+      } else if (arg == "--replay-speed" || arg == "--share-rate") {
+         if (i + 1 >= argc) {
+            throw std::invalid_argument(arg + " needs a value");
+         }
+         double& value = arg == "--replay-speed" ? options.replay_speed
+                                                 : options.share_rate;
+         value = std::stod(argv[++i]);
+         if (!(value >= 0.0)) {
+            throw std::invalid_argument(arg + " must be >= 0");
+         }
+      } else if (arg == "--metrics-port" || arg == "--metrics-bind") {
+         if (i + 1 >= argc) {
+            throw std::invalid_argument(arg + " needs a value");
+         }
+         const std::string value = argv[++i];
+         if (arg == "--metrics-bind") {
+            options.metrics_bind = value;
+         } else {
+            const int port = std::stoi(value);
+            if (port < 0 || port > 65535) {
+               throw std::invalid_argument(arg + " out of range");
+            }
+            options.metrics_port = static_cast<std::uint16_t>(port);
+         }
+      } else if (arg == "--benchmark") {
+         options.benchmark = true;
+      } else if (arg == "--benchmark-seconds") {
+         if (i + 1 >= argc) {
+            throw std::invalid_argument(arg + " needs a value");
+         }
+         const int seconds = std::stoi(argv[++i]);
+         if (seconds <= 0) {
+            throw std::invalid_argument(arg + " must be positive");
+         }
+         options.benchmark_duration = std::chrono::seconds(seconds);
+      } else if (arg == "--pool" || arg == "--weight") {
+         if (i + 1 >= argc) {
+            throw std::invalid_argument(arg + " needs a value");
+         }
+         const std::string value = argv[++i];
+         if (arg == "--pool") {
+            extra_pools.push_back(cpu_miner::parse_pool_endpoint(value));
+         } else {
+            primary_weight =
+               cpu_miner::parse_pool_endpoint("primary:0," + value).weight;
+         }
+      } else if (arg.starts_with("--")) {
+         throw std::invalid_argument("unknown option: " + arg);
+      } else {
+         positional.push_back(arg);
+      }
+   }
+
+   const auto positional_or = [&](std::size_t index, const char* fallback) {
+      return index < positional.size() ? positional[index]
+                                       : std::string(fallback);
+   };
+
+   options.pools.push_back(cpu_miner::PoolEndpoint{
+      .host = positional_or(0U, "192.168.0.104"),
+      .port = positional_or(1U, "3333"),
+      .weight = primary_weight,
+   });
+   options.user = positional_or(2U, "bc1qyourwalletaddresshere.cpu-miner");
+   options.password = positional_or(3U, "x");
+
+   if (!options.replay_path.empty()) {
+      if (!extra_pools.empty() || options.mode == cpu_miner::PoolMode::split) {
+         throw std::invalid_argument("--replay stands in for every pool");
+      }
+      // A replay has no host or port; the positionals are user and password.
+      options.pools.front().host = "replay";
+      options.pools.front().port = "-";
+      options.user = positional_or(0U, "bc1qyourwalletaddresshere.cpu-miner");
+      options.password = positional_or(1U, "x");
+   }
+
+   options.pools.insert(options.pools.end(), extra_pools.begin(),
+                        extra_pools.end());
+   return options;
+}
+
+int run_benchmark_mode(std::chrono::seconds duration) {
+   const std::size_t hardware_threads =
+      std::max(1U, std::thread::hardware_concurrency());
+
+   std::cout << "benchmark: " << duration.count() << " s per run, up to "
+             << hardware_threads << " threads, accepted fixture job\n";
+
+   const auto runs = cpu_miner::run_hashrate_suite(
+      std::chrono::duration_cast<std::chrono::milliseconds>(duration),
+      hardware_threads);
+
+   std::cout << std::left << std::setw(10) << "backend" << std::right
+             << std::setw(8) << "threads" << std::setw(16) << "H/s"
+             << std::setw(12) << "efficiency" << std::setw(14) << "J/hash"
+             << '\n';
+
+   for (const auto& run : runs) {
+      std::cout << std::left << std::setw(10) << run.backend << std::right
+                << std::setw(8) << run.threads << std::fixed
+                << std::setprecision(0) << std::setw(16) << run.hash_rate_hps
+                << std::setprecision(1) << std::setw(11)
+                << run.scaling_efficiency * 100.0 << '%';
+      if (run.joules_per_hash) {
+         std::cout << std::scientific << std::setprecision(3) << std::setw(14)
+                   << *run.joules_per_hash;
+      } else {
+         std::cout << std::setw(14) << "n/a";
+      }
+      std::cout << '\n';
+   }
+
+   if (!runs.empty() && !runs.front().joules_per_hash) {
+      std::cout << "J/hash: RAPL package energy not readable "
+                   "(needs /sys/class/powercap, often root-only)\n";
+   }
+
+   return 0;
+}
+
+// Short enough to keep startup under a few seconds on a many-core machine.
+constexpr std::chrono::milliseconds kTuneCandidateTime{250};
+
+// The cached choice for this CPU model, or a fresh calibration that is then
+// cached. Returns the backend to mine with.
+std::unique_ptr<cpu_miner::HasherBackend> select_backend(bool retune) {
+   // With one backend and one worker there is nothing to choose between, so
+   // the calibration sweep and its cache entry would be pure startup cost.
+   auto backends = cpu_miner::available_backends();
+   if (backends.size() == 1U && kWorkerThreads == 1U) {
+      std::cout << "tune: backend " << backends.front()->name()
+                << " (only choice)\n";
+      return std::move(backends.front());
+   }
+
+   const std::string key = cpu_miner::cpu_model_key();
+   const auto cache = cpu_miner::default_tune_cache_path();
+
+   std::optional<cpu_miner::TuneChoice> choice;
+   std::unique_ptr<cpu_miner::HasherBackend> backend;
+   if (!retune) {
+      choice = cpu_miner::load_tune_choice(cache, key);
+      if (choice) backend = cpu_miner::make_backend(choice->backend);
+   }
+
+   if (backend) {
+      std::cout << "tune: cached for " << key << '\n';
+   } else {
+      const std::size_t hardware_threads =
+         std::max(1U, std::thread::hardware_concurrency());
+      std::cout << "tune: calibrating for " << key << '\n';
+      choice = cpu_miner::calibrate_backends(kTuneCandidateTime,
+                                             hardware_threads);
+      backend = cpu_miner::make_backend(choice->backend);
+      if (!cpu_miner::save_tune_choice(cache, key, *choice)) {
+         std::cout << "tune: could not write " << cache.string() << '\n';
+      }
+   }
+
+   std::cout << "tune: backend " << choice->backend << ", best at "
+             << choice->threads << " thread(s), " << std::fixed
+             << std::setprecision(0) << choice->hash_rate_hps << " H/s\n";
+   std::cout.unsetf(std::ios::floatfield);
+   return backend;
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
    try {
       std::signal(SIGINT, handle_sigint);
+#ifdef SIGUSR1
+      std::signal(SIGUSR1, handle_cycle_dump);
+#endif
+
+      const MinerOptions options = parse_options(argc, argv);
+      if (options.benchmark) {
+         return run_benchmark_mode(options.benchmark_duration);
+      }
 
-      const std::string host = (argc > 1) ? argv[1] : "192.168.0.104";
-      const std::string port = (argc > 2) ? argv[2] : "3333";
-      const std::string user =
-         (argc > 3) ? argv[3] : "bc1qyourwalletaddresshere.cpu-miner";
-      const std::string password = (argc > 4) ? argv[4] : "x";
+      // Outlives every thread below, so their last records are written. It
+      // writes to stderr: stdout belongs to the main thread's event blocks
+      // and status line, which a record from another thread would split.
+      const cpu_miner::util::LogWriter log_writer(stderr);
+
+      auto journal =
+         options.journal_path.empty()
+            ? cpu_miner::util::MappedJournal::anonymous(kJournalCapacity)
+            : cpu_miner::util::MappedJournal::create(options.journal_path,
+                                                     kJournalCapacity);
+      cpu_miner::JournalRenderer journal_renderer;
+      std::uint64_t journal_next = 0U;
+
+      const auto backend = select_backend(options.retune);
+      const std::size_t pool_count = options.pools.size();
+
+      std::vector<std::uint32_t> weights;
+      for (const auto& pool : options.pools) {
+         weights.push_back(pool.weight);
+      }
 
       SharedWorkState shared_work;
-      ShareQueue share_queue;
+      PoolRouter router{cpu_miner::PoolSelector(
+         std::move(weights),
+         cpu_miner::PoolSelectorConfig{.mode = options.mode})};
+      ShareQueues share_queues(pool_count);
       EventQueue events;
-      Counters counters;
+      Counters counters(pool_count);
       std::atomic<std::uint64_t> work_generation{0};
 
+      std::optional<cpu_miner::util::MetricsServer> metrics;
+      if (options.metrics_port) {
+         metrics.emplace(options.metrics_bind, *options.metrics_port, [&]() {
+            return render_metrics(counters, shared_work, work_generation);
+         });
+         std::cout << "metrics: http://" << options.metrics_bind << ':'
+                   << metrics->port() << "/metrics\n";
+      }
+
       std::mutex error_mutex;
       std::exception_ptr first_error;
 
       std::atomic<bool> startup_announced{false};
+      std::atomic<bool> replay_finished{false};
 
-      std::jthread control_thread([&](std::stop_token stop_token) {
+      // One control thread per pool connection. Each owns its client, submits
+      // the shares found on its own work and reports jobs to the router.
+      const auto run_pool_control = [&](std::size_t pool,
+                                        std::stop_token stop_token) {
          try {
-            cpu_miner::StratumClient client(host, port);
-
-            client.connect();
-            client.subscribe();
-            client.suggest_difficulty(1.0);
-            client.authorize(user, password);
-            client.run_until_ready();
+            const auto& endpoint = options.pools[pool];
+            const auto client_ptr =
+               options.replay_path.empty()
+                  ? std::make_unique<cpu_miner::StratumClient>(endpoint.host,
+                                                               endpoint.port)
+                  : std::make_unique<cpu_miner::StratumClient>(
+                       cpu_miner::WireReplay(
+                          cpu_miner::load_wire_capture(options.replay_path),
+                          options.replay_speed));
+            cpu_miner::StratumClient& client = *client_ptr;
+            if (!options.capture_path.empty()) {
+               const std::string capture_path =
+                  pool == 0U
+                     ? options.capture_path
+                     : options.capture_path + '.' + std::to_string(pool);
+               client.capture_to(std::make_unique<cpu_miner::WireCaptureWriter>(
+                  capture_path, endpoint.host + ':' + endpoint.port));
+            }
+            cpu_miner::StratumSession session(
+               client, cpu_miner::SessionCredentials{
+                          .user = options.user,
+                          .password = options.password,
+                          .suggested_difficulty = 1.0,
+                       });
+            // A stop must not wait out a blocked handshake or read.
+            const std::stop_callback abort_io_on_stop(
+               stop_token, [&client]() { client.abort_io(); });
+
+            ShareQueue& share_queue = share_queues[pool];
+            InFlightShares in_flight;
+            std::optional<cpu_miner::VardiffController> vardiff;
+            if (options.share_rate > 0.0) {
+               vardiff.emplace(cpu_miner::VardiffConfig{
+                  .shares_per_minute = options.share_rate,
+               });
+            }
 
-            if (!(client.subscription() && client.current_job())) {
-               throw std::runtime_error(
-                  "missing subscription or current job after startup");
+            const auto recover = [&]() {
+               return recover_connection(session, client, in_flight, router,
+                                         pool, shared_work, work_generation,
+                                         events, counters, stop_token);
+            };
+
+            // With a single pool a failed first connection stays fatal; with
+            // standbys configured it is retried like any later drop.
+            bool started = false;
+            try {
+               session.start();
+               started = true;
+            } catch (const boost::system::system_error& ex) {
+               if (stop_token.stop_requested()) {
+                  events.push(ThreadExitedEvent{.thread_name = "control"});
+                  return;
+               }
+               if (pool_count == 1U) throw;
+               events.push(ConnectionLostEvent{.pool = pool,
+                                               .message = ex.what()});
             }
 
-            publish_latest_work(shared_work, work_generation, client, events);
+            if (started) {
+               if (!(client.subscription() && client.current_job())) {
+                  throw std::runtime_error(
+                     "missing subscription or current job after startup");
+               }
+               offer_pool_work(router, pool, client, shared_work,
+                               work_generation, events);
+            } else if (!recover()) {
+               events.push(ThreadExitedEvent{.thread_name = "control"});
+               return;
+            }
 
             maybe_publish_startup_event(startup_announced, shared_work, client,
                                         events);
 
+            client.set_write_batching(kShareWriteBatching);
+
             while (!stop_token.stop_requested()) {
-               bool did_work = drain_share_queue(client, share_queue, events,
-                                                 counters, work_generation);
+               try {
+                  bool did_work =
+                     drain_share_queue(client, share_queue, in_flight,
+                                       counters, router, pool,
+                                       shared_work.waste);
+
+                  const auto poll = client.poll();
+                  if (poll.difficulty_changed) {
+                     retarget_pool_work(router, pool, client.difficulty(),
+                                        shared_work);
+                     CPU_MINER_LOG_INFO("share difficulty changed: pool={} "
+                                        "difficulty={}",
+                                        pool, client.difficulty());
+                  }
+                  if (poll.work_invalidated) {
+                     offer_pool_work(router, pool, client, shared_work,
+                                     work_generation, events);
+                     maybe_publish_startup_event(startup_announced,
+                                                 shared_work, client, events);
+                  }
 
-               const auto poll = client.poll();
-               if (poll.work_invalidated) {
-                  publish_latest_work(shared_work, work_generation, client,
-                                      events);
-               }
+                  if (poll.got_message) {
+                     did_work = true;
+                  }
 
-               if (poll.got_message) {
-                  did_work = true;
-               }
+                  if (collect_submit_results(client, in_flight, events,
+                                             counters)) {
+                     did_work = true;
+                  }
 
-               if (did_work) {
-                  continue;
-               }
+                  if (did_work) {
+                     continue;
+                  }
+
+                  if (vardiff) {
+                     const auto difficulty =
+                        vardiff->update(pool_live_hashes(counters, pool),
+                                        std::chrono::steady_clock::now());
+                     if (difficulty) {
+                        session.suggest_difficulty(*difficulty);
+                        counters.difficulty_suggestions.fetch_add(
+                           1U, std::memory_order_relaxed);
+                        CPU_MINER_LOG_INFO("suggested difficulty: pool={} "
+                                           "difficulty={} hashrate={}",
+                                           pool, *difficulty,
+                                           vardiff->hashrate_hps());
+                     }
+                  }
 
-               control_idle_wait(share_queue, stop_token);
+                  // Notify timeouts and split slices are noticed here.
+                  (void)route_pool_work(router, std::nullopt, PoolReport::none,
+                                        shared_work, work_generation, events);
+
+                  control_idle_wait(share_queue, client, stop_token);
+               } catch (const cpu_miner::WireReplayFinished&) {
+                  replay_finished.store(true, std::memory_order_relaxed);
+                  break;
+               } catch (const boost::system::system_error& ex) {
+                  if (stop_token.stop_requested()) break;
+                  events.push(ConnectionLostEvent{.pool = pool,
+                                                  .message = ex.what()});
+                  if (!recover()) {
+                     break;
+                  }
+               }
             }
          } catch (...) {
             record_thread_exception(error_mutex, first_error, events,
@@ -893,16 +1885,29 @@ int main(int argc, char* argv[]) {
          }
 
          events.push(ThreadExitedEvent{.thread_name = "control"});
-      });
+      };
+
+      std::vector<std::jthread> control_threads;
+      control_threads.reserve(pool_count);
+      for (std::size_t pool = 0; pool < pool_count; ++pool) {
+         control_threads.emplace_back(
+            [&run_pool_control, pool](std::stop_token stop_token) {
+               run_pool_control(pool, stop_token);
+            });
+      }
 
       std::jthread worker_thread([&](std::stop_token stop_token) {
+         const std::stop_callback abort_on_stop(stop_token, [&]() {
+            shared_work.worker_abort.request_stop();
+         });
+         cpu_miner::util::name_cycle_thread("worker");
+
          try {
-            cpu_miner::CpuHasherBackend backend;
-            cpu_miner::MiningCoordinator coordinator{backend};
+            cpu_miner::MiningCoordinator coordinator{*backend};
 
             for (;;) {
                const auto maybe_published =
-                  wait_for_published_work(shared_work, stop_token);
+                  wait_for_published_work(shared_work, 0U, stop_token);
                if (!maybe_published.has_value()) {
                   events.push(ThreadExitedEvent{.thread_name = "worker"});
                   return;
@@ -911,21 +1916,42 @@ int main(int argc, char* argv[]) {
                auto published = *maybe_published;
                auto work = published.work;
 
-               coordinator.set_job(work.job, work.subscription,
+               coordinator.set_job(work.job, work.decoded, work.subscription,
                                    work.extranonce2_counter);
+               bool first_hash_noted = false;
+               std::optional<std::uint64_t> journaled_extranonce2;
+               std::uint64_t work_id = 0U;
 
                while (!stop_token.stop_requested()) {
+                  if (journaled_extranonce2 != work.extranonce2_counter) {
+                     journaled_extranonce2 = work.extranonce2_counter;
+                     work_id = cpu_miner::journal_work(journal, work,
+                                                       published.generation);
+                  }
+
                   const ScanChunk chunk = make_scan_chunk(work.nonce);
                   const std::uint64_t nonce_begin = chunk.nonce_begin;
                   const std::uint64_t nonce_end = chunk.nonce_end;
 
-                  const auto result =
-                     run_scan_chunk(coordinator, published, work, nonce_begin,
-                                    nonce_end, stop_token, work_generation,
-                                    share_queue, events, counters);
+                  const auto scan_started = std::chrono::steady_clock::now();
+                  const auto result = run_scan_chunk(
+                     coordinator, published, work_id, nonce_begin, nonce_end,
+                     stop_token, work_generation, shared_work.worker_abort,
+                     shared_work.share_target, share_queues, journal,
+                     counters.workers[0], counters.pools[published.pool]);
+                  shared_work.waste.note_scan(
+                     published.generation, result.hashes_done, scan_started,
+                     std::chrono::steady_clock::now());
+
+                  if (!first_hash_noted && result.hashes_done != 0U) {
+                     first_hash_noted = true;
+                     shared_work.latency.note_first_hash(
+                        published.generation, 0U, result.first_hash_at);
+                  }
 
                   switch (handle_scan_result(result, work, coordinator,
-                                             nonce_end, events)) {
+                                             nonce_end, shared_work,
+                                             published.generation, events)) {
                   case WorkerNextAction::adopt_new_work:
                      break;
                   case WorkerNextAction::exit_thread:
@@ -944,18 +1970,38 @@ int main(int argc, char* argv[]) {
       });
 
       bool stop_requested = false;
-      bool control_exited = false;
+      std::size_t controls_exited = 0U;
       bool worker_exited = false;
       auto last_status_print = std::chrono::steady_clock::now();
       bool status_line_active = false;
 
-      while (!(control_exited && worker_exited)) {
+      const auto request_stop_all = [&]() {
+         for (auto& control_thread : control_threads) {
+            control_thread.request_stop();
+         }
+         worker_thread.request_stop();
+      };
+
+      while (!(controls_exited == pool_count && worker_exited)) {
+         if (g_cycle_dump_requested != 0) {
+            g_cycle_dump_requested = 0;
+            clear_status_line(status_line_active);
+            cpu_miner::util::print_cycle_counters(std::cout);
+         }
+
          if (g_sigint_requested != 0 && !stop_requested) {
             stop_requested = true;
             events.push(ShutdownEvent{
                .reason = "SIGINT received; requesting graceful shutdown"});
-            control_thread.request_stop();
-            worker_thread.request_stop();
+            request_stop_all();
+         }
+
+         if (replay_finished.load(std::memory_order_relaxed) &&
+             !stop_requested) {
+            stop_requested = true;
+            events.push(ShutdownEvent{
+               .reason = "stratum replay finished; requesting shutdown"});
+            request_stop_all();
          }
 
          {
@@ -964,8 +2010,7 @@ int main(int argc, char* argv[]) {
                stop_requested = true;
                events.push(ShutdownEvent{
                   .reason = "fatal worker/control error; requesting shutdown"});
-               control_thread.request_stop();
-               worker_thread.request_stop();
+               request_stop_all();
             }
          }
 
@@ -973,9 +2018,11 @@ int main(int argc, char* argv[]) {
          if (events.wait_pop_for(event, std::chrono::milliseconds(100))) {
             const auto outcome =
                render_event(event, counters, status_line_active);
-            control_exited = control_exited || outcome.control_exited;
+            controls_exited += outcome.controls_exited;
             worker_exited = worker_exited || outcome.worker_exited;
          }
+         render_journal(journal, journal_renderer, journal_next, counters,
+                        status_line_active);
 
          const auto now = std::chrono::steady_clock::now();
          if (now - last_status_print >= std::chrono::seconds(2)) {
@@ -1000,10 +2047,21 @@ int main(int argc, char* argv[]) {
             leftover);
       }
 
+      render_journal(journal, journal_renderer, journal_next, counters,
+                     status_line_active);
       clear_status_line(status_line_active);
 
       std::cout << "final totals:\n";
       print_running_totals(snapshot_counters(counters));
+      print_switch_latency(shared_work.latency.report());
+      print_wasted_work(shared_work.waste.report());
+      if (options.share_rate > 0.0) {
+         print_vardiff_savings(counters,
+                               snapshot_counters(counters).hashes_done);
+      }
+      if constexpr (cpu_miner::util::kCycleCountersEnabled) {
+         cpu_miner::util::print_cycle_counters(std::cout);
+      }
 
       {
          std::lock_guard<std::mutex> lock(error_mutex);
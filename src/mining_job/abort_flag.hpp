@@ -0,0 +1,58 @@
+// src/mining_job/abort_flag.hpp
+
+#ifndef CPU_MINER_MINING_JOB_ABORT_FLAG_HPP
+#define CPU_MINER_MINING_JOB_ABORT_FLAG_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/*******************************************************************************
+Purpose:
+  One word per worker telling its scan to give up the current range, either
+  because newer work was published (stale) or because the worker must exit
+  (stop).
+
+Requirements:
+  - the word sits alone on its cache line, so a worker polling its own flag
+    never shares a line with another worker's flag or with hot shared state
+  - the control side only ever sets bits; the worker clears stale when it
+    adopts new work, and stop is never cleared
+
+Notes:
+  - Scans read the word once per check block (see ScanControl), not per
+    nonce.
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct alignas(64) AbortFlag {
+   static constexpr std::uint32_t stale = 1U << 0;
+   static constexpr std::uint32_t stop = 1U << 1;
+
+   std::atomic<std::uint32_t> word{0U};
+
+   void request_stale() noexcept {
+      word.fetch_or(stale, std::memory_order_release);
+   }
+
+   void request_stop() noexcept {
+      word.fetch_or(stop, std::memory_order_release);
+   }
+
+   // The worker clears stale while holding the lock that guards the published
+   // work, and the publisher sets it under the same lock, so a set bit always
+   // means work newer than what the worker last read.
+   void clear_stale() noexcept {
+      word.fetch_and(~stale, std::memory_order_acq_rel);
+   }
+
+   [[nodiscard]] std::uint32_t load() const noexcept {
+      return word.load(std::memory_order_acquire);
+   }
+};
+
+static_assert(sizeof(AbortFlag) == 64U);
+
+} // namespace cpu_miner
+
+#endif
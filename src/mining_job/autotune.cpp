@@ -0,0 +1,159 @@
+// src/mining_job/autotune.cpp
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include "mining_job/autotune.hpp"
+
+namespace cpu_miner {
+namespace {
+
+struct CacheLine {
+   std::string key;
+   TuneChoice choice;
+};
+
+[[nodiscard]] std::optional<CacheLine>
+parse_cache_line(const std::string& line) {
+   std::istringstream in(line);
+   CacheLine parsed;
+   std::string threads;
+   std::string rate;
+
+   if (!std::getline(in, parsed.key, '\t') ||
+       !std::getline(in, parsed.choice.backend, '\t') ||
+       !std::getline(in, threads, '\t') || !std::getline(in, rate)) {
+      return std::nullopt;
+   }
+
+   try {
+      parsed.choice.threads = std::stoul(threads);
+      parsed.choice.hash_rate_hps = std::stod(rate);
+   } catch (const std::exception&) {
+      return std::nullopt;
+   }
+   if (parsed.choice.threads == 0U) return std::nullopt;
+   return parsed;
+}
+
+} // namespace
+
+std::string cpu_model_key(const std::filesystem::path& cpuinfo) {
+   std::string model = "unknown";
+
+   std::ifstream in(cpuinfo);
+   for (std::string line; std::getline(in, line);) {
+      // x86 uses "model name"; some arm64 kernels only give "Processor".
+      if (!line.starts_with("model name") && !line.starts_with("Processor")) {
+         continue;
+      }
+      const auto colon = line.find(':');
+      if (colon == std::string::npos) continue;
+
+      const auto first = line.find_first_not_of(" \t", colon + 1U);
+      if (first == std::string::npos) continue;
+      model = line.substr(first);
+      break;
+   }
+
+   // The cache format is tab-separated.
+   for (char& c : model) {
+      if (c == '\t') c = ' ';
+   }
+
+   return model + '|' + std::to_string(std::thread::hardware_concurrency());
+}
+
+std::filesystem::path default_tune_cache_path() {
+   if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+      return std::filesystem::path(xdg) / "cpu_miner" / "tune";
+   }
+   if (const char* home = std::getenv("HOME"); home && *home) {
+      return std::filesystem::path(home) / ".cache" / "cpu_miner" / "tune";
+   }
+   return "cpu_miner.tune";
+}
+
+std::optional<TuneChoice> load_tune_choice(const std::filesystem::path& cache,
+                                           const std::string& key) {
+   std::ifstream in(cache);
+   for (std::string line; std::getline(in, line);) {
+      const auto parsed = parse_cache_line(line);
+      if (parsed && parsed->key == key) return parsed->choice;
+   }
+   return std::nullopt;
+}
+
+bool save_tune_choice(const std::filesystem::path& cache,
+                      const std::string& key, const TuneChoice& choice) {
+   std::vector<std::string> kept;
+   {
+      std::ifstream in(cache);
+      for (std::string line; std::getline(in, line);) {
+         const auto parsed = parse_cache_line(line);
+         if (parsed && parsed->key != key) kept.push_back(line);
+      }
+   }
+
+   std::error_code ec;
+   if (cache.has_parent_path()) {
+      std::filesystem::create_directories(cache.parent_path(), ec);
+      if (ec) return false;
+   }
+
+   // Write beside the cache and rename, so a concurrent start never reads a
+   // half-written file.
+   auto tmp = cache;
+   tmp += ".tmp";
+   {
+      std::ofstream out(tmp, std::ios::trunc);
+      if (!out) return false;
+      for (const auto& line : kept) {
+         out << line << '\n';
+      }
+      out << key << '\t' << choice.backend << '\t' << choice.threads << '\t'
+          << choice.hash_rate_hps << '\n';
+      if (!out) return false;
+   }
+
+   std::filesystem::rename(tmp, cache, ec);
+   return !ec;
+}
+
+std::optional<TuneChoice> pick_fastest(const std::vector<HashrateRun>& runs) {
+   const HashrateRun* best = nullptr;
+   for (const auto& run : runs) {
+      if (best == nullptr || run.hash_rate_hps > best->hash_rate_hps) {
+         best = &run;
+      }
+   }
+   if (best == nullptr) return std::nullopt;
+
+   return TuneChoice{
+      .backend = best->backend,
+      .threads = best->threads,
+      .hash_rate_hps = best->hash_rate_hps,
+   };
+}
+
+TuneChoice calibrate_backends(std::chrono::milliseconds per_candidate,
+                              std::size_t hardware_threads) {
+   std::vector<HashrateRun> runs;
+   for (const auto& backend : available_backends()) {
+      for (const std::size_t threads :
+           benchmark_thread_counts(hardware_threads)) {
+         runs.push_back(
+            run_hashrate(*backend, threads, per_candidate, nullptr));
+      }
+   }
+
+   auto best = pick_fastest(runs);
+   if (!best) throw std::runtime_error("calibrate_backends: no backends");
+   return *best;
+}
+
+} // namespace cpu_miner
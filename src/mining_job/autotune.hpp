@@ -0,0 +1,71 @@
+// src/mining_job/autotune.hpp
+
+#ifndef CPU_MINER_MINING_JOB_AUTOTUNE_HPP
+#define CPU_MINER_MINING_JOB_AUTOTUNE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mining_job/hashrate_benchmark.hpp"
+
+/*******************************************************************************
+Purpose:
+  Pick the fastest backend and thread count for this machine with a short
+  calibration at startup, and remember the choice per CPU model so later
+  starts skip it.
+
+Scope:
+  - candidates are available_backends() x benchmark_thread_counts()
+  - cache file with one "key<TAB>backend<TAB>threads<TAB>H/s" line per model
+
+Requirements:
+  - the key covers the CPU model and logical CPU count, so a cache shared
+    through a home directory never applies one machine's result to another
+  - a cached backend this build no longer has forces recalibration
+
+Notes:
+  - an unreadable or malformed cache is treated as missing; a cache that
+    cannot be written only costs a calibration on the next start
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct TuneChoice {
+   std::string backend;
+   std::size_t threads{};
+   double hash_rate_hps{};
+};
+
+// "<model name>|<logical cpus>", from /proc/cpuinfo on Linux. Falls back to
+// "unknown" for the model when cpuinfo is unreadable.
+[[nodiscard]] std::string
+cpu_model_key(const std::filesystem::path& cpuinfo = "/proc/cpuinfo");
+
+// $XDG_CACHE_HOME/cpu_miner/tune, else $HOME/.cache/cpu_miner/tune, else
+// ./cpu_miner.tune.
+[[nodiscard]] std::filesystem::path default_tune_cache_path();
+
+[[nodiscard]] std::optional<TuneChoice>
+load_tune_choice(const std::filesystem::path& cache, const std::string& key);
+
+// Replaces any existing line for key. Returns false if the file could not be
+// written.
+bool save_tune_choice(const std::filesystem::path& cache,
+                      const std::string& key, const TuneChoice& choice);
+
+// Fastest run; on equal rates the earlier (fewer threads) run wins.
+[[nodiscard]] std::optional<TuneChoice>
+pick_fastest(const std::vector<HashrateRun>& runs);
+
+// Times every candidate for per_candidate and returns the fastest.
+[[nodiscard]] TuneChoice
+calibrate_backends(std::chrono::milliseconds per_candidate,
+                   std::size_t hardware_threads);
+
+} // namespace cpu_miner
+
+#endif
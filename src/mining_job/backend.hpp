@@ -19,7 +19,6 @@ struct BackendScanRequest {
    u256::uint256 share_target;
    std::uint64_t nonce_begin{};
    std::uint64_t nonce_end{};
-   std::uint64_t progress_interval{};
    ScanControl control{};
 };
 
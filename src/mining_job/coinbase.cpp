@@ -308,6 +308,47 @@ CoinbaseBuild build_coinbase(const MiningJob& job,
    return out;
 }
 
+CoinbaseBuild build_coinbase(const DecodedJob& job,
+                             const SubscriptionContext& sub,
+                             const std::string& extranonce2_hex) {
+   if (extranonce2_hex.size() != sub.extranonce2_size * 2U) {
+      throw std::invalid_argument("extranonce2 has wrong hex length");
+   }
+
+   const std::size_t extranonce1_size = sub.extranonce1.size() / 2U;
+   const std::size_t extranonce1_offset = job.coinb1.size();
+   const std::size_t extranonce2_offset = extranonce1_offset + extranonce1_size;
+   const std::size_t coinb2_offset = extranonce2_offset + sub.extranonce2_size;
+
+   CoinbaseBuild out;
+   out.extranonce2_hex = extranonce2_hex;
+   out.coinbase_bytes.resize(coinb2_offset + job.coinb2.size());
+
+   const std::span<std::uint8_t> coinbase(out.coinbase_bytes);
+
+   std::copy(job.coinb1.begin(), job.coinb1.end(), coinbase.begin());
+   if (!hex_decode_into(sub.extranonce1,
+                        coinbase.subspan(extranonce1_offset,
+                                         extranonce1_size))) {
+      throw std::invalid_argument("extranonce1 is not valid lowercase hex");
+   }
+   if (!hex_decode_into(extranonce2_hex,
+                        coinbase.subspan(extranonce2_offset,
+                                         sub.extranonce2_size))) {
+      throw std::invalid_argument("extranonce2 is not valid lowercase hex");
+   }
+   std::copy(job.coinb2.begin(), job.coinb2.end(),
+             coinbase.begin() +
+                static_cast<std::ptrdiff_t>(coinb2_offset));
+
+   out.coinbase_hex = bytes_to_hex(out.coinbase_bytes);
+
+   const auto hash_words = sha256::dbl_sha256_words(out.coinbase_bytes);
+   out.coinbase_hash = sha256::digest_words_to_bytes_be(hash_words);
+
+   return out;
+}
+
 ScriptSigSummary
 summarize_script_sig(const std::vector<std::uint8_t>& script_sig) {
    ScriptSigSummary out;
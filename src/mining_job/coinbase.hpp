@@ -56,6 +56,10 @@ CoinbaseBuild build_coinbase(const MiningJob& job,
                              const SubscriptionContext& sub,
                              const std::string& extranonce2_hex);
 
+CoinbaseBuild build_coinbase(const DecodedJob& job,
+                             const SubscriptionContext& sub,
+                             const std::string& extranonce2_hex);
+
 std::string
 decode_p2wpkh_address(const std::vector<std::uint8_t>& script_pubkey);
 std::string
@@ -4,6 +4,8 @@
 
 #include <stdexcept>
 
+#include "util/cycles.hpp"
+
 namespace cpu_miner {
 
 MiningCoordinator::MiningCoordinator(HasherBackend& backend)
@@ -16,6 +18,13 @@ void MiningCoordinator::set_job(const MiningJob& job,
    ++generation_;
 }
 
+void MiningCoordinator::set_job(const MiningJob& job, const DecodedJob& decoded,
+                                const SubscriptionContext& subscription,
+                                std::uint64_t extranonce2_counter) {
+   prepared_ = prepare_work(job, decoded, subscription, extranonce2_counter);
+   ++generation_;
+}
+
 std::uint64_t MiningCoordinator::generation() const noexcept {
    return generation_;
 }
@@ -28,13 +37,13 @@ ScanResult MiningCoordinator::scan_range(std::uint64_t nonce_begin,
                                          std::uint64_t nonce_end,
                                          const u256::uint256& network_target,
                                          const u256::uint256& share_target,
-                                         std::uint64_t progress_interval,
                                          const ScanControl& control) const {
 
    if (!prepared_) {
       throw std::runtime_error("scan_range called without prepared work");
    }
 
+   util::CycleLap lap;
    const auto request_generation = generation_;
 
    BackendScanRequest request{
@@ -43,9 +52,9 @@ ScanResult MiningCoordinator::scan_range(std::uint64_t nonce_begin,
       .share_target = share_target,
       .nonce_begin = nonce_begin,
       .nonce_end = nonce_end,
-      .progress_interval = progress_interval,
       .control = control,
    };
+   lap.mark(util::CycleStage::backend_setup);
 
    auto result = backend_->scan(request, [&](const ShareCandidate& candidate) {
       if (request_generation != generation_) {
@@ -53,8 +62,10 @@ ScanResult MiningCoordinator::scan_range(std::uint64_t nonce_begin,
       }
 
       if (on_share_found_) {
+         util::CycleLap share_lap;
          const auto submission =
             make_share_submission(request.prepared, candidate.nonce);
+         share_lap.mark(util::CycleStage::make_submission);
 
          on_share_found_(submission, candidate);
       }
@@ -22,6 +22,9 @@ class MiningCoordinator {
 
    void set_job(const MiningJob& job, const SubscriptionContext& subscription,
                 std::uint64_t extranonce2_counter = 0);
+   void set_job(const MiningJob& job, const DecodedJob& decoded,
+                const SubscriptionContext& subscription,
+                std::uint64_t extranonce2_counter = 0);
 
    [[nodiscard]] std::uint64_t generation() const noexcept;
 
@@ -31,7 +34,6 @@ class MiningCoordinator {
                                        std::uint64_t nonce_end,
                                        const u256::uint256& network_target,
                                        const u256::uint256& share_target,
-                                       std::uint64_t progress_interval,
                                        const ScanControl& control) const;
 
  private:
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <string_view>
 
+#include "util/cycles.hpp"
+
 namespace cpu_miner {
 
 std::string_view CpuHasherBackend::name() const noexcept { return "cpu"; }
@@ -12,14 +14,16 @@ std::string_view CpuHasherBackend::name() const noexcept { return "cpu"; }
 ScanResult
 CpuHasherBackend::scan(const BackendScanRequest& request,
                        BackendShareFoundCallback on_share_found) const {
+   util::CycleLap lap;
    auto work =
       work_state_from_prepared(request.prepared,
                                static_cast<std::uint32_t>(request.nonce_begin));
    const auto base_work = work_state_from_prepared(request.prepared, 0U);
+   lap.mark(util::CycleStage::backend_setup);
 
    return scan_nonce_range(work, request.network_target, request.share_target,
                            request.nonce_begin, request.nonce_end,
-                           request.progress_interval, request.control,
+                           request.control,
                            [&](std::uint32_t nonce,
                                const sha256::DigestBytes& hash,
                                bool is_block_candidate) {
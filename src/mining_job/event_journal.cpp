@@ -0,0 +1,193 @@
+// src/mining_job/event_journal.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+
+#include "mining_job/event_journal.hpp"
+#include "mining_job/target.hpp"
+#include "util/hex.hpp"
+
+namespace cpu_miner {
+namespace {
+
+template <std::size_t N>
+std::uint8_t copy_truncated(std::array<char, N>& out, std::string_view text,
+                            bool& truncated) {
+   const std::size_t size = std::min(text.size(), N);
+   if (size < text.size()) truncated = true;
+   std::copy_n(text.begin(), size, out.begin());
+   return static_cast<std::uint8_t>(size);
+}
+
+std::string truncated_text(const char* data, std::size_t size,
+                           bool truncated) {
+   std::string text(data, size);
+   if (truncated) text += "...";
+   return text;
+}
+
+} // namespace
+
+std::uint64_t journal_work(util::MappedJournal& journal, const WorkState& work,
+                           std::uint64_t generation) {
+   JournalWork record;
+   record.generation = generation;
+   record.job_id_size =
+      copy_truncated(record.job_id, work.job.job_id, record.truncated);
+   record.extranonce2_size = copy_truncated(
+      record.extranonce2_hex, work.coinbase.extranonce2_hex, record.truncated);
+   record.merkle_root = work.merkle_root_sha_input;
+   return journal.append(record);
+}
+
+void journal_chunk_started(util::MappedJournal& journal, std::uint64_t work,
+                           std::uint64_t nonce_begin,
+                           std::uint64_t nonce_end) {
+   JournalChunkStarted record;
+   record.work = work;
+   record.nonce_begin = nonce_begin;
+   record.nonce_end = nonce_end;
+   (void)journal.append(record);
+}
+
+void journal_share_found(util::MappedJournal& journal, std::uint64_t work,
+                         const ShareCandidate& candidate,
+                         const u256::uint256& share_target) {
+   JournalShareFound record;
+   record.work = work;
+   record.nonce = candidate.nonce;
+   record.nbits = candidate.work.decoded.nbits;
+   record.block_candidate = candidate.is_block_candidate;
+   record.hash = candidate.hash;
+   share_target.to_bytes_be(record.share_target.data());
+   (void)journal.append(record);
+}
+
+void journal_scan_finished(util::MappedJournal& journal, std::uint64_t work,
+                           const ScanResult& result) {
+   JournalScanFinished record;
+   record.work = work;
+   record.hashes_done = result.hashes_done;
+   record.shares_found = result.shares_found;
+   record.blocks_found = result.blocks_found;
+   record.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::duration<double>(result.elapsed_seconds))
+                          .count();
+   record.stop_reason = result.stop_reason;
+   (void)journal.append(record);
+}
+
+std::string scan_stop_reason_name(ScanStopReason reason) {
+   switch (reason) {
+   case ScanStopReason::exhausted:
+      return "exhausted";
+   case ScanStopReason::stale:
+      return "stale";
+   case ScanStopReason::stop_requested:
+      return "stop_requested";
+   }
+   return "unknown";
+}
+
+JournalRenderer::JournalRenderer(std::size_t remembered_work)
+   : remembered_work_(std::max<std::size_t>(remembered_work, 1U)) {}
+
+JournalRenderer::WorkLabel JournalRenderer::label(std::uint64_t work) const {
+   const auto it = work_.find(work);
+   if (it == work_.end()) {
+      return WorkLabel{
+         .job_id = "?",
+         .extranonce2_hex = "?",
+         .generation = "?",
+         .merkle_root_hex = "?",
+      };
+   }
+
+   const JournalWork& record = it->second;
+   return WorkLabel{
+      .job_id = truncated_text(record.job_id.data(), record.job_id_size,
+                               record.truncated),
+      .extranonce2_hex =
+         truncated_text(record.extranonce2_hex.data(),
+                        record.extranonce2_size, record.truncated),
+      .generation = std::to_string(record.generation),
+      .merkle_root_hex = bytes_to_hex(record.merkle_root),
+   };
+}
+
+std::string JournalRenderer::render(const util::JournalRecord& record) {
+   std::ostringstream out;
+
+   if (const auto work = util::journal_payload<JournalWork>(record)) {
+      // Work ids are sequence numbers, so the smallest is the oldest.
+      work_.emplace(record.commit - 1U, *work);
+      while (work_.size() > remembered_work_) {
+         work_.erase(work_.begin());
+      }
+   } else if (const auto chunk =
+                 util::journal_payload<JournalChunkStarted>(record)) {
+      const WorkLabel work_label = label(chunk->work);
+      out << "mining chunk:\n";
+      out << "  generation: " << work_label.generation << '\n';
+      out << "  job_id: " << work_label.job_id << '\n';
+      out << "  extranonce2: " << work_label.extranonce2_hex << '\n';
+      out << "  nonce range: [" << chunk->nonce_begin << ", "
+          << chunk->nonce_end << "]\n";
+   } else if (const auto share =
+                 util::journal_payload<JournalShareFound>(record)) {
+      const WorkLabel work_label = label(share->work);
+      const auto share_target =
+         u256::uint256::from_bytes_be(share->share_target.data());
+      const auto network_target = expand_compact_target(share->nbits);
+
+      out << "  " << (share->block_candidate ? "BLOCK CANDIDATE" : "SHARE HIT")
+          << " generation=" << work_label.generation
+          << " nonce=" << share->nonce << '\n';
+      out << "    hash (display, BE):  " << bytes_to_hex_fixed_msb(share->hash)
+          << '\n';
+      out << "    hash (raw bytes):    " << bytes_to_hex(share->hash) << '\n';
+      out << "    share target:        " << share_target.to_hex_be_fixed()
+          << '\n';
+      out << "    network target:      " << network_target.to_hex_be_fixed()
+          << '\n';
+      out << "    meets share target:  "
+          << (hash_meets_target(share->hash, share_target) ? "true" : "false")
+          << '\n';
+      out << "    meets network target:"
+          << (hash_meets_target(share->hash, network_target) ? " true"
+                                                              : " false")
+          << '\n';
+      out << "    job_id:              " << work_label.job_id << '\n';
+      out << "    extranonce2:         " << work_label.extranonce2_hex << '\n';
+      out << "    merkle root (BE):    " << work_label.merkle_root_hex << '\n';
+   } else if (const auto scan =
+                 util::journal_payload<JournalScanFinished>(record)) {
+      const WorkLabel work_label = label(scan->work);
+      const double seconds = static_cast<double>(scan->elapsed_ns) / 1e9;
+      const double rate =
+         seconds > 0.0 ? static_cast<double>(scan->hashes_done) / seconds
+                       : 0.0;
+
+      out << "scan result:\n";
+      out << "  job_id: " << work_label.job_id << '\n';
+      out << "  extranonce2: " << work_label.extranonce2_hex << '\n';
+      out << "  generation: " << work_label.generation << '\n';
+      out << "  scanned hashes: " << scan->hashes_done << '\n';
+      out << "  shares found: " << scan->shares_found << '\n';
+      out << "  blocks found: " << scan->blocks_found << '\n';
+      out << "  elapsed seconds: " << std::fixed << std::setprecision(3)
+          << seconds << '\n';
+      out << "  average rate: " << std::setprecision(0) << rate << " H/s\n";
+      out << "  stop reason: " << scan_stop_reason_name(scan->stop_reason)
+          << '\n';
+   } else {
+      out << "journal record type " << record.type << " (unknown)\n";
+   }
+
+   return out.str();
+}
+
+} // namespace cpu_miner
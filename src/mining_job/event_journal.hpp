@@ -0,0 +1,135 @@
+// src/mining_job/event_journal.hpp
+
+#ifndef CPU_MINER_MINING_JOB_EVENT_JOURNAL_HPP
+#define CPU_MINER_MINING_JOB_EVENT_JOURNAL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "mining_job/scan.hpp"
+#include "mining_job/work_state.hpp"
+#include "sha256/sha256.hpp"
+#include "util/journal.hpp"
+#include "util/uint256.hpp"
+
+/*******************************************************************************
+Purpose:
+  The worker's events as journal records: a work record each time the
+  worker starts on new work or a new extranonce2, then chunk, share and
+  scan records that refer to it by that record's sequence number.
+
+Scope:
+  - journal_* writers, called on the worker thread
+  - JournalRenderer: the console text for a record, shared by the miner's
+    main loop and the offline journal_dump tool
+
+Requirements:
+  - writers copy only fixed-size fields; strings go into the work record
+    once per work, not into every event
+  - rendering a record whose work record was overwritten still works, with
+    the job fields shown as unknown
+
+Notes:
+  - coinbase bytes are not journaled; the merkle root identifies the work
+  - the network target is rebuilt from nbits when rendering
+*******************************************************************************/
+
+namespace cpu_miner {
+
+enum class JournalEvent : std::uint32_t {
+   work = 1,
+   chunk_started = 2,
+   share_found = 3,
+   scan_finished = 4,
+};
+
+// Job id and extranonce2 are truncated to the arrays; `truncated` says so.
+struct JournalWork {
+   static constexpr JournalEvent kJournalType = JournalEvent::work;
+
+   std::uint64_t generation{};
+   std::uint8_t job_id_size{};
+   std::uint8_t extranonce2_size{};
+   bool truncated{};
+   std::array<char, 32> job_id{};
+   std::array<char, 24> extranonce2_hex{};
+   std::array<std::uint8_t, 32> merkle_root{};
+};
+
+struct JournalChunkStarted {
+   static constexpr JournalEvent kJournalType = JournalEvent::chunk_started;
+
+   std::uint64_t work{};
+   std::uint64_t nonce_begin{};
+   std::uint64_t nonce_end{};
+};
+
+struct JournalShareFound {
+   static constexpr JournalEvent kJournalType = JournalEvent::share_found;
+
+   std::uint64_t work{};
+   std::uint32_t nonce{};
+   std::uint32_t nbits{};
+   bool block_candidate{};
+   sha256::DigestBytes hash{};
+   // Big-endian.
+   std::array<std::uint8_t, 32> share_target{};
+};
+
+struct JournalScanFinished {
+   static constexpr JournalEvent kJournalType = JournalEvent::scan_finished;
+
+   std::uint64_t work{};
+   std::uint64_t hashes_done{};
+   std::uint64_t shares_found{};
+   std::uint64_t blocks_found{};
+   std::int64_t elapsed_ns{};
+   ScanStopReason stop_reason{ScanStopReason::exhausted};
+};
+
+// Returns the work id the other records refer to.
+std::uint64_t journal_work(util::MappedJournal& journal, const WorkState& work,
+                           std::uint64_t generation);
+
+void journal_chunk_started(util::MappedJournal& journal, std::uint64_t work,
+                           std::uint64_t nonce_begin, std::uint64_t nonce_end);
+
+void journal_share_found(util::MappedJournal& journal, std::uint64_t work,
+                         const ShareCandidate& candidate,
+                         const u256::uint256& share_target);
+
+void journal_scan_finished(util::MappedJournal& journal, std::uint64_t work,
+                           const ScanResult& result);
+
+[[nodiscard]] std::string scan_stop_reason_name(ScanStopReason reason);
+
+// Remembers the most recent work records so later records can be rendered
+// with their job id, extranonce2 and generation.
+class JournalRenderer {
+ public:
+   explicit JournalRenderer(std::size_t remembered_work = 256U);
+
+   // Console text for the record, newline-terminated; empty for work
+   // records, which are only remembered.
+   [[nodiscard]] std::string render(const util::JournalRecord& record);
+
+ private:
+   struct WorkLabel {
+      std::string job_id;
+      std::string extranonce2_hex;
+      std::string generation;
+      std::string merkle_root_hex;
+   };
+
+   [[nodiscard]] WorkLabel label(std::uint64_t work) const;
+
+   std::size_t remembered_work_;
+   std::map<std::uint64_t, JournalWork> work_;
+};
+
+} // namespace cpu_miner
+
+#endif
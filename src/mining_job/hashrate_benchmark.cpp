@@ -0,0 +1,162 @@
+// src/mining_job/hashrate_benchmark.cpp
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "mining_job/abort_flag.hpp"
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/cpu_backend.hpp"
+#include "mining_job/hashrate_benchmark.hpp"
+#include "mining_job/scan.hpp"
+#include "util/cycles.hpp"
+
+namespace cpu_miner {
+namespace {
+
+// Nonces per scan call; threads are stopped through their abort flag long
+// before a range is exhausted.
+constexpr std::uint64_t kRangeNonces = 1ULL << 24;
+
+void scan_until_stopped(const HasherBackend& backend,
+                        const PreparedWork& prepared, const AbortFlag& abort,
+                        std::uint64_t& hashes) {
+   util::name_cycle_thread("benchmark " + std::string(backend.name()));
+
+   ScanControl control{};
+   control.abort = &abort;
+
+   BackendScanRequest request{
+      .prepared = prepared,
+      .network_target = {},
+      .share_target = {},
+      .nonce_begin = 0U,
+      .nonce_end = kRangeNonces - 1U,
+      .control = control,
+   };
+
+   for (;;) {
+      const auto result = backend.scan(request, nullptr);
+      hashes += result.hashes_done;
+      if (result.stop_reason != ScanStopReason::exhausted) return;
+
+      request.nonce_begin = (request.nonce_end + 1U) & 0xffffffffULL;
+      request.nonce_end = request.nonce_begin + kRangeNonces - 1U;
+   }
+}
+
+} // namespace
+
+PreparedWork benchmark_prepared_work(std::uint64_t extranonce2_counter) {
+   return prepare_work(make_accepted_job(), make_accepted_subscription(),
+                       extranonce2_counter);
+}
+
+std::vector<std::size_t> benchmark_thread_counts(std::size_t hardware_threads) {
+   const std::size_t max_threads = std::max<std::size_t>(hardware_threads, 1U);
+
+   std::vector<std::size_t> counts;
+   for (std::size_t n = 1U; n < max_threads; n *= 2U) {
+      counts.push_back(n);
+   }
+   counts.push_back(max_threads);
+   return counts;
+}
+
+std::vector<std::unique_ptr<HasherBackend>> available_backends() {
+   std::vector<std::unique_ptr<HasherBackend>> backends;
+   backends.push_back(std::make_unique<CpuHasherBackend>());
+   return backends;
+}
+
+std::unique_ptr<HasherBackend> make_backend(std::string_view name) {
+   for (auto& backend : available_backends()) {
+      if (backend->name() == name) return std::move(backend);
+   }
+   return nullptr;
+}
+
+HashrateRun run_hashrate(const HasherBackend& backend, std::size_t threads,
+                         std::chrono::milliseconds duration,
+                         util::RaplEnergyMeter* energy) {
+   if (threads == 0U) {
+      throw std::invalid_argument("run_hashrate: zero threads");
+   }
+
+   std::vector<PreparedWork> work;
+   work.reserve(threads);
+   for (std::size_t i = 0; i < threads; ++i) {
+      work.push_back(benchmark_prepared_work(i));
+   }
+
+   std::vector<AbortFlag> aborts(threads);
+   std::vector<std::uint64_t> hashes(threads, 0U);
+
+   if (energy != nullptr) (void)energy->joules_since_last();
+   const auto start = std::chrono::steady_clock::now();
+
+   {
+      std::vector<std::jthread> workers;
+      workers.reserve(threads);
+      for (std::size_t i = 0; i < threads; ++i) {
+         workers.emplace_back([&, i]() {
+            scan_until_stopped(backend, work[i], aborts[i], hashes[i]);
+         });
+      }
+
+      std::this_thread::sleep_for(duration);
+      for (auto& abort : aborts) {
+         abort.request_stop();
+      }
+   }
+
+   const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+   HashrateRun run{};
+   run.backend = std::string(backend.name());
+   run.threads = threads;
+   for (const auto count : hashes) {
+      run.hashes += count;
+   }
+   run.seconds = elapsed.count();
+   run.hash_rate_hps =
+      run.seconds > 0.0 ? static_cast<double>(run.hashes) / run.seconds : 0.0;
+
+   if (energy != nullptr && run.hashes != 0U) {
+      if (const auto joules = energy->joules_since_last()) {
+         run.joules_per_hash = *joules / static_cast<double>(run.hashes);
+      }
+   }
+
+   return run;
+}
+
+std::vector<HashrateRun> run_hashrate_suite(std::chrono::milliseconds duration,
+                                            std::size_t hardware_threads) {
+   auto energy = util::RaplEnergyMeter::open();
+   util::RaplEnergyMeter* meter = energy ? &*energy : nullptr;
+
+   std::vector<HashrateRun> runs;
+   for (const auto& backend : available_backends()) {
+      double one_thread_hps = 0.0;
+
+      for (const std::size_t threads :
+           benchmark_thread_counts(hardware_threads)) {
+         HashrateRun run = run_hashrate(*backend, threads, duration, meter);
+         if (threads == 1U) one_thread_hps = run.hash_rate_hps;
+
+         if (one_thread_hps > 0.0) {
+            run.scaling_efficiency =
+               run.hash_rate_hps /
+               (static_cast<double>(threads) * one_thread_hps);
+         }
+         runs.push_back(std::move(run));
+      }
+   }
+
+   return runs;
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,76 @@
+// src/mining_job/hashrate_benchmark.hpp
+
+#ifndef CPU_MINER_MINING_JOB_HASHRATE_BENCHMARK_HPP
+#define CPU_MINER_MINING_JOB_HASHRATE_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mining_job/backend.hpp"
+#include "mining_job/work_state.hpp"
+#include "util/rapl.hpp"
+
+/*******************************************************************************
+Purpose:
+  Offline hashrate measurement for sizing a machine without a pool: every
+  available backend at a range of thread counts, each for a fixed time, on
+  a real ckpool job embedded here.
+
+Scope:
+  - H/s per backend and thread count
+  - scaling efficiency against the same backend on one thread
+  - J/hash when RAPL package energy is readable
+
+Requirements:
+  - each thread scans its own extranonce2, as the miner's workers would
+  - targets that never match, so share handling does not skew the rate
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct HashrateRun {
+   std::string backend;
+   std::size_t threads{};
+   std::uint64_t hashes{};
+   double seconds{};
+   double hash_rate_hps{};
+   // hash_rate_hps / (threads * one-thread rate); 1.0 is perfect scaling.
+   double scaling_efficiency{};
+   std::optional<double> joules_per_hash;
+};
+
+// The accepted ckpool job (job 69b23e1000005c34) prepared at the given
+// extranonce2.
+[[nodiscard]] PreparedWork
+benchmark_prepared_work(std::uint64_t extranonce2_counter = 0U);
+
+// 1, 2, 4, ... up to and always including hardware_threads.
+[[nodiscard]] std::vector<std::size_t>
+benchmark_thread_counts(std::size_t hardware_threads);
+
+[[nodiscard]] std::vector<std::unique_ptr<HasherBackend>>
+available_backends();
+
+// The available backend with this name(), or nullptr.
+[[nodiscard]] std::unique_ptr<HasherBackend>
+make_backend(std::string_view name);
+
+// scaling_efficiency is left at 0; run_hashrate_suite fills it in.
+[[nodiscard]] HashrateRun run_hashrate(const HasherBackend& backend,
+                                       std::size_t threads,
+                                       std::chrono::milliseconds duration,
+                                       util::RaplEnergyMeter* energy);
+
+[[nodiscard]] std::vector<HashrateRun>
+run_hashrate_suite(std::chrono::milliseconds duration,
+                   std::size_t hardware_threads);
+
+} // namespace cpu_miner
+
+#endif
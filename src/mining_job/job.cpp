@@ -1,3 +1,36 @@
 // src/mining_job/job.cpp
+
+#include <stdexcept>
+#include <string>
+
 #include "mining_job/job.hpp"
+#include "mining_job/target.hpp"
+#include "util/endian.hpp"
+#include "util/hex.hpp"
+
+namespace cpu_miner {
+
+DecodedJob decode_job(const MiningJob& job) {
+   DecodedJob decoded;
+
+   decoded.version = u32_from_hex_be(job.version);
+   decoded.nbits = u32_from_hex_be(job.nbits);
+   decoded.ntime = u32_from_hex_be(job.ntime);
+
+   decoded.prevhash_sha_input = hex_to_array_32(job.prevhash);
+   cpu_miner::util::byteswap_each_u32(decoded.prevhash_sha_input);
+
+   decoded.coinb1 = hex_to_bytes(job.coinb1);
+   decoded.coinb2 = hex_to_bytes(job.coinb2);
+
+   decoded.merkle_branch.reserve(job.merkle_branch.size());
+   for (const auto& branch_hex : job.merkle_branch) {
+      decoded.merkle_branch.push_back(hex_to_array_32(branch_hex));
+   }
+
+   decoded.network_target = expand_compact_target(decoded.nbits);
+
+   return decoded;
+}
 
+} // namespace cpu_miner
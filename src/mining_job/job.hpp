@@ -2,13 +2,18 @@
 #ifndef CPU_MINER_MINING_JOB_JOB_HPP
 #define CPU_MINER_MINING_JOB_JOB_HPP
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+#include "util/uint256.hpp"
+
 namespace cpu_miner {
 
+using HashBytes = std::array<std::uint8_t, 32>;
+
 struct SubscriptionContext {
    std::string extranonce1;
    std::size_t extranonce2_size{};
@@ -26,6 +31,21 @@ struct MiningJob {
    bool clean_jobs{};
 };
 
+// Binary view of a MiningJob. Built once when the notify arrives so that work
+// preparation never re-parses the hex fields.
+struct DecodedJob {
+   std::uint32_t version{};
+   std::uint32_t nbits{};
+   std::uint32_t ntime{};
+   HashBytes prevhash_sha_input{};
+   std::vector<std::uint8_t> coinb1;
+   std::vector<std::uint8_t> coinb2;
+   std::vector<HashBytes> merkle_branch;
+   u256::uint256 network_target{};
+};
+
+[[nodiscard]] DecodedJob decode_job(const MiningJob& job);
+
 }  // namespace cpu_miner
 
 #endif
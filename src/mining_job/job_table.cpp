@@ -0,0 +1,51 @@
+// src/mining_job/job_table.cpp
+
+#include <algorithm>
+#include <iterator>
+
+#include "mining_job/job_table.hpp"
+
+namespace cpu_miner {
+
+JobTable::JobTable(std::size_t capacity)
+   : capacity_(std::max<std::size_t>(capacity, 1U)) {}
+
+std::deque<JobTable::Job>::iterator JobTable::find(std::string_view job_id) {
+   return std::ranges::find(jobs_, job_id, &Job::id);
+}
+
+void JobTable::note_job(std::string_view job_id, bool clean_jobs) {
+   if (clean_jobs) {
+      jobs_.clear();
+   } else if (const auto it = find(job_id); it != jobs_.end()) {
+      // Same job: its shares are still duplicates if found again.
+      std::rotate(it, std::next(it), jobs_.end());
+      return;
+   }
+
+   jobs_.push_back(Job{.id = std::string(job_id), .seen = SeenShareSet{}});
+   while (jobs_.size() > capacity_) {
+      jobs_.pop_front();
+   }
+}
+
+void JobTable::clear() noexcept { jobs_.clear(); }
+
+bool JobTable::contains(std::string_view job_id) const noexcept {
+   return std::ranges::find(jobs_, job_id, &Job::id) != jobs_.end();
+}
+
+std::size_t JobTable::size() const noexcept { return jobs_.size(); }
+
+std::size_t JobTable::capacity() const noexcept { return capacity_; }
+
+JobTable::ShareRecord JobTable::note_share(std::string_view job_id,
+                                           std::uint64_t fingerprint) {
+   const auto it = find(job_id);
+   if (it == jobs_.end()) return ShareRecord::unknown_job;
+
+   return it->seen.insert(fingerprint) ? ShareRecord::recorded
+                                       : ShareRecord::duplicate;
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,80 @@
+// src/mining_job/job_table.hpp
+
+#ifndef CPU_MINER_MINING_JOB_JOB_TABLE_HPP
+#define CPU_MINER_MINING_JOB_JOB_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+#include "mining_job/seen_shares.hpp"
+
+/*******************************************************************************
+Purpose:
+  Track which of one pool's jobs still take shares. A notify with
+  clean_jobs=false adds a job without retiring the earlier ones, so shares
+  found on them stay submittable and a worker need not drop its range.
+
+Scope:
+  - job ids since the last clean_jobs=true notify, newest last
+  - at most `capacity` of them; the oldest goes first
+  - per job, the fingerprints of shares already submitted on it, so a
+    duplicate is dropped instead of sent
+
+Requirements:
+  - clean_jobs=true retires every earlier job
+  - re-noting a held job id (a republish, a difficulty change) makes it the
+    newest rather than adding a second entry
+
+Do not:
+  - assume the pool keeps more jobs than `capacity`; a share for a job that
+    fell out of the table is discarded, not submitted
+
+Notes:
+  - not thread-safe; the owner guards it with the lock it already holds for
+    the pool's latest work
+  - a new extranonce1 invalidates every job; the owner calls clear()
+*******************************************************************************/
+
+namespace cpu_miner {
+
+class JobTable {
+ public:
+   static constexpr std::size_t default_capacity = 8U;
+
+   explicit JobTable(std::size_t capacity = default_capacity);
+
+   void note_job(std::string_view job_id, bool clean_jobs);
+   void clear() noexcept;
+
+   [[nodiscard]] bool contains(std::string_view job_id) const noexcept;
+   [[nodiscard]] std::size_t size() const noexcept;
+   [[nodiscard]] std::size_t capacity() const noexcept;
+
+   enum class ShareRecord {
+      recorded,
+      duplicate,
+      unknown_job,
+   };
+
+   // Records a share (see share_fingerprint) on a held job.
+   [[nodiscard]] ShareRecord note_share(std::string_view job_id,
+                                        std::uint64_t fingerprint);
+
+ private:
+   struct Job {
+      std::string id;
+      SeenShareSet seen;
+   };
+
+   [[nodiscard]] std::deque<Job>::iterator find(std::string_view job_id);
+
+   std::size_t capacity_;
+   std::deque<Job> jobs_;
+};
+
+} // namespace cpu_miner
+
+#endif
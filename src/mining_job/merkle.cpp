@@ -3,7 +3,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-#include <stdexcept>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -12,30 +12,24 @@
 #include "util/hex.hpp"
 
 namespace cpu_miner {
-namespace {
 
-HashBytes to_hash_bytes(const std::vector<std::uint8_t>& bytes) {
-   if (bytes.size() != 32U) {
-      throw std::invalid_argument("expected 32-byte hash");
-   }
+HashBytes merkle_fold(HashBytes current_hash,
+                      const std::vector<std::string>& merkle_branch) {
+   std::vector<HashBytes> branches;
+   branches.reserve(merkle_branch.size());
 
-   HashBytes out{};
-   for (std::size_t i = 0; i < out.size(); ++i) {
-      out[i] = bytes[i];
+   for (const auto& branch_hex : merkle_branch) {
+      branches.push_back(hex_to_array_32(branch_hex));
    }
-   return out;
-}
 
-} // namespace
+   return merkle_fold(current_hash, std::span<const HashBytes>(branches));
+}
 
 HashBytes merkle_fold(HashBytes current_hash,
-                      const std::vector<std::string>& merkle_branch) {
+                      std::span<const HashBytes> merkle_branch) {
    std::array<std::uint8_t, 64> buffer{};
 
-   for (const auto& branch_hex : merkle_branch) {
-      const auto branch_vec = hex_to_bytes(branch_hex);
-      const HashBytes branch = to_hash_bytes(branch_vec);
-
+   for (const auto& branch : merkle_branch) {
       for (std::size_t i = 0; i < 32U; ++i) {
          buffer[i] = current_hash[i];
          buffer[32U + i] = branch[i];
@@ -54,5 +48,11 @@ std::string merkle_root_raw_hex(HashBytes coinbase_hash,
    return bytes_to_hex(root);
 }
 
+std::string merkle_root_raw_hex(HashBytes coinbase_hash,
+                                std::span<const HashBytes> merkle_branch) {
+   const HashBytes root = merkle_fold(coinbase_hash, merkle_branch);
+   return bytes_to_hex(root);
+}
+
 } // namespace cpu_miner
 
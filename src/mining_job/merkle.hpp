@@ -5,6 +5,7 @@
 
 #include <array>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -14,9 +15,13 @@ using HashBytes = std::array<std::uint8_t, 32>;
 
 HashBytes merkle_fold(HashBytes current_hash,
                       const std::vector<std::string>& merkle_branch);
+HashBytes merkle_fold(HashBytes current_hash,
+                      std::span<const HashBytes> merkle_branch);
 
 std::string merkle_root_raw_hex(HashBytes coinbase_hash,
                             const std::vector<std::string>& merkle_branch);
+std::string merkle_root_raw_hex(HashBytes coinbase_hash,
+                                std::span<const HashBytes> merkle_branch);
 
 } // namespace cpu_miner
 
@@ -1,35 +1,71 @@
 // src/mining_job/scan.cpp
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 
 #include "mining_job/header.hpp"
 #include "mining_job/scan.hpp"
 #include "mining_job/target.hpp"
 #include "sha256/sha256.hpp"
+#include "util/cycles.hpp"
 
 namespace cpu_miner {
 namespace {
 
-[[nodiscard]] bool generation_changed(const ScanControl& control,
-                                      std::uint64_t hashes_done) {
+[[nodiscard]] bool generation_changed(const ScanControl& control) {
    if (control.work_generation == nullptr) return false;
-   if (control.check_interval == 0U) return false;
-   if ((hashes_done % control.check_interval) != 0U) return false;
 
    return control.work_generation->load(std::memory_order_acquire) !=
           control.expected_generation;
 }
 
+[[nodiscard]] std::optional<ScanStopReason>
+abort_reason(const ScanControl& control) {
+   if (control.abort != nullptr) {
+      const std::uint32_t word = control.abort->load();
+      if ((word & AbortFlag::stop) != 0U) return ScanStopReason::stop_requested;
+      if ((word & AbortFlag::stale) != 0U) return ScanStopReason::stale;
+      return std::nullopt;
+   }
+
+   if (control.stop_token.stop_requested()) {
+      return ScanStopReason::stop_requested;
+   }
+   if (generation_changed(control)) return ScanStopReason::stale;
+   return std::nullopt;
+}
+
+[[nodiscard]] std::uint64_t power_of_two_floor(std::uint64_t n) {
+   return std::bit_floor(std::max<std::uint64_t>(n, 1U));
+}
+
 } // namespace
 
+std::uint64_t next_check_hashes(std::uint64_t current,
+                                std::chrono::nanoseconds block_time,
+                                const ScanControl& control) noexcept {
+   const std::uint64_t lo = power_of_two_floor(control.min_check_hashes);
+   const std::uint64_t hi =
+      std::max(lo, power_of_two_floor(control.max_check_hashes));
+
+   std::uint64_t next = std::clamp(power_of_two_floor(current), lo, hi);
+   if (block_time * 2 < control.check_budget && next < hi) {
+      next <<= 1U;
+   } else if (block_time > control.check_budget * 2 && next > lo) {
+      next >>= 1U;
+   }
+   return next;
+}
+
 ScanResult scan_nonce_range(WorkState& work,
                             const u256::uint256& network_target,
                             const u256::uint256& share_target,
                             std::uint64_t nonce_begin, std::uint64_t nonce_end,
-                            std::uint64_t /*progress_interval*/,
                             const ScanControl& control,
                             ShareFoundCallback on_share_found) {
    if (nonce_begin > nonce_end) {
@@ -43,54 +79,89 @@ ScanResult scan_nonce_range(WorkState& work,
 
    ScanResult result{};
 
+   u256::uint256 current_share_target = share_target;
+   std::uint64_t share_target_version = 0U;
+   if (control.share_target != nullptr) {
+      share_target_version = control.share_target->version();
+      current_share_target = control.share_target->load();
+   }
+
    if (control.progress_hashes_done != nullptr) {
       control.progress_hashes_done->store(0U, std::memory_order_relaxed);
    }
 
    const auto start_time = std::chrono::steady_clock::now();
 
-   for (std::uint64_t scan_nonce = nonce_begin; scan_nonce <= nonce_end;
-        ++scan_nonce) {
-      if (control.stop_token.stop_requested()) {
-         result.stop_reason = ScanStopReason::stop_requested;
-         break;
-      }
+   // The first block is a single hash so first_hash_at is exact; after that
+   // blocks start at the minimum and grow to fit the check budget.
+   std::uint64_t block = 1U;
+   bool first_block = true;
+   auto block_start = start_time;
+   util::CycleLap lap;
 
-      const auto nonce = static_cast<std::uint32_t>(scan_nonce);
-      work.nonce = nonce;
+   for (std::uint64_t scan_nonce = nonce_begin; scan_nonce <= nonce_end;) {
+      const std::uint64_t block_last =
+         std::min(nonce_end, scan_nonce + block - 1U);
 
-      set_header_nonce(work.header_template, nonce);
+      for (; scan_nonce <= block_last; ++scan_nonce) {
+         const auto nonce = static_cast<std::uint32_t>(scan_nonce);
+         work.nonce = nonce;
 
-      const auto hash_words = hash_header_template(work.header_template);
-      const auto hash_bytes = sha256::digest_words_to_bytes_be(hash_words);
+         set_header_nonce(work.header_template, nonce);
 
-      ++result.hashes_done;
+         const auto hash_words = hash_header_template(work.header_template);
+         const auto hash_bytes = sha256::digest_words_to_bytes_be(hash_words);
+         lap.mark(util::CycleStage::hash);
 
-      if (control.progress_hashes_done != nullptr &&
-          (control.check_interval == 0U ||
-           (result.hashes_done % control.check_interval) == 0U)) {
+         ++result.hashes_done;
+
+         const bool meets_network =
+            hash_meets_target(hash_bytes, network_target);
+         const bool meets_share =
+            hash_meets_target(hash_bytes, current_share_target);
+         lap.mark(util::CycleStage::target_compare);
+
+         if (meets_network) {
+            ++result.blocks_found;
+         }
+
+         if (meets_share) {
+            ++result.shares_found;
+            if (on_share_found) {
+               on_share_found(nonce, hash_bytes, meets_network);
+            }
+            lap.mark(util::CycleStage::share_callback);
+         }
+      }
+
+      const auto block_end = std::chrono::steady_clock::now();
+      if (first_block) {
+         result.first_hash_at = block_end;
+      }
+
+      if (control.progress_hashes_done != nullptr) {
          control.progress_hashes_done->store(result.hashes_done,
                                              std::memory_order_relaxed);
       }
 
-      if (generation_changed(control, result.hashes_done)) {
-         result.stop_reason = ScanStopReason::stale;
+      const auto reason = abort_reason(control);
+      lap.mark(util::CycleStage::stale_check);
+      if (reason) {
+         result.stop_reason = *reason;
          break;
       }
 
-      const bool meets_network = hash_meets_target(hash_bytes, network_target);
-      const bool meets_share = hash_meets_target(hash_bytes, share_target);
-
-      if (meets_network) {
-         ++result.blocks_found;
+      if (control.share_target != nullptr &&
+          control.share_target->version() != share_target_version) {
+         share_target_version = control.share_target->version();
+         current_share_target = control.share_target->load();
       }
 
-      if (meets_share) {
-         ++result.shares_found;
-         if (on_share_found) {
-            on_share_found(nonce, hash_bytes, meets_network);
-         }
-      }
+      block = first_block
+                 ? power_of_two_floor(control.min_check_hashes)
+                 : next_check_hashes(block, block_end - block_start, control);
+      first_block = false;
+      block_start = block_end;
    }
 
    if (control.progress_hashes_done != nullptr) {
@@ -111,4 +182,3 @@ ScanResult scan_nonce_range(WorkState& work,
 }
 
 } // namespace cpu_miner
-
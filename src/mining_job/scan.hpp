@@ -4,10 +4,13 @@
 #define CPU_MINER_MINING_JOB_SCAN_HPP
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <stop_token>
 
+#include "mining_job/abort_flag.hpp"
+#include "mining_job/share_target_slot.hpp"
 #include "mining_job/work_state.hpp"
 #include "util/uint256.hpp"
 
@@ -27,12 +30,29 @@ struct ShareCandidate {
    std::uint64_t generation{};
 };
 
+// The scan hashes in blocks and checks for abort and publishes progress only
+// between blocks. Block sizes are powers of two in
+// [min_check_hashes, max_check_hashes], resized from the measured hash rate
+// so one block takes about check_budget.
+//
+// With `abort` set, its word is the only thing polled and stop_token and
+// work_generation are ignored; the owner sets it on stop and whenever the
+// worker must switch work. Without it, the scan polls stop_token and
+// work_generation.
+//
+// With `share_target` set, the scan takes its share target from the slot
+// instead of its share_target argument, and reloads it at the first block
+// boundary after a store.
 struct ScanControl {
    std::stop_token stop_token;
    const std::atomic<std::uint64_t>* work_generation{};
    std::uint64_t expected_generation{};
-   std::uint64_t check_interval{16'384U};
+   const AbortFlag* abort{};
+   std::chrono::nanoseconds check_budget{std::chrono::microseconds(100)};
+   std::uint64_t min_check_hashes{64U};
+   std::uint64_t max_check_hashes{1U << 20};
    std::atomic<std::uint64_t>* progress_hashes_done{};
+   const ShareTargetSlot* share_target{};
 };
 
 struct ScanResult {
@@ -41,9 +61,18 @@ struct ScanResult {
    std::uint64_t blocks_found{};
    double elapsed_seconds{};
    double hash_rate_hps{};
+   // When the first hash of the range completed; unset if none did.
+   std::chrono::steady_clock::time_point first_hash_at{};
    ScanStopReason stop_reason{ScanStopReason::exhausted};
 };
 
+// Block size after one that hashed `current` nonces in `block_time`: doubled
+// while under half the budget, halved while over twice the budget, otherwise
+// unchanged. Always a power of two within the control's bounds.
+[[nodiscard]] std::uint64_t
+next_check_hashes(std::uint64_t current, std::chrono::nanoseconds block_time,
+                  const ScanControl& control) noexcept;
+
 using ShareFoundCallback =
    std::function<void(std::uint32_t nonce, const sha256::DigestBytes& hash,
                       bool is_block_candidate)>;
@@ -51,8 +80,8 @@ using ShareFoundCallback =
 [[nodiscard]] ScanResult
 scan_nonce_range(WorkState& work, const u256::uint256& network_target,
                  const u256::uint256& share_target, std::uint64_t nonce_begin,
-                 std::uint64_t nonce_end, std::uint64_t progress_interval,
-                 const ScanControl& control, ShareFoundCallback on_share_found);
+                 std::uint64_t nonce_end, const ScanControl& control,
+                 ShareFoundCallback on_share_found);
 
 } // namespace cpu_miner
 
@@ -0,0 +1,92 @@
+// src/mining_job/seen_shares.cpp
+
+#include <algorithm>
+#include <bit>
+
+#include "mining_job/seen_shares.hpp"
+
+namespace cpu_miner {
+namespace {
+
+constexpr std::uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t kFnvPrime = 0x100000001b3ULL;
+
+// splitmix64 finaliser: spreads every input bit over the whole word, so the
+// low bits alone make a good table index.
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+   x ^= x >> 30U;
+   x *= 0xbf58476d1ce4e5b9ULL;
+   x ^= x >> 27U;
+   x *= 0x94d049bb133111ebULL;
+   x ^= x >> 31U;
+   return x;
+}
+
+[[nodiscard]] constexpr std::uint64_t key_of(std::uint64_t fingerprint) {
+   return fingerprint == 0U ? 1U : fingerprint;
+}
+
+} // namespace
+
+std::uint64_t share_fingerprint(const ShareSubmission& share) noexcept {
+   std::uint64_t h = kFnvOffset;
+   for (const char c : share.job_id) {
+      h ^= static_cast<unsigned char>(c);
+      h *= kFnvPrime;
+   }
+
+   h = mix(h ^ share.extranonce2_counter);
+   h = mix(h ^ share.ntime);
+   return mix(h ^ share.nonce);
+}
+
+SeenShareSet::SeenShareSet(std::size_t initial_capacity)
+   : slots_(std::bit_ceil(std::max<std::size_t>(initial_capacity, 2U)), 0U) {}
+
+std::size_t SeenShareSet::find_slot(std::uint64_t key) const noexcept {
+   const std::size_t mask = slots_.size() - 1U;
+   std::size_t i = static_cast<std::size_t>(key) & mask;
+   while (slots_[i] != 0U && slots_[i] != key) {
+      i = (i + 1U) & mask;
+   }
+   return i;
+}
+
+bool SeenShareSet::insert(std::uint64_t fingerprint) {
+   const std::uint64_t key = key_of(fingerprint);
+
+   std::size_t slot = find_slot(key);
+   if (slots_[slot] == key) return false;
+
+   if ((size_ + 1U) * 2U > slots_.size()) {
+      grow();
+      slot = find_slot(key);
+   }
+
+   slots_[slot] = key;
+   ++size_;
+   return true;
+}
+
+bool SeenShareSet::contains(std::uint64_t fingerprint) const noexcept {
+   const std::uint64_t key = key_of(fingerprint);
+   return slots_[find_slot(key)] == key;
+}
+
+void SeenShareSet::clear() noexcept {
+   std::ranges::fill(slots_, 0U);
+   size_ = 0U;
+}
+
+std::size_t SeenShareSet::size() const noexcept { return size_; }
+
+void SeenShareSet::grow() {
+   std::vector<std::uint64_t> old(slots_.size() * 2U, 0U);
+   old.swap(slots_);
+
+   for (const std::uint64_t key : old) {
+      if (key != 0U) slots_[find_slot(key)] = key;
+   }
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,59 @@
+// src/mining_job/seen_shares.hpp
+
+#ifndef CPU_MINER_MINING_JOB_SEEN_SHARES_HPP
+#define CPU_MINER_MINING_JOB_SEEN_SHARES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mining_job/share.hpp"
+
+/*******************************************************************************
+Purpose:
+  Catch a share submitted twice before it costs a pool round trip and a
+  duplicate-share rejection. Reconnects, republished work and extranonce2
+  reuse can all find the same (job_id, extranonce2, ntime, nonce) again.
+
+Scope:
+  - share_fingerprint(): 64-bit hash of the share tuple
+  - SeenShareSet: open-addressing set of fingerprints, one per job (see
+    JobTable), dropped with the job
+
+Requirements:
+  - linear probing over a power-of-two table of 64-bit slots, at most half
+    full; no per-entry allocation
+  - 0 marks an empty slot; a fingerprint of 0 is stored as 1
+
+Notes:
+  - two different shares with the same fingerprint would drop the second;
+    at a few shares per job the odds are about n^2 / 2^65
+*******************************************************************************/
+
+namespace cpu_miner {
+
+[[nodiscard]] std::uint64_t
+share_fingerprint(const ShareSubmission& share) noexcept;
+
+class SeenShareSet {
+ public:
+   explicit SeenShareSet(std::size_t initial_capacity = 16U);
+
+   // False if `fingerprint` was already inserted.
+   [[nodiscard]] bool insert(std::uint64_t fingerprint);
+   [[nodiscard]] bool contains(std::uint64_t fingerprint) const noexcept;
+
+   void clear() noexcept;
+   [[nodiscard]] std::size_t size() const noexcept;
+
+ private:
+   [[nodiscard]] std::size_t find_slot(std::uint64_t key) const noexcept;
+   void grow();
+
+   std::vector<std::uint64_t> slots_;
+   std::size_t size_{0};
+};
+
+} // namespace cpu_miner
+
+#endif
@@ -3,16 +3,21 @@
 #ifndef CPU_MINER_MINING_JOB_SHARE_HPP
 #define CPU_MINER_MINING_JOB_SHARE_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
 namespace cpu_miner {
 
+// mining.submit's hex fields are rendered from the binary ones by
+// SubmitTemplate, so building a share copies only the job id.
 struct ShareSubmission {
    std::string job_id;
-   std::string extranonce2_hex;
-   std::string ntime_hex;
-   std::string nonce_hex;
+   std::uint64_t extranonce2_counter{};
+   // Bytes of extranonce2 on the wire.
+   std::size_t extranonce2_size{};
+   std::uint32_t ntime{};
+   std::uint32_t nonce{};
 };
 
 } // namespace cpu_miner
@@ -0,0 +1,108 @@
+// src/mining_job/share_check.cpp
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "mining_job/share_check.hpp"
+#include "mining_job/target.hpp"
+#include "mining_job/work_state.hpp"
+#include "util/hex.hpp"
+
+namespace cpu_miner {
+namespace {
+
+constexpr std::uint64_t kMaxNtimeRoll = 7000U;
+
+// Big-endian hex of at most eight bytes; nullopt unless exactly `size_bytes`
+// bytes of valid hex.
+std::optional<std::uint64_t> be_hex_value(std::string_view hex,
+                                          std::size_t size_bytes) {
+   std::array<std::uint8_t, 8> bytes{};
+   if (size_bytes > bytes.size() || hex.size() != size_bytes * 2U) {
+      return std::nullopt;
+   }
+
+   if (!hex_decode_into(hex, std::span<std::uint8_t>(bytes.data(),
+                                                     size_bytes))) {
+      return std::nullopt;
+   }
+
+   std::uint64_t value = 0U;
+   for (std::size_t i = 0; i < size_bytes; ++i) {
+      value = (value << 8U) | bytes[i];
+   }
+   return value;
+}
+
+} // namespace
+
+ShareCheck check_share(const MiningJob& job, const DecodedJob& decoded,
+                       const SubscriptionContext& subscription,
+                       std::string_view extranonce2_hex,
+                       std::string_view ntime_hex, std::string_view nonce_hex,
+                       const u256::uint256& share_target) {
+   ShareCheck check{};
+
+   const auto extranonce2 =
+      be_hex_value(extranonce2_hex, subscription.extranonce2_size);
+   if (!extranonce2) {
+      check.verdict = ShareVerdict::invalid_extranonce2;
+      return check;
+   }
+
+   const auto ntime = be_hex_value(ntime_hex, 4U);
+   if (!ntime) {
+      check.verdict = ShareVerdict::invalid_ntime;
+      return check;
+   }
+   if (*ntime < decoded.ntime || *ntime > decoded.ntime + kMaxNtimeRoll) {
+      check.verdict = ShareVerdict::ntime_out_of_range;
+      return check;
+   }
+
+   const auto nonce = be_hex_value(nonce_hex, 4U);
+   if (!nonce) {
+      check.verdict = ShareVerdict::invalid_nonce;
+      return check;
+   }
+
+   const DecodedJob* source = &decoded;
+   DecodedJob rolled;
+   if (*ntime != decoded.ntime) {
+      rolled = decoded;
+      rolled.ntime = static_cast<std::uint32_t>(*ntime);
+      source = &rolled;
+   }
+
+   const auto prepared = prepare_work(job, *source, subscription, *extranonce2);
+   check.hash =
+      hash_prepared_work_nonce(prepared, static_cast<std::uint32_t>(*nonce));
+   check.block_candidate = hash_meets_target(check.hash, decoded.network_target);
+
+   if (!hash_meets_target(check.hash, share_target)) {
+      check.verdict = ShareVerdict::above_target;
+   }
+
+   return check;
+}
+
+std::string_view to_string(ShareVerdict verdict) noexcept {
+   switch (verdict) {
+   case ShareVerdict::accepted:
+      return "accepted";
+   case ShareVerdict::invalid_extranonce2:
+      return "invalid extranonce2";
+   case ShareVerdict::invalid_ntime:
+      return "invalid ntime";
+   case ShareVerdict::ntime_out_of_range:
+      return "ntime out of range";
+   case ShareVerdict::invalid_nonce:
+      return "invalid nonce";
+   case ShareVerdict::above_target:
+      return "above target";
+   }
+   return "unknown";
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,50 @@
+// src/mining_job/share_check.hpp
+
+#ifndef CPU_MINER_MINING_JOB_SHARE_CHECK_HPP
+#define CPU_MINER_MINING_JOB_SHARE_CHECK_HPP
+
+#include <string_view>
+
+#include "mining_job/job.hpp"
+#include "sha256/sha256.hpp"
+#include "util/uint256.hpp"
+
+/*******************************************************************************
+Purpose:
+  Pool-side validation of a submitted share (spec sections 9 and 11),
+  rebuilding the header with the same prepare_work path the miner uses.
+
+Requirements:
+  - field checks before hashing: extranonce2 length and hex, ntime hex and
+    range (job_ntime <= ntime <= job_ntime + 7000), nonce hex
+  - no exceptions for malformed submissions; they map to a verdict
+*******************************************************************************/
+
+namespace cpu_miner {
+
+enum class ShareVerdict {
+   accepted,
+   invalid_extranonce2,
+   invalid_ntime,
+   ntime_out_of_range,
+   invalid_nonce,
+   above_target,
+};
+
+struct ShareCheck {
+   ShareVerdict verdict{ShareVerdict::accepted};
+   sha256::DigestBytes hash{};
+   bool block_candidate{};
+};
+
+[[nodiscard]] ShareCheck
+check_share(const MiningJob& job, const DecodedJob& decoded,
+            const SubscriptionContext& subscription,
+            std::string_view extranonce2_hex, std::string_view ntime_hex,
+            std::string_view nonce_hex, const u256::uint256& share_target);
+
+[[nodiscard]] std::string_view to_string(ShareVerdict verdict) noexcept;
+
+} // namespace cpu_miner
+
+#endif
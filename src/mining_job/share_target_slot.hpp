@@ -0,0 +1,58 @@
+// src/mining_job/share_target_slot.hpp
+
+#ifndef CPU_MINER_MINING_JOB_SHARE_TARGET_SLOT_HPP
+#define CPU_MINER_MINING_JOB_SHARE_TARGET_SLOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "util/uint256.hpp"
+
+/*******************************************************************************
+Purpose:
+  The share target a running scan checks against, replaceable without
+  stopping the scan. mining.set_difficulty changes only the share target, so
+  the header, midstate and nonce position the worker has built stay valid.
+
+Requirements:
+  - the polled version sits alone on its cache line, like AbortFlag; the
+    lock and target, touched only after a store, take the next one
+  - a scan polls version() once per check block (see ScanControl) and takes
+    the lock only after a store bumped it
+
+Notes:
+  - a store between a scan's version() and load() is picked up at the next
+    block, since the version then differs again
+*******************************************************************************/
+
+namespace cpu_miner {
+
+class alignas(64) ShareTargetSlot {
+ public:
+   void store(const u256::uint256& target) {
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         target_ = target;
+      }
+      version_.fetch_add(1U, std::memory_order_release);
+   }
+
+   [[nodiscard]] u256::uint256 load() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return target_;
+   }
+
+   [[nodiscard]] std::uint64_t version() const noexcept {
+      return version_.load(std::memory_order_acquire);
+   }
+
+ private:
+   alignas(64) std::atomic<std::uint64_t> version_{0U};
+   alignas(64) mutable std::mutex mutex_;
+   u256::uint256 target_{};
+};
+
+} // namespace cpu_miner
+
+#endif
@@ -0,0 +1,160 @@
+// src/mining_job/switch_latency.cpp
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "mining_job/switch_latency.hpp"
+
+namespace cpu_miner {
+namespace {
+
+// Generations kept open for late worker reports.
+constexpr std::size_t kOpenGenerations = 16U;
+
+[[nodiscard]] double
+micros_between(SwitchLatencyRecorder::clock::time_point from,
+               SwitchLatencyRecorder::clock::time_point to) {
+   const std::chrono::duration<double, std::micro> elapsed = to - from;
+   return std::max(elapsed.count(), 0.0);
+}
+
+[[nodiscard]] double nearest_rank(const std::vector<double>& sorted,
+                                  double fraction) {
+   const auto rank = static_cast<std::size_t>(
+      std::ceil(fraction * static_cast<double>(sorted.size())));
+   return sorted[std::clamp<std::size_t>(rank, 1U, sorted.size()) - 1U];
+}
+
+} // namespace
+
+LatencySummary summarize_latencies(std::vector<double> samples_us) {
+   LatencySummary summary{};
+   if (samples_us.empty()) return summary;
+
+   std::sort(samples_us.begin(), samples_us.end());
+   summary.count = samples_us.size();
+   summary.min_us = samples_us.front();
+   summary.p50_us = nearest_rank(samples_us, 0.50);
+   summary.p90_us = nearest_rank(samples_us, 0.90);
+   summary.p99_us = nearest_rank(samples_us, 0.99);
+   summary.max_us = samples_us.back();
+   return summary;
+}
+
+SwitchLatencyRecorder::SampleRing::SampleRing(std::size_t capacity)
+   : capacity_(capacity) {
+   samples_.reserve(capacity_);
+}
+
+void SwitchLatencyRecorder::SampleRing::push(double sample_us) {
+   if (samples_.size() < capacity_) {
+      samples_.push_back(sample_us);
+      return;
+   }
+
+   samples_[next_] = sample_us;
+   next_ = (next_ + 1U) % capacity_;
+}
+
+LatencySummary SwitchLatencyRecorder::SampleRing::summary() const {
+   return summarize_latencies(samples_);
+}
+
+SwitchLatencyRecorder::SwitchLatencyRecorder(std::size_t worker_count,
+                                             std::size_t sample_capacity)
+   : worker_count_(worker_count)
+   , notify_to_publish_(sample_capacity)
+   , publish_to_adopt_(sample_capacity)
+   , adopt_to_first_hash_(sample_capacity)
+   , notify_to_all_hashing_(sample_capacity) {
+   if (worker_count_ == 0U) {
+      throw std::invalid_argument("SwitchLatencyRecorder: no workers");
+   }
+   if (sample_capacity == 0U) {
+      throw std::invalid_argument("SwitchLatencyRecorder: zero capacity");
+   }
+}
+
+void SwitchLatencyRecorder::note_published(std::uint64_t generation,
+                                           clock::time_point notify_received,
+                                           clock::time_point published) {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   notify_to_publish_.push(micros_between(notify_received, published));
+
+   if (open_.size() == kOpenGenerations) {
+      ++superseded_;
+      open_.pop_front();
+   }
+
+   open_.push_back(OpenGeneration{
+      .generation = generation,
+      .notify_received = notify_received,
+      .published = published,
+      .adopted = std::vector<std::optional<clock::time_point>>(worker_count_),
+      .hashing = std::vector<bool>(worker_count_, false),
+   });
+}
+
+void SwitchLatencyRecorder::note_adopted(std::uint64_t generation,
+                                         std::size_t worker,
+                                         clock::time_point at) {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   OpenGeneration* open = find_open(generation);
+   if (open == nullptr || worker >= worker_count_) return;
+   if (open->adopted[worker]) return;
+
+   open->adopted[worker] = at;
+   publish_to_adopt_.push(micros_between(open->published, at));
+}
+
+void SwitchLatencyRecorder::note_first_hash(std::uint64_t generation,
+                                            std::size_t worker,
+                                            clock::time_point at) {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   OpenGeneration* open = find_open(generation);
+   if (open == nullptr || worker >= worker_count_) return;
+   if (open->hashing[worker] || !open->adopted[worker]) return;
+
+   open->hashing[worker] = true;
+   ++open->workers_hashing;
+   open->last_first_hash = std::max(open->last_first_hash, at);
+   adopt_to_first_hash_.push(micros_between(*open->adopted[worker], at));
+
+   if (open->workers_hashing < worker_count_) return;
+
+   notify_to_all_hashing_.push(
+      micros_between(open->notify_received, open->last_first_hash));
+
+   // Everything older than a completed generation can no longer complete.
+   while (!open_.empty() && open_.front().generation != generation) {
+      ++superseded_;
+      open_.pop_front();
+   }
+   open_.pop_front();
+}
+
+SwitchLatencyReport SwitchLatencyRecorder::report() const {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   return SwitchLatencyReport{
+      .notify_to_publish = notify_to_publish_.summary(),
+      .publish_to_adopt = publish_to_adopt_.summary(),
+      .adopt_to_first_hash = adopt_to_first_hash_.summary(),
+      .notify_to_all_hashing = notify_to_all_hashing_.summary(),
+      .superseded = superseded_,
+   };
+}
+
+SwitchLatencyRecorder::OpenGeneration*
+SwitchLatencyRecorder::find_open(std::uint64_t generation) {
+   for (auto& open : open_) {
+      if (open.generation == generation) return &open;
+   }
+   return nullptr;
+}
+
+} // namespace cpu_miner
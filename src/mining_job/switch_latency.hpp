@@ -0,0 +1,114 @@
+// src/mining_job/switch_latency.hpp
+
+#ifndef CPU_MINER_MINING_JOB_SWITCH_LATENCY_HPP
+#define CPU_MINER_MINING_JOB_SWITCH_LATENCY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Measure the stale-work window: how long after a mining.notify arrives every
+  worker is hashing the new work.
+
+Scope:
+  Four timestamps per work generation:
+  - notify_received: the notify line came off the socket
+  - published: the work was handed to the workers
+  - adopted: a worker picked the generation up
+  - first_hash: that worker finished its first hash on it
+
+Requirements:
+  - thread-safe; workers report at most twice per generation, so a mutex
+    is fine
+  - reports may arrive late (a worker learns its first-hash time when its
+    chunk ends), so a few recent generations stay open
+
+Notes:
+  - A generation replaced before every worker hashed it is counted as
+    superseded and contributes only the samples it already produced.
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct LatencySummary {
+   std::size_t count{};
+   double min_us{};
+   double p50_us{};
+   double p90_us{};
+   double p99_us{};
+   double max_us{};
+};
+
+struct SwitchLatencyReport {
+   LatencySummary notify_to_publish;
+   LatencySummary publish_to_adopt;
+   LatencySummary adopt_to_first_hash;
+   LatencySummary notify_to_all_hashing;
+   std::uint64_t superseded{};
+};
+
+[[nodiscard]] LatencySummary summarize_latencies(std::vector<double> samples_us);
+
+class SwitchLatencyRecorder {
+ public:
+   using clock = std::chrono::steady_clock;
+
+   explicit SwitchLatencyRecorder(std::size_t worker_count,
+                                  std::size_t sample_capacity = 4096U);
+
+   void note_published(std::uint64_t generation,
+                       clock::time_point notify_received,
+                       clock::time_point published);
+   void note_adopted(std::uint64_t generation, std::size_t worker,
+                     clock::time_point at);
+   void note_first_hash(std::uint64_t generation, std::size_t worker,
+                        clock::time_point at);
+
+   [[nodiscard]] SwitchLatencyReport report() const;
+
+ private:
+   // Keeps the most recent `capacity` samples.
+   class SampleRing {
+    public:
+      explicit SampleRing(std::size_t capacity);
+      void push(double sample_us);
+      [[nodiscard]] LatencySummary summary() const;
+
+    private:
+      std::vector<double> samples_;
+      std::size_t capacity_{};
+      std::size_t next_{};
+   };
+
+   struct OpenGeneration {
+      std::uint64_t generation{};
+      clock::time_point notify_received{};
+      clock::time_point published{};
+      std::vector<std::optional<clock::time_point>> adopted;
+      std::vector<bool> hashing;
+      std::size_t workers_hashing{};
+      clock::time_point last_first_hash{};
+   };
+
+   [[nodiscard]] OpenGeneration* find_open(std::uint64_t generation);
+
+   std::size_t worker_count_{};
+   mutable std::mutex mutex_;
+   std::deque<OpenGeneration> open_;
+   std::uint64_t superseded_{};
+
+   SampleRing notify_to_publish_;
+   SampleRing publish_to_adopt_;
+   SampleRing adopt_to_first_hash_;
+   SampleRing notify_to_all_hashing_;
+};
+
+} // namespace cpu_miner
+
+#endif
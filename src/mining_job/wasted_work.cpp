@@ -0,0 +1,147 @@
+// src/mining_job/wasted_work.cpp
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "mining_job/wasted_work.hpp"
+#include "util/sharded_counters.hpp"
+
+namespace cpu_miner {
+namespace {
+
+// Scans held per generation while it is current; at one per 2^32-nonce
+// chunk this covers hours on a single job.
+constexpr std::size_t kUnsettledScans = 64U;
+
+// Hashes of `hashes` done at or after `at`, over a scan from `started` to
+// `finished` at a uniform rate.
+[[nodiscard]] std::uint64_t
+hashes_after(WastedWorkRecorder::clock::time_point at,
+             WastedWorkRecorder::clock::time_point started,
+             WastedWorkRecorder::clock::time_point finished,
+             std::uint64_t hashes) {
+   if (finished <= at) return 0U;
+   if (started >= at) return hashes;
+
+   const std::chrono::duration<double> after = finished - at;
+   const std::chrono::duration<double> whole = finished - started;
+   return static_cast<std::uint64_t>(
+      std::llround(static_cast<double>(hashes) * (after / whole)));
+}
+
+} // namespace
+
+double WastedWorkReport::wasted_fraction() const noexcept {
+   return hashes == 0U ? 0.0
+                       : static_cast<double>(stale_hashes) /
+                            static_cast<double>(hashes);
+}
+
+WastedWorkRecorder::WastedWorkRecorder(std::size_t kept_generations)
+   : kept_generations_(std::max<std::size_t>(kept_generations, 1U)) {}
+
+WastedWorkRecorder::KeptGeneration*
+WastedWorkRecorder::find(std::uint64_t generation) {
+   const auto it = std::ranges::find(kept_, generation, [](const auto& kept) {
+      return kept.waste.generation;
+   });
+   return it == kept_.end() ? nullptr : &*it;
+}
+
+void WastedWorkRecorder::settle(KeptGeneration& kept, const Scan& scan) {
+   const std::uint64_t stale = hashes_after(kept.superseded_at, scan.started,
+                                            scan.finished, scan.hashes);
+   kept.waste.stale_hashes += stale;
+   util::single_writer_add(totals_.stale_hashes, stale);
+   if (kept.waste.superseded_by_clean_jobs) {
+      util::single_writer_add(totals_.clean_jobs_hashes, stale);
+   }
+}
+
+void WastedWorkRecorder::note_published(
+   std::uint64_t generation, std::optional<clock::time_point> superseded_at,
+   bool clean_jobs) {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   for (auto& kept : kept_) {
+      if (!superseded_at || kept.waste.generation >= generation ||
+          kept.waste.superseded) {
+         continue;
+      }
+      kept.waste.superseded = true;
+      kept.waste.superseded_by_clean_jobs = clean_jobs;
+      kept.superseded_at = *superseded_at;
+      for (const auto& scan : kept.unsettled) {
+         settle(kept, scan);
+      }
+      kept.unsettled.clear();
+   }
+
+   if (find(generation) == nullptr) {
+      KeptGeneration kept;
+      kept.waste.generation = generation;
+      kept_.push_back(std::move(kept));
+   }
+
+   // Scans still unsettled on a dropped generation count as useful.
+   while (kept_.size() > kept_generations_) {
+      kept_.pop_front();
+   }
+}
+
+void WastedWorkRecorder::note_scan(std::uint64_t generation,
+                                   std::uint64_t hashes,
+                                   clock::time_point started,
+                                   clock::time_point finished) {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   util::single_writer_add(totals_.hashes, hashes);
+   KeptGeneration* kept = find(generation);
+   if (kept == nullptr) return;
+
+   kept->waste.hashes += hashes;
+   const Scan scan{.started = started, .finished = finished, .hashes = hashes};
+   if (kept->waste.superseded) {
+      settle(*kept, scan);
+      return;
+   }
+
+   if (kept->unsettled.size() == kUnsettledScans) {
+      kept->unsettled.erase(kept->unsettled.begin());
+   }
+   kept->unsettled.push_back(scan);
+}
+
+void WastedWorkRecorder::note_discarded_share(std::uint64_t generation) {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   util::single_writer_add(totals_.discarded_shares, 1U);
+   if (KeptGeneration* kept = find(generation)) {
+      ++kept->waste.discarded_shares;
+   }
+}
+
+WastedWorkReport WastedWorkRecorder::report() const noexcept {
+   return WastedWorkReport{
+      .hashes = totals_.hashes.load(std::memory_order_relaxed),
+      .stale_hashes = totals_.stale_hashes.load(std::memory_order_relaxed),
+      .clean_jobs_hashes =
+         totals_.clean_jobs_hashes.load(std::memory_order_relaxed),
+      .discarded_shares =
+         totals_.discarded_shares.load(std::memory_order_relaxed),
+   };
+}
+
+std::optional<GenerationWaste>
+WastedWorkRecorder::generation_waste(std::uint64_t generation) const {
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   const auto it = std::ranges::find(kept_, generation, [](const auto& kept) {
+      return kept.waste.generation;
+   });
+   if (it == kept_.end()) return std::nullopt;
+   return it->waste;
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,122 @@
+// src/mining_job/wasted_work.hpp
+
+#ifndef CPU_MINER_MINING_JOB_WASTED_WORK_HPP
+#define CPU_MINER_MINING_JOB_WASTED_WORK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Account for hashing that was worthless because newer work already existed:
+  the fraction of all hashes done on a generation after the notify that
+  replaced it arrived. This is the number job-switch latency is optimised
+  against.
+
+Scope:
+  Per work generation:
+  - hashes done
+  - stale hashes: done after the notify that made the worker switch arrived
+    (or, when work changed without a notify, after it was published); work
+    published without retiring the earlier jobs (clean_jobs=false) does not
+    make anything stale
+  - of those, the ones after a clean_jobs notify, whose shares the pool
+    would reject outright
+  - found shares discarded before submission because their work was stale
+
+Requirements:
+  - thread-safe; reports come once per scan chunk, so a mutex is fine
+  - report() takes no lock: run totals are relaxed atomics, written with
+    single_writer_add under the mutex, so a metrics scrape never waits on
+    the worker
+  - a scan may be reported before or after its successor is published;
+    either order gives the same answer
+  - hashes are assumed uniform over a scan, so a scan straddling the
+    notify is split in proportion to time
+
+Notes:
+  - the most recent generations are kept individually; totals cover the
+    whole run
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct GenerationWaste {
+   std::uint64_t generation{};
+   std::uint64_t hashes{};
+   std::uint64_t stale_hashes{};
+   std::uint64_t discarded_shares{};
+   bool superseded{};
+   bool superseded_by_clean_jobs{};
+};
+
+struct WastedWorkReport {
+   std::uint64_t hashes{};
+   std::uint64_t stale_hashes{};
+   std::uint64_t clean_jobs_hashes{};
+   std::uint64_t discarded_shares{};
+
+   // stale_hashes / hashes; 0 before any hashing.
+   [[nodiscard]] double wasted_fraction() const noexcept;
+};
+
+class WastedWorkRecorder {
+ public:
+   using clock = std::chrono::steady_clock;
+
+   explicit WastedWorkRecorder(std::size_t kept_generations = 64U);
+
+   // `generation` replaces all earlier ones from `superseded_at`; with
+   // std::nullopt they stay valid alongside it.
+   void note_published(std::uint64_t generation,
+                       std::optional<clock::time_point> superseded_at,
+                       bool clean_jobs);
+   void note_scan(std::uint64_t generation, std::uint64_t hashes,
+                  clock::time_point started, clock::time_point finished);
+   void note_discarded_share(std::uint64_t generation);
+
+   // Relaxed reads; the fields may be a scan chunk out of step.
+   [[nodiscard]] WastedWorkReport report() const noexcept;
+   // std::nullopt once the generation is no longer kept.
+   [[nodiscard]] std::optional<GenerationWaste>
+   generation_waste(std::uint64_t generation) const;
+
+ private:
+   struct Scan {
+      clock::time_point started{};
+      clock::time_point finished{};
+      std::uint64_t hashes{};
+   };
+
+   struct Totals {
+      std::atomic<std::uint64_t> hashes{0};
+      std::atomic<std::uint64_t> stale_hashes{0};
+      std::atomic<std::uint64_t> clean_jobs_hashes{0};
+      std::atomic<std::uint64_t> discarded_shares{0};
+   };
+
+   struct KeptGeneration {
+      GenerationWaste waste;
+      clock::time_point superseded_at{};
+      // Scans reported before the generation was superseded.
+      std::vector<Scan> unsettled;
+   };
+
+   [[nodiscard]] KeptGeneration* find(std::uint64_t generation);
+   void settle(KeptGeneration& kept, const Scan& scan);
+
+   std::size_t kept_generations_;
+   mutable std::mutex mutex_;
+   std::deque<KeptGeneration> kept_;
+   Totals totals_;
+};
+
+} // namespace cpu_miner
+
+#endif
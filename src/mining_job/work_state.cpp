@@ -1,7 +1,9 @@
 // src/mining_job/work_state.cpp
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -34,6 +36,12 @@ std::string compute_merkle_root_raw_hex(const CoinbaseBuild& coinbase,
    return merkle_root_raw_hex(coinbase.coinbase_hash, job.merkle_branch);
 }
 
+std::string compute_merkle_root_raw_hex(const CoinbaseBuild& coinbase,
+                                        const DecodedJob& job) {
+   return merkle_root_raw_hex(coinbase.coinbase_hash,
+                              std::span<const HashBytes>(job.merkle_branch));
+}
+
 HashBytes prevhash_sha_input_from_job(const MiningJob& job) {
    auto prevhash = hex_to_array_32(job.prevhash);
    cpu_miner::util::byteswap_each_u32(prevhash);
@@ -56,9 +64,25 @@ HeaderTemplate make_work_header_template(const MiningJob& job,
                                    merkle_root_sha_input, ntime, nbits, nonce);
 }
 
+HeaderTemplate make_work_header_template(const DecodedJob& job,
+                                         const HashBytes& prevhash_sha_input,
+                                         const HashBytes& merkle_root_sha_input,
+                                         std::uint32_t nonce) {
+   return make_sha_header_template(job.version, prevhash_sha_input,
+                                   merkle_root_sha_input, job.ntime, job.nbits,
+                                   nonce);
+}
+
 PreparedWork prepare_work(const MiningJob& job,
                           const SubscriptionContext& subscription,
                           std::uint64_t extranonce2_counter) {
+   return prepare_work(job, decode_job(job), subscription,
+                       extranonce2_counter);
+}
+
+PreparedWork prepare_work(const MiningJob& job, const DecodedJob& decoded,
+                          const SubscriptionContext& subscription,
+                          std::uint64_t extranonce2_counter) {
    const auto max_value = max_extranonce2_value(subscription.extranonce2_size);
    if (extranonce2_counter > max_value) {
       throw std::overflow_error("extranonce2 counter exceeds configured size");
@@ -66,6 +90,7 @@ PreparedWork prepare_work(const MiningJob& job,
 
    PreparedWork prepared;
    prepared.job = job;
+   prepared.decoded = decoded;
    prepared.subscription = subscription;
    prepared.extranonce2_counter = extranonce2_counter;
    prepared.extranonce2_hex =
@@ -73,14 +98,14 @@ PreparedWork prepare_work(const MiningJob& job,
                                subscription.extranonce2_size);
 
    prepared.coinbase =
-      build_coinbase(job, subscription, prepared.extranonce2_hex);
-   prepared.merkle_root_raw_hex =
-      compute_merkle_root_raw_hex(prepared.coinbase, job);
-   prepared.prevhash_sha_input = prevhash_sha_input_from_job(job);
+      build_coinbase(decoded, subscription, prepared.extranonce2_hex);
    prepared.merkle_root_sha_input =
-      merkle_root_sha_input_from_hex(prepared.merkle_root_raw_hex);
+      merkle_fold(prepared.coinbase.coinbase_hash,
+                  std::span<const HashBytes>(decoded.merkle_branch));
+   prepared.merkle_root_raw_hex = bytes_to_hex(prepared.merkle_root_sha_input);
+   prepared.prevhash_sha_input = decoded.prevhash_sha_input;
    prepared.header_template =
-      make_work_header_template(job, prepared.prevhash_sha_input,
+      make_work_header_template(decoded, prepared.prevhash_sha_input,
                                 prepared.merkle_root_sha_input, 0U);
 
    return prepared;
@@ -98,6 +123,7 @@ WorkState work_state_from_prepared(const PreparedWork& prepared,
                                    std::uint32_t nonce) {
    WorkState work;
    work.job = prepared.job;
+   work.decoded = prepared.decoded;
    work.subscription = prepared.subscription;
    work.extranonce2_counter = prepared.extranonce2_counter;
    work.nonce = nonce;
@@ -114,9 +140,10 @@ ShareSubmission make_share_submission(const PreparedWork& prepared,
                                       std::uint32_t nonce) {
    return ShareSubmission{
       .job_id = prepared.job.job_id,
-      .extranonce2_hex = prepared.coinbase.extranonce2_hex,
-      .ntime_hex = prepared.job.ntime,
-      .nonce_hex = hex_from_u32_be(nonce),
+      .extranonce2_counter = prepared.extranonce2_counter,
+      .extranonce2_size = prepared.subscription.extranonce2_size,
+      .ntime = prepared.decoded.ntime,
+      .nonce = nonce,
    };
 }
 
@@ -124,6 +151,7 @@ ShareSubmission make_share_submission(const WorkState& work) {
    return make_share_submission(
       PreparedWork{
          .job = work.job,
+         .decoded = work.decoded,
          .subscription = work.subscription,
          .extranonce2_counter = work.extranonce2_counter,
          .extranonce2_hex = work.coinbase.extranonce2_hex,
@@ -149,6 +177,14 @@ WorkState make_work_state(const MiningJob& job,
                                    0U);
 }
 
+WorkState make_work_state(const MiningJob& job, const DecodedJob& decoded,
+                          const SubscriptionContext& subscription,
+                          std::uint64_t extranonce2_counter) {
+   return work_state_from_prepared(prepare_work(job, decoded, subscription,
+                                                extranonce2_counter),
+                                   0U);
+}
+
 void reset_nonce(WorkState& work) noexcept {
    work.nonce = 0U;
    set_header_nonce(work.header_template, work.nonce);
@@ -157,10 +193,23 @@ void reset_nonce(WorkState& work) noexcept {
 void advance_extranonce2(WorkState& work) {
    const auto next_counter = work.extranonce2_counter + 1U;
    const auto prepared =
-      prepare_work(work.job, work.subscription, next_counter);
+      prepare_work(work.job, work.decoded, work.subscription, next_counter);
    work = work_state_from_prepared(prepared, 0U);
 }
 
+std::uint64_t extranonce2_epoch_start(std::uint64_t epoch,
+                                      std::size_t extranonce2_size) noexcept {
+   constexpr unsigned epoch_bits = 16U;
+   const std::size_t bits = std::min<std::size_t>(extranonce2_size, 8U) * 8U;
+
+   if (bits <= epoch_bits) {
+      return bits == 0U ? 0U : epoch & ((std::uint64_t{1} << bits) - 1U);
+   }
+
+   const std::uint64_t tag = epoch & ((std::uint64_t{1} << epoch_bits) - 1U);
+   return tag << (bits - epoch_bits);
+}
+
 WorkState with_nonce(const WorkState& work, std::uint32_t nonce) {
    WorkState copy = work;
    copy.nonce = nonce;
@@ -17,6 +17,7 @@ namespace cpu_miner {
 
 struct PreparedWork {
    MiningJob job;
+   DecodedJob decoded;
    SubscriptionContext subscription;
 
    std::uint64_t extranonce2_counter{};
@@ -32,6 +33,7 @@ struct PreparedWork {
 
 struct WorkState {
    MiningJob job;
+   DecodedJob decoded;
    SubscriptionContext subscription;
 
    std::uint64_t extranonce2_counter{};
@@ -50,6 +52,9 @@ struct WorkState {
 [[nodiscard]] std::string
 compute_merkle_root_raw_hex(const CoinbaseBuild& coinbase,
                             const MiningJob& job);
+[[nodiscard]] std::string
+compute_merkle_root_raw_hex(const CoinbaseBuild& coinbase,
+                            const DecodedJob& job);
 
 [[nodiscard]] HashBytes prevhash_sha_input_from_job(const MiningJob& job);
 
@@ -59,10 +64,17 @@ merkle_root_sha_input_from_hex(std::string_view merkle_root_raw_hex);
 [[nodiscard]] HeaderTemplate make_work_header_template(
    const MiningJob& job, const HashBytes& prevhash_sha_input,
    const HashBytes& merkle_root_sha_input, std::uint32_t nonce);
+[[nodiscard]] HeaderTemplate make_work_header_template(
+   const DecodedJob& job, const HashBytes& prevhash_sha_input,
+   const HashBytes& merkle_root_sha_input, std::uint32_t nonce);
 
 [[nodiscard]] PreparedWork prepare_work(const MiningJob& job,
                                         const SubscriptionContext& subscription,
                                         std::uint64_t extranonce2_counter = 0);
+[[nodiscard]] PreparedWork prepare_work(const MiningJob& job,
+                                        const DecodedJob& decoded,
+                                        const SubscriptionContext& subscription,
+                                        std::uint64_t extranonce2_counter = 0);
 
 [[nodiscard]] sha256::DigestBytes
 hash_prepared_work_nonce(const PreparedWork& prepared, std::uint32_t nonce);
@@ -73,10 +85,22 @@ hash_prepared_work_nonce(const PreparedWork& prepared, std::uint32_t nonce);
 [[nodiscard]] WorkState make_work_state(const MiningJob& job,
                                         const SubscriptionContext& subscription,
                                         std::uint64_t extranonce2_counter = 0);
+[[nodiscard]] WorkState make_work_state(const MiningJob& job,
+                                        const DecodedJob& decoded,
+                                        const SubscriptionContext& subscription,
+                                        std::uint64_t extranonce2_counter = 0);
 
 void reset_nonce(WorkState& work) noexcept;
 void advance_extranonce2(WorkState& work);
 
+// First extranonce2 counter of `epoch`. Republishing the same job under a new
+// epoch puts it in a fresh region of the extranonce2 field (epoch in the top
+// 16 bits), so advance_extranonce2() steps taken in one epoch never revisit
+// space covered by another.
+[[nodiscard]] std::uint64_t
+extranonce2_epoch_start(std::uint64_t epoch,
+                        std::size_t extranonce2_size) noexcept;
+
 [[nodiscard]] WorkState with_nonce(const WorkState& work, std::uint32_t nonce);
 
 [[nodiscard]] ShareSubmission make_share_submission(const WorkState& work);
@@ -0,0 +1,45 @@
+// src/stratum_client/backoff.cpp
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "stratum_client/backoff.hpp"
+
+namespace cpu_miner {
+
+ReconnectBackoff::ReconnectBackoff(BackoffConfig config) : config_(config) {
+   if (config_.initial.count() <= 0 || config_.max < config_.initial) {
+      throw std::invalid_argument(
+         "backoff needs 0 < initial <= max reconnect delay");
+   }
+   if (config_.multiplier < 1U) {
+      throw std::invalid_argument("backoff multiplier must be >= 1");
+   }
+}
+
+std::chrono::milliseconds ReconnectBackoff::next_delay() noexcept {
+   ++attempts_;
+
+   if (current_.count() == 0) {
+      current_ = config_.initial;
+      return current_;
+   }
+
+   // Compare before multiplying so a long outage cannot overflow the count.
+   if (current_ > config_.max / config_.multiplier) {
+      current_ = config_.max;
+   } else {
+      current_ = std::min(current_ * config_.multiplier, config_.max);
+   }
+
+   return current_;
+}
+
+void ReconnectBackoff::reset() noexcept {
+   current_ = std::chrono::milliseconds{0};
+   attempts_ = 0U;
+}
+
+std::uint32_t ReconnectBackoff::attempts() const noexcept { return attempts_; }
+
+} // namespace cpu_miner
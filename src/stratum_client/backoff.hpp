@@ -0,0 +1,42 @@
+// src/stratum_client/backoff.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_BACKOFF_HPP
+#define CPU_MINER_STRATUM_CLIENT_BACKOFF_HPP
+
+#include <chrono>
+#include <cstdint>
+
+/*******************************************************************************
+Purpose:
+  Exponential reconnect delay: initial, initial * multiplier, ... capped at
+  max. Kept free of I/O so the schedule can be tested directly.
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct BackoffConfig {
+   std::chrono::milliseconds initial{250};
+   std::chrono::milliseconds max{30'000};
+   std::uint32_t multiplier{2};
+};
+
+class ReconnectBackoff {
+ public:
+   ReconnectBackoff() = default;
+   explicit ReconnectBackoff(BackoffConfig config);
+
+   // Delay before the next attempt; advances the schedule.
+   [[nodiscard]] std::chrono::milliseconds next_delay() noexcept;
+   void reset() noexcept;
+
+   [[nodiscard]] std::uint32_t attempts() const noexcept;
+
+ private:
+   BackoffConfig config_{};
+   std::chrono::milliseconds current_{0};
+   std::uint32_t attempts_{0};
+};
+
+} // namespace cpu_miner
+
+#endif
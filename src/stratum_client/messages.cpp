@@ -2,9 +2,11 @@
 
 #include <boost/json.hpp>
 
+#include <cstdint>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 #include <variant>
 
 #include "stratum_client/messages.hpp"
@@ -48,31 +50,24 @@ std::optional<int> parse_message_id(const boost::json::object& obj) {
    return static_cast<int>(id64);
 }
 
+std::optional<double> json_number(const boost::json::value& v) {
+   if (v.is_double()) return v.as_double();
+   if (v.is_int64()) return static_cast<double>(v.as_int64());
+   if (v.is_uint64()) return static_cast<double>(v.as_uint64());
+   return std::nullopt;
+}
+
 std::optional<SetDifficultyMessage>
 parse_set_difficulty(const boost::json::object& obj) {
    const auto* params = find_params_array(obj);
    if (params == nullptr || params->empty()) return std::nullopt;
 
-   const boost::json::value& v = (*params)[0];
+   const auto difficulty = json_number((*params)[0]);
+   if (!difficulty) return std::nullopt;
 
    SetDifficultyMessage msg{};
-
-   if (v.is_double()) {
-      msg.difficulty = v.as_double();
-      return msg;
-   }
-
-   if (v.is_int64()) {
-      msg.difficulty = static_cast<double>(v.as_int64());
-      return msg;
-   }
-
-   if (v.is_uint64()) {
-      msg.difficulty = static_cast<double>(v.as_uint64());
-      return msg;
-   }
-
-   return std::nullopt;
+   msg.difficulty = *difficulty;
+   return msg;
 }
 
 std::optional<NotifyMessage> parse_notify(const boost::json::object& obj) {
@@ -118,6 +113,34 @@ std::optional<NotifyMessage> parse_notify(const boost::json::object& obj) {
    return msg;
 }
 
+// result[0] lists [method, subscription id] pairs. ckpool nests the list one
+// level deeper and some pools send a bare string. The mining.notify
+// subscription id is the one a pool accepts for resume.
+std::string find_session_id(const boost::json::value& subscriptions) {
+   if (subscriptions.is_string()) {
+      return std::string(subscriptions.as_string().c_str());
+   }
+
+   if (!subscriptions.is_array()) return {};
+
+   const auto& entries = subscriptions.as_array();
+   if (entries.size() == 2 && entries[0].is_string() &&
+       entries[1].is_string()) {
+      if (entries[0].as_string() == "mining.notify") {
+         return std::string(entries[1].as_string().c_str());
+      }
+      return {};
+   }
+
+   for (const auto& entry : entries) {
+      if (!entry.is_array()) continue;
+      auto id = find_session_id(entry);
+      if (!id.empty()) return id;
+   }
+
+   return {};
+}
+
 std::optional<SubscribeResponse>
 parse_subscribe_response(const boost::json::object& obj) {
    const auto id = parse_message_id(obj);
@@ -150,6 +173,7 @@ parse_subscribe_response(const boost::json::object& obj) {
    msg.id = *id;
    msg.extranonce1 = std::string(result[1].as_string().c_str());
    msg.extranonce2_size = extranonce2_size;
+   msg.session_id = find_session_id(result[0]);
    return msg;
 }
 
@@ -225,11 +249,16 @@ parse_method_message(const boost::json::object& obj) {
 
 } // namespace
 
-std::string to_wire_message(const SubscribeRequest&, const int id) {
+std::string to_wire_message(const SubscribeRequest& request, const int id) {
    boost::json::object message;
    message["id"] = id;
    message["method"] = "mining.subscribe";
-   message["params"] = boost::json::array{};
+   if (request.session_id.empty()) {
+      message["params"] = boost::json::array{};
+   } else {
+      message["params"] =
+         boost::json::array{request.user_agent, request.session_id};
+   }
    return boost::json::serialize(message);
 }
 
@@ -288,6 +317,160 @@ std::optional<IncomingMessage> parse_incoming_message(std::string_view line) {
    return UnknownMessage{.raw = std::string(line)};
 }
 
+std::optional<ClientRequest> parse_client_request(std::string_view line) {
+   boost::system::error_code ec;
+   const boost::json::value value = boost::json::parse(line, ec);
+   if (ec) return std::nullopt;
+   if (!value.is_object()) return std::nullopt;
+
+   const auto& obj = value.as_object();
+
+   const auto id = parse_message_id(obj);
+   if (!id) return std::nullopt;
+
+   const auto method_it = obj.find("method");
+   if (method_it == obj.end() || !method_it->value().is_string()) {
+      return std::nullopt;
+   }
+
+   const std::string method =
+      std::string(method_it->value().as_string().c_str());
+
+   const boost::json::array empty_params;
+   const auto* found_params = find_params_array(obj);
+   const boost::json::array& params =
+      found_params != nullptr ? *found_params : empty_params;
+
+   if (method == "mining.subscribe") {
+      SubscribeRequest request;
+      request.user_agent = json_string_at(params, 0).value_or(std::string{});
+      request.session_id = json_string_at(params, 1).value_or(std::string{});
+      return ClientRequest{.id = *id, .body = std::move(request)};
+   }
+
+   if (method == "mining.authorize") {
+      auto user = json_string_at(params, 0);
+      if (!user) return std::nullopt;
+
+      AuthorizeRequest request;
+      request.user = std::move(*user);
+      request.password = json_string_at(params, 1).value_or(std::string{});
+      return ClientRequest{.id = *id, .body = std::move(request)};
+   }
+
+   if (method == "mining.suggest_difficulty") {
+      if (params.empty()) return std::nullopt;
+
+      const auto difficulty = json_number(params[0]);
+      if (!difficulty) return std::nullopt;
+
+      return ClientRequest{
+         .id = *id,
+         .body = SuggestDifficultyRequest{.difficulty = *difficulty},
+      };
+   }
+
+   if (method == "mining.submit") {
+      auto worker_name = json_string_at(params, 0);
+      auto job_id = json_string_at(params, 1);
+      auto extranonce2 = json_string_at(params, 2);
+      auto ntime = json_string_at(params, 3);
+      auto nonce = json_string_at(params, 4);
+
+      if (!worker_name || !job_id || !extranonce2 || !ntime || !nonce) {
+         return std::nullopt;
+      }
+
+      return ClientRequest{
+         .id = *id,
+         .body =
+            SubmitShareRequest{
+               .worker_name = std::move(*worker_name),
+               .job_id = std::move(*job_id),
+               .extranonce2_hex = std::move(*extranonce2),
+               .ntime_hex = std::move(*ntime),
+               .nonce_hex = std::move(*nonce),
+            },
+      };
+   }
+
+   return std::nullopt;
+}
+
+std::string to_wire_message(const SetDifficultyMessage& msg) {
+   boost::json::object message;
+   message["id"] = nullptr;
+   message["method"] = "mining.set_difficulty";
+   message["params"] = boost::json::array{msg.difficulty};
+   return boost::json::serialize(message);
+}
+
+std::string to_wire_message(const NotifyMessage& msg) {
+   boost::json::array branch;
+   branch.reserve(msg.merkle_branch.size());
+   for (const auto& hash : msg.merkle_branch) {
+      branch.emplace_back(hash);
+   }
+
+   boost::json::array params;
+   params.reserve(9U);
+   params.emplace_back(msg.job_id);
+   params.emplace_back(msg.prevhash);
+   params.emplace_back(msg.coinb1);
+   params.emplace_back(msg.coinb2);
+   params.emplace_back(std::move(branch));
+   params.emplace_back(msg.version);
+   params.emplace_back(msg.nbits);
+   params.emplace_back(msg.ntime);
+   params.emplace_back(msg.clean_jobs);
+
+   boost::json::object message;
+   message["id"] = nullptr;
+   message["method"] = "mining.notify";
+   message["params"] = std::move(params);
+   return boost::json::serialize(message);
+}
+
+std::string to_wire_message(const SubscribeResponse& msg) {
+   boost::json::array subscription;
+   subscription.emplace_back("mining.notify");
+   subscription.emplace_back(msg.session_id);
+
+   boost::json::array subscriptions;
+   subscriptions.emplace_back(std::move(subscription));
+
+   boost::json::array result;
+   result.emplace_back(std::move(subscriptions));
+   result.emplace_back(msg.extranonce1);
+   result.emplace_back(static_cast<std::uint64_t>(msg.extranonce2_size));
+
+   boost::json::object message;
+   message["id"] = msg.id;
+   message["result"] = std::move(result);
+   message["error"] = nullptr;
+   return boost::json::serialize(message);
+}
+
+std::string to_wire_result(const int id, const bool result,
+                           const int error_code,
+                           const std::string_view error_text) {
+   boost::json::object message;
+   message["id"] = id;
+   message["result"] = result;
+
+   if (error_text.empty()) {
+      message["error"] = nullptr;
+   } else {
+      boost::json::array error;
+      error.emplace_back(error_code);
+      error.emplace_back(error_text);
+      error.emplace_back(nullptr);
+      message["error"] = std::move(error);
+   }
+
+   return boost::json::serialize(message);
+}
+
 std::string debug_summary(const SetDifficultyMessage& msg) {
    std::ostringstream out;
    out << "set_difficulty:\n";
@@ -321,6 +504,9 @@ std::string debug_summary(const SubscribeResponse& msg) {
    out << "  id:               " << msg.id << '\n';
    out << "  extranonce1:      " << msg.extranonce1 << '\n';
    out << "  extranonce2_size: " << msg.extranonce2_size << " bytes\n";
+   if (!msg.session_id.empty()) {
+      out << "  session_id:       " << msg.session_id << '\n';
+   }
    return out.str();
 }
 
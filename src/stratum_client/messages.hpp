@@ -71,6 +71,9 @@ struct SubscribeResponse {
    int id{};
    std::string extranonce1;
    std::size_t extranonce2_size{};
+   // mining.notify subscription id from result[0]; empty if the pool sent
+   // none. Offered back on reconnect to resume the session.
+   std::string session_id;
 };
 
 struct AuthorizeResponse {
@@ -99,7 +102,13 @@ using IncomingMessage =
    std::variant<UnknownMessage, SetDifficultyMessage, NotifyMessage,
                 SubscribeResponse, AuthorizeResponse, SubmitResponse>;
 
-struct SubscribeRequest {};
+// With an empty session_id the request carries no params, as before. With a
+// session_id the params are [user_agent, session_id], asking the pool to
+// resume that session and keep its extranonce1.
+struct SubscribeRequest {
+   std::string user_agent{"cpu-miner"};
+   std::string session_id;
+};
 
 struct SuggestDifficultyRequest {
    double difficulty{};
@@ -133,6 +142,31 @@ to_wire_message(const SuggestDifficultyRequest& request, int id);
 [[nodiscard]] std::optional<IncomingMessage>
 parse_incoming_message(std::string_view line);
 
+// Pool side of the same subset, used by the mock pool tool.
+
+using ClientRequestBody =
+   std::variant<SubscribeRequest, AuthorizeRequest, SuggestDifficultyRequest,
+                SubmitShareRequest>;
+
+struct ClientRequest {
+   int id{};
+   ClientRequestBody body;
+};
+
+// nullopt for malformed JSON, a missing id, or a method outside the subset.
+[[nodiscard]] std::optional<ClientRequest>
+parse_client_request(std::string_view line);
+
+[[nodiscard]] std::string to_wire_message(const SetDifficultyMessage& msg);
+[[nodiscard]] std::string to_wire_message(const NotifyMessage& msg);
+[[nodiscard]] std::string to_wire_message(const SubscribeResponse& msg);
+
+// Boolean result for mining.authorize and mining.submit. A non-empty
+// error_text is sent as [error_code, error_text, null].
+[[nodiscard]] std::string to_wire_result(int id, bool result,
+                                         int error_code = 0,
+                                         std::string_view error_text = {});
+
 [[nodiscard]] std::string debug_summary(const SetDifficultyMessage& msg);
 [[nodiscard]] std::string debug_summary(const NotifyMessage& msg);
 [[nodiscard]] std::string debug_summary(const SubscribeResponse& msg);
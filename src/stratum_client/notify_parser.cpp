@@ -0,0 +1,302 @@
+// src/stratum_client/notify_parser.cpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mining_job/target.hpp"
+#include "stratum_client/notify_parser.hpp"
+#include "util/endian.hpp"
+#include "util/hex.hpp"
+
+namespace cpu_miner {
+namespace {
+
+class Cursor {
+ public:
+   explicit Cursor(std::string_view text) : text_(text) {}
+
+   [[nodiscard]] bool consume(char ch) noexcept {
+      skip_ws();
+      if (pos_ >= text_.size() || text_[pos_] != ch) return false;
+      ++pos_;
+      return true;
+   }
+
+   [[nodiscard]] bool at_end() noexcept {
+      skip_ws();
+      return pos_ == text_.size();
+   }
+
+   // A string with no escape sequences, returned as a view into the line.
+   [[nodiscard]] bool read_plain_string(std::string_view& out) noexcept {
+      if (!consume('"')) return false;
+
+      const std::size_t begin = pos_;
+      for (; pos_ < text_.size(); ++pos_) {
+         const char ch = text_[pos_];
+         if (ch == '"') {
+            out = text_.substr(begin, pos_ - begin);
+            ++pos_;
+            return true;
+         }
+         if (ch == '\\' || static_cast<unsigned char>(ch) < 0x20U) {
+            return false;
+         }
+      }
+      return false;
+   }
+
+   [[nodiscard]] bool read_bool(bool& out) noexcept {
+      skip_ws();
+      if (consume_literal("true")) {
+         out = true;
+         return true;
+      }
+      if (consume_literal("false")) {
+         out = false;
+         return true;
+      }
+      return false;
+   }
+
+   [[nodiscard]] bool skip_value(int depth = 0) noexcept {
+      if (depth > 32) return false;
+
+      skip_ws();
+      if (pos_ >= text_.size()) return false;
+
+      switch (text_[pos_]) {
+      case '"':
+         return skip_string();
+      case '[':
+         return skip_container(']', depth);
+      case '{':
+         return skip_container('}', depth);
+      case 't':
+         return consume_literal("true");
+      case 'f':
+         return consume_literal("false");
+      case 'n':
+         return consume_literal("null");
+      default:
+         return skip_number();
+      }
+   }
+
+ private:
+   static bool is_ws(char ch) noexcept {
+      return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+   }
+
+   void skip_ws() noexcept {
+      while (pos_ < text_.size() && is_ws(text_[pos_])) ++pos_;
+   }
+
+   bool consume_literal(std::string_view literal) noexcept {
+      if (text_.substr(pos_, literal.size()) != literal) return false;
+      pos_ += literal.size();
+      return true;
+   }
+
+   bool skip_string() noexcept {
+      ++pos_;
+      for (; pos_ < text_.size(); ++pos_) {
+         const char ch = text_[pos_];
+         if (ch == '"') {
+            ++pos_;
+            return true;
+         }
+         if (ch == '\\') ++pos_;
+      }
+      return false;
+   }
+
+   bool skip_number() noexcept {
+      const std::size_t begin = pos_;
+      while (pos_ < text_.size()) {
+         const char ch = text_[pos_];
+         const bool number_char = (ch >= '0' && ch <= '9') || ch == '-' ||
+                                  ch == '+' || ch == '.' || ch == 'e' ||
+                                  ch == 'E';
+         if (!number_char) break;
+         ++pos_;
+      }
+      return pos_ != begin;
+   }
+
+   bool skip_container(char close, int depth) noexcept {
+      ++pos_;
+      if (consume(close)) return true;
+
+      do {
+         if (close == '}') {
+            if (!skip_string_key()) return false;
+            if (!consume(':')) return false;
+         }
+         if (!skip_value(depth + 1)) return false;
+      } while (consume(','));
+
+      return consume(close);
+   }
+
+   bool skip_string_key() noexcept {
+      skip_ws();
+      if (pos_ >= text_.size() || text_[pos_] != '"') return false;
+      return skip_string();
+   }
+
+   std::string_view text_;
+   std::size_t pos_{0};
+};
+
+bool decode_u32_field(std::string_view hex, std::uint32_t& out) noexcept {
+   std::array<std::uint8_t, 4> bytes{};
+   if (hex.size() != 8U || !hex_decode_into(hex, bytes)) return false;
+
+   out = (static_cast<std::uint32_t>(bytes[0]) << 24U) |
+         (static_cast<std::uint32_t>(bytes[1]) << 16U) |
+         (static_cast<std::uint32_t>(bytes[2]) << 8U) |
+         static_cast<std::uint32_t>(bytes[3]);
+   return true;
+}
+
+bool decode_bytes_field(std::string_view hex, std::vector<std::uint8_t>& out) {
+   if ((hex.size() % 2U) != 0U) return false;
+   out.resize(hex.size() / 2U);
+   return hex_decode_into(hex, out);
+}
+
+bool read_string_field(Cursor& cursor, std::string_view& out) {
+   return cursor.read_plain_string(out) && cursor.consume(',');
+}
+
+bool parse_merkle_branches(Cursor& cursor, NotifyMessage& msg,
+                           DecodedJob& decoded) {
+   if (!cursor.consume('[')) return false;
+
+   std::size_t count = 0;
+   decoded.merkle_branch.clear();
+
+   if (!cursor.consume(']')) {
+      do {
+         std::string_view branch;
+         if (!cursor.read_plain_string(branch)) return false;
+
+         HashBytes bytes{};
+         if (branch.size() != 64U || !hex_decode_into(branch, bytes)) {
+            return false;
+         }
+         decoded.merkle_branch.push_back(bytes);
+
+         if (count < msg.merkle_branch.size()) {
+            msg.merkle_branch[count].assign(branch);
+         } else {
+            msg.merkle_branch.emplace_back(branch);
+         }
+         ++count;
+      } while (cursor.consume(','));
+
+      if (!cursor.consume(']')) return false;
+   }
+
+   msg.merkle_branch.resize(count);
+   return true;
+}
+
+bool parse_params(Cursor& cursor, NotifyMessage& msg, DecodedJob& decoded) {
+   if (!cursor.consume('[')) return false;
+
+   std::string_view job_id;
+   std::string_view prevhash;
+   std::string_view coinb1;
+   std::string_view coinb2;
+
+   if (!read_string_field(cursor, job_id)) return false;
+   if (!read_string_field(cursor, prevhash)) return false;
+   if (!read_string_field(cursor, coinb1)) return false;
+   if (!read_string_field(cursor, coinb2)) return false;
+
+   if (!parse_merkle_branches(cursor, msg, decoded)) return false;
+   if (!cursor.consume(',')) return false;
+
+   std::string_view version;
+   std::string_view nbits;
+   std::string_view ntime;
+
+   if (!read_string_field(cursor, version)) return false;
+   if (!read_string_field(cursor, nbits)) return false;
+   if (!read_string_field(cursor, ntime)) return false;
+   if (!cursor.read_bool(msg.clean_jobs)) return false;
+
+   // Trailing parameters are tolerated, as in parse_incoming_message.
+   while (cursor.consume(',')) {
+      if (!cursor.skip_value()) return false;
+   }
+   if (!cursor.consume(']')) return false;
+
+   if (prevhash.size() != 64U ||
+       !hex_decode_into(prevhash, decoded.prevhash_sha_input)) {
+      return false;
+   }
+   util::byteswap_each_u32(decoded.prevhash_sha_input);
+
+   if (!decode_bytes_field(coinb1, decoded.coinb1)) return false;
+   if (!decode_bytes_field(coinb2, decoded.coinb2)) return false;
+   if (!decode_u32_field(version, decoded.version)) return false;
+   if (!decode_u32_field(nbits, decoded.nbits)) return false;
+   if (!decode_u32_field(ntime, decoded.ntime)) return false;
+
+   decoded.network_target = expand_compact_target(decoded.nbits);
+
+   msg.job_id.assign(job_id);
+   msg.prevhash.assign(prevhash);
+   msg.coinb1.assign(coinb1);
+   msg.coinb2.assign(coinb2);
+   msg.version.assign(version);
+   msg.nbits.assign(nbits);
+   msg.ntime.assign(ntime);
+
+   return true;
+}
+
+} // namespace
+
+bool parse_notify_line(std::string_view line, NotifyMessage& msg,
+                       DecodedJob& decoded) {
+   Cursor cursor(line);
+
+   if (!cursor.consume('{')) return false;
+
+   bool have_params = false;
+   bool is_notify = false;
+
+   do {
+      std::string_view key;
+      if (!cursor.read_plain_string(key)) return false;
+      if (!cursor.consume(':')) return false;
+
+      if (key == "method") {
+         std::string_view method;
+         if (!cursor.read_plain_string(method)) return false;
+         if (method != "mining.notify") return false;
+         is_notify = true;
+      } else if (key == "params") {
+         if (have_params) return false;
+         if (!parse_params(cursor, msg, decoded)) return false;
+         have_params = true;
+      } else if (!cursor.skip_value()) {
+         return false;
+      }
+   } while (cursor.consume(','));
+
+   if (!cursor.consume('}')) return false;
+
+   return cursor.at_end() && have_params && is_notify;
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,41 @@
+// src/stratum_client/notify_parser.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_NOTIFY_PARSER_HPP
+#define CPU_MINER_STRATUM_CLIENT_NOTIFY_PARSER_HPP
+
+#include <string_view>
+
+#include "mining_job/job.hpp"
+#include "stratum_client/messages.hpp"
+
+/*******************************************************************************
+Purpose:
+  Streaming fast path for mining.notify. Scans one wire line in place and
+  decodes the hex fields straight into a DecodedJob, without building a
+  JSON DOM.
+
+Scope:
+  - mining.notify only
+  - strings without escape sequences (every ckpool notify field)
+
+Requirements:
+  - accept exactly what parse_incoming_message would accept as a notify,
+    or report failure so the caller falls back to it
+  - reuse the caller's NotifyMessage/DecodedJob storage between lines
+
+Do not:
+  - handle other methods or responses here; messages.* remains the source
+    of truth for everything else
+*******************************************************************************/
+
+namespace cpu_miner {
+
+// Parse `line` as mining.notify into `msg` and `decoded`. Returns false when
+// the line is not a well-formed notify (including any hex field that does
+// not decode); both outputs are then unspecified.
+[[nodiscard]] bool parse_notify_line(std::string_view line, NotifyMessage& msg,
+                                     DecodedJob& decoded);
+
+} // namespace cpu_miner
+
+#endif
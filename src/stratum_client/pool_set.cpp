@@ -0,0 +1,120 @@
+// src/stratum_client/pool_set.cpp
+
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+#include "stratum_client/pool_set.hpp"
+
+namespace cpu_miner {
+
+PoolEndpoint parse_pool_endpoint(std::string_view spec) {
+   PoolEndpoint endpoint;
+
+   if (const auto comma = spec.find(','); comma != std::string_view::npos) {
+      const std::string_view weight = spec.substr(comma + 1U);
+      const auto [ptr, ec] = std::from_chars(
+         weight.data(), weight.data() + weight.size(), endpoint.weight);
+      if (ec != std::errc{} || ptr != weight.data() + weight.size() ||
+          endpoint.weight == 0U) {
+         throw std::invalid_argument("pool weight must be a positive integer");
+      }
+      spec = spec.substr(0, comma);
+   }
+
+   const auto colon = spec.rfind(':');
+   if (colon == std::string_view::npos || colon == 0U ||
+       colon + 1U == spec.size()) {
+      throw std::invalid_argument("pool must be given as host:port[,weight]");
+   }
+
+   endpoint.host = std::string(spec.substr(0, colon));
+   endpoint.port = std::string(spec.substr(colon + 1U));
+   return endpoint;
+}
+
+PoolSelector::PoolSelector(std::vector<std::uint32_t> weights,
+                           PoolSelectorConfig config)
+   : config_(config) {
+   if (weights.empty()) {
+      throw std::invalid_argument("pool selector needs at least one pool");
+   }
+
+   pools_.reserve(weights.size());
+   for (const std::uint32_t weight : weights) {
+      if (weight == 0U) {
+         throw std::invalid_argument("pool weight must be > 0");
+      }
+      pools_.push_back(Pool{.weight = weight});
+   }
+}
+
+void PoolSelector::note_notify(std::size_t pool, clock::time_point now) {
+   auto& p = pools_.at(pool);
+   p.up = true;
+   p.last_notify = now;
+}
+
+void PoolSelector::mark_down(std::size_t pool) { pools_.at(pool).up = false; }
+
+bool PoolSelector::healthy(std::size_t pool, clock::time_point now) const {
+   const auto& p = pools_.at(pool);
+   return p.up && now - p.last_notify <= config_.notify_timeout;
+}
+
+bool PoolSelector::update(clock::time_point now) {
+   const auto previous = active_;
+
+   if (config_.mode == PoolMode::failover) {
+      active_ = pick_failover(now);
+   } else {
+      const bool slice_over = now - slice_started_ >= config_.split_slice;
+      if (!active_ || !healthy(*active_, now) || slice_over) {
+         active_ = pick_weighted(now);
+         slice_started_ = now;
+      }
+   }
+
+   return active_ != previous;
+}
+
+std::optional<std::size_t>
+PoolSelector::pick_failover(clock::time_point now) const {
+   for (std::size_t i = 0; i < pools_.size(); ++i) {
+      if (healthy(i, now)) return i;
+   }
+   return std::nullopt;
+}
+
+// Smooth weighted round robin: every healthy pool gains its weight, the
+// richest wins and pays back the total. Over sum(weights) slices each pool is
+// picked exactly `weight` times, interleaved rather than in bursts.
+std::optional<std::size_t> PoolSelector::pick_weighted(clock::time_point now) {
+   std::optional<std::size_t> best;
+   std::int64_t total = 0;
+
+   for (std::size_t i = 0; i < pools_.size(); ++i) {
+      if (!healthy(i, now)) continue;
+
+      auto& p = pools_[i];
+      p.current_weight += p.weight;
+      total += p.weight;
+
+      if (!best || p.current_weight > pools_[*best].current_weight) best = i;
+   }
+
+   if (best) pools_[*best].current_weight -= total;
+   return best;
+}
+
+std::optional<std::size_t> PoolSelector::active() const noexcept {
+   return active_;
+}
+
+std::size_t PoolSelector::size() const noexcept { return pools_.size(); }
+
+const PoolSelectorConfig& PoolSelector::config() const noexcept {
+   return config_;
+}
+
+} // namespace cpu_miner
@@ -0,0 +1,97 @@
+// src/stratum_client/pool_set.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_POOL_SET_HPP
+#define CPU_MINER_STRATUM_CLIENT_POOL_SET_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Decide which of several pool connections receives the hashrate.
+
+Scope:
+  - failover: the highest-priority healthy pool is active; lower pools are
+    hot standbys that are already subscribed and holding a current job, so
+    switching needs no network round trip
+  - split: time slices rotate between healthy pools by weight (smooth
+    weighted round robin), so each pool gets its share of hashes
+
+Requirements:
+  - no I/O and no clock reads; callers pass `now`
+  - a pool is healthy while connected and its last notify is no older than
+    notify_timeout
+
+Notes:
+  - Pools are identified by their index, which is also their priority
+    (0 is the primary).
+*******************************************************************************/
+
+namespace cpu_miner {
+
+enum class PoolMode {
+   failover,
+   split,
+};
+
+struct PoolEndpoint {
+   std::string host;
+   std::string port;
+   std::uint32_t weight{1};
+};
+
+// Parses "host:port" or "host:port,weight". Throws std::invalid_argument.
+[[nodiscard]] PoolEndpoint parse_pool_endpoint(std::string_view spec);
+
+struct PoolSelectorConfig {
+   PoolMode mode{PoolMode::failover};
+   std::chrono::milliseconds notify_timeout{65'000};
+   std::chrono::milliseconds split_slice{10'000};
+};
+
+class PoolSelector {
+ public:
+   using clock = std::chrono::steady_clock;
+
+   // One weight per pool in priority order. Weights must be > 0.
+   PoolSelector(std::vector<std::uint32_t> weights, PoolSelectorConfig config);
+
+   void note_notify(std::size_t pool, clock::time_point now);
+   void mark_down(std::size_t pool);
+
+   [[nodiscard]] bool healthy(std::size_t pool, clock::time_point now) const;
+
+   // Re-evaluates the active pool. Returns true if it changed.
+   [[nodiscard]] bool update(clock::time_point now);
+
+   [[nodiscard]] std::optional<std::size_t> active() const noexcept;
+   [[nodiscard]] std::size_t size() const noexcept;
+   [[nodiscard]] const PoolSelectorConfig& config() const noexcept;
+
+ private:
+   struct Pool {
+      std::uint32_t weight{};
+      bool up{};
+      clock::time_point last_notify{};
+      std::int64_t current_weight{};
+   };
+
+   [[nodiscard]] std::optional<std::size_t>
+   pick_failover(clock::time_point now) const;
+   [[nodiscard]] std::optional<std::size_t>
+   pick_weighted(clock::time_point now);
+
+   PoolSelectorConfig config_;
+   std::vector<Pool> pools_;
+   std::optional<std::size_t> active_;
+   clock::time_point slice_started_{};
+};
+
+} // namespace cpu_miner
+
+#endif
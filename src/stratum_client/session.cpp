@@ -0,0 +1,108 @@
+// src/stratum_client/session.cpp
+
+#include <boost/system/system_error.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#include "stratum_client/session.hpp"
+
+namespace cpu_miner {
+namespace {
+
+// Returns false if stop was requested during the wait.
+bool sleep_for(std::chrono::milliseconds delay, std::stop_token stop_token) {
+   std::mutex mutex;
+   std::condition_variable_any cv;
+   std::unique_lock<std::mutex> lock(mutex);
+   (void)cv.wait_for(lock, stop_token, delay, []() { return false; });
+   return !stop_token.stop_requested();
+}
+
+// Bounds the client's connect and reads for as long as it is alive.
+class HandshakeDeadline {
+ public:
+   HandshakeDeadline(StratumClient& client, std::chrono::milliseconds timeout)
+      : client_(client) {
+      client_.set_deadline(std::chrono::steady_clock::now() + timeout);
+   }
+
+   HandshakeDeadline(const HandshakeDeadline&) = delete;
+   HandshakeDeadline& operator=(const HandshakeDeadline&) = delete;
+
+   ~HandshakeDeadline() { client_.set_deadline(std::nullopt); }
+
+ private:
+   StratumClient& client_;
+};
+
+} // namespace
+
+StratumSession::StratumSession(StratumClient& client,
+                               SessionCredentials credentials,
+                               BackoffConfig backoff,
+                               std::chrono::milliseconds handshake_timeout)
+   : client_(client)
+   , credentials_(std::move(credentials))
+   , backoff_(backoff)
+   , handshake_timeout_(handshake_timeout) {}
+
+void StratumSession::start() {
+   const HandshakeDeadline deadline(client_, handshake_timeout_);
+   handshake();
+}
+
+void StratumSession::handshake() {
+   client_.connect();
+   client_.subscribe();
+   client_.suggest_difficulty(credentials_.suggested_difficulty);
+   client_.authorize(credentials_.user, credentials_.password);
+   client_.run_until_ready();
+}
+
+std::optional<ReconnectOutcome>
+StratumSession::recover(std::stop_token stop_token) {
+   const auto down_since = std::chrono::steady_clock::now();
+
+   std::optional<SubscriptionContext> previous = client_.subscription();
+
+   ReconnectOutcome outcome{};
+   outcome.dropped_submits = client_.reset_connection();
+   backoff_.reset();
+
+   while (sleep_for(backoff_.next_delay(), stop_token)) {
+      outcome.attempts = backoff_.attempts();
+
+      try {
+         const HandshakeDeadline deadline(client_, handshake_timeout_);
+         const std::uint64_t notifies_before = client_.notify_count();
+         handshake();
+
+         const auto& sub = *client_.subscription();
+         outcome.resumed =
+            previous && sub.extranonce1 == previous->extranonce1 &&
+            sub.extranonce2_size == previous->extranonce2_size;
+
+         if (!outcome.resumed && client_.notify_count() == notifies_before) {
+            client_.run_until_notify();
+         }
+      } catch (const boost::system::system_error&) {
+         // Includes a handshake that timed out; back off and retry.
+         outcome.dropped_submits += client_.reset_connection();
+         continue;
+      }
+
+      outcome.downtime = std::chrono::steady_clock::now() - down_since;
+      return outcome;
+   }
+
+   return std::nullopt;
+}
+
+void StratumSession::suggest_difficulty(double difficulty) {
+   client_.suggest_difficulty(difficulty);
+   credentials_.suggested_difficulty = difficulty;
+}
+
+} // namespace cpu_miner
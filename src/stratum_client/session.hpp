@@ -0,0 +1,85 @@
+// src/stratum_client/session.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_SESSION_HPP
+#define CPU_MINER_STRATUM_CLIENT_SESSION_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+#include <string>
+
+#include "stratum_client/backoff.hpp"
+#include "stratum_client/stratum_client.hpp"
+
+/*******************************************************************************
+Purpose:
+  Own the connect/subscribe/authorize handshake for one StratumClient and
+  re-run it after the connection drops.
+
+Scope:
+  - first connection (errors propagate as before)
+  - reconnect with exponential backoff until success or stop
+  - session resume by offering the previous mining.notify subscription id
+  - a deadline on every handshake, so a pool that accepts the connection
+    but never answers counts as a failed attempt
+
+Requirements:
+  - no printing; outcomes are returned to the caller
+  - the last job stays in the client across a reconnect so workers keep
+    hashing it
+  - when the pool does not resume (extranonce1 changes), wait for a fresh
+    notify before reporting success so stale work is not republished
+
+Do not:
+  - touch worker threads or shared work from here
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct SessionCredentials {
+   std::string user;
+   std::string password;
+   double suggested_difficulty{1.0};
+};
+
+struct ReconnectOutcome {
+   std::chrono::steady_clock::duration downtime{};
+   std::uint32_t attempts{};
+   // Same extranonce1 as before the drop: work in progress is still valid.
+   bool resumed{};
+   std::size_t dropped_submits{};
+};
+
+class StratumSession {
+ public:
+   static constexpr std::chrono::milliseconds default_handshake_timeout{
+      10'000};
+
+   StratumSession(
+      StratumClient& client, SessionCredentials credentials,
+      BackoffConfig backoff = {},
+      std::chrono::milliseconds handshake_timeout = default_handshake_timeout);
+
+   void start();
+
+   // Call after an I/O error from the client. Returns std::nullopt if stop
+   // was requested before a new connection completed its handshake.
+   [[nodiscard]] std::optional<ReconnectOutcome>
+   recover(std::stop_token stop_token);
+
+   // Sends mining.suggest_difficulty now and on every later handshake.
+   void suggest_difficulty(double difficulty);
+
+ private:
+   void handshake();
+
+   StratumClient& client_;
+   SessionCredentials credentials_;
+   ReconnectBackoff backoff_;
+   std::chrono::milliseconds handshake_timeout_;
+};
+
+} // namespace cpu_miner
+
+#endif
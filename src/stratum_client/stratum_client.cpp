@@ -1,20 +1,28 @@
 // src/stratum_client/stratum_client.cpp
 
 #include <boost/asio/connect.hpp>
+#include <boost/asio/error.hpp>
 #include <boost/asio/read_until.hpp>
 #include <boost/asio/write.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 #include <variant>
 
 #include "stratum_client/messages.hpp"
+#include "stratum_client/notify_parser.hpp"
 #include "stratum_client/stratum_client.hpp"
 
 namespace cpu_miner {
 namespace {
 
+// How long a blocked connect or read runs before checking abort_io() again.
+constexpr std::chrono::milliseconds kAbortCheckInterval{50};
+
 template<class... Ts>
 struct Overload : Ts... {
    using Ts::operator()...;
@@ -27,6 +35,7 @@ PollResult
 apply_parsed_message(const IncomingMessage& parsed,
                      std::optional<SubscriptionContext>& subscription,
                      std::optional<MiningJob>& current_job,
+                     std::optional<DecodedJob>& current_decoded_job,
                      double& difficulty) {
    PollResult result{};
 
@@ -37,7 +46,7 @@ apply_parsed_message(const IncomingMessage& parsed,
                     result.got_message = true;
                     if (difficulty != msg.difficulty) {
                        difficulty = msg.difficulty;
-                       result.work_invalidated = true;
+                       result.difficulty_changed = true;
                     }
                  },
 
@@ -54,6 +63,7 @@ apply_parsed_message(const IncomingMessage& parsed,
                        .ntime = msg.ntime,
                        .clean_jobs = msg.clean_jobs,
                     };
+                    current_decoded_job = decode_job(*current_job);
                     result.work_invalidated = true;
                  },
 
@@ -74,6 +84,43 @@ apply_parsed_message(const IncomingMessage& parsed,
    return result;
 }
 
+// Move a freshly parsed notify into the current job, leaving the previous
+// job's storage behind in the scratch objects for reuse by the next line.
+void adopt_notify(NotifyMessage& msg, DecodedJob& decoded,
+                  std::optional<MiningJob>& current_job,
+                  std::optional<DecodedJob>& current_decoded_job) {
+   if (!current_job) current_job.emplace();
+   if (!current_decoded_job) current_decoded_job.emplace();
+
+   auto& job = *current_job;
+   std::swap(job.job_id, msg.job_id);
+   std::swap(job.prevhash, msg.prevhash);
+   std::swap(job.coinb1, msg.coinb1);
+   std::swap(job.coinb2, msg.coinb2);
+   std::swap(job.merkle_branch, msg.merkle_branch);
+   std::swap(job.version, msg.version);
+   std::swap(job.nbits, msg.nbits);
+   std::swap(job.ntime, msg.ntime);
+   job.clean_jobs = msg.clean_jobs;
+
+   std::swap(*current_decoded_job, decoded);
+}
+
+// SyncWriteStream that accepts and drops everything; replay's write side.
+struct DiscardStream {
+   template<class ConstBufferSequence>
+   std::size_t write_some(const ConstBufferSequence& buffers) {
+      return boost::asio::buffer_size(buffers);
+   }
+
+   template<class ConstBufferSequence>
+   std::size_t write_some(const ConstBufferSequence& buffers,
+                          boost::system::error_code& ec) {
+      ec = {};
+      return boost::asio::buffer_size(buffers);
+   }
+};
+
 } // namespace
 
 StratumClient::StratumClient(std::string host, std::string port)
@@ -82,13 +129,81 @@ StratumClient::StratumClient(std::string host, std::string port)
    , resolver_(io_)
    , socket_(io_) {}
 
+StratumClient::StratumClient(WireReplay replay)
+   : host_("replay")
+   , replay_(std::move(replay))
+   , resolver_(io_)
+   , socket_(io_) {}
+
+void StratumClient::capture_to(std::unique_ptr<WireCaptureWriter> capture) {
+   capture_ = std::move(capture);
+}
+
 void StratumClient::connect() {
+   if (replay_) {
+      replay_->start(std::chrono::steady_clock::now());
+      return;
+   }
+
    const auto endpoints = resolver_.resolve(host_, port_);
-   boost::asio::connect(socket_, endpoints);
+
+   boost::system::error_code ec;
+   bool done = false;
+   boost::asio::async_connect(
+      socket_, endpoints,
+      [&](const boost::system::error_code& result, const auto&) {
+         ec = result;
+         done = true;
+      });
+   run_io_until(done, "stratum connect");
+   if (ec) throw boost::system::system_error(ec, "stratum connect");
+}
+
+void StratumClient::set_deadline(
+   std::optional<std::chrono::steady_clock::time_point> deadline) noexcept {
+   deadline_ = deadline;
+}
+
+void StratumClient::abort_io() noexcept {
+   io_aborted_.store(true, std::memory_order_release);
+}
+
+void StratumClient::run_io_until(const bool& done, const char* what) {
+   io_.restart();
+   while (!done) {
+      boost::system::error_code failure;
+      auto slice = kAbortCheckInterval;
+      if (io_aborted_.load(std::memory_order_acquire)) {
+         failure = boost::asio::error::operation_aborted;
+      } else if (deadline_) {
+         const auto now = std::chrono::steady_clock::now();
+         if (now >= *deadline_) {
+            failure = boost::asio::error::timed_out;
+         } else {
+            slice = std::min(slice,
+                             std::chrono::ceil<std::chrono::milliseconds>(
+                                *deadline_ - now));
+         }
+      }
+
+      if (failure) {
+         // Closing completes the pending operation with operation_aborted;
+         // run it so its handler no longer refers to the caller's frame.
+         boost::system::error_code ignored;
+         socket_.close(ignored);
+         io_.restart();
+         io_.run();
+         throw boost::system::system_error(failure, what);
+      }
+
+      io_.run_for(slice);
+   }
 }
 
 void StratumClient::subscribe() {
-   send_wire_message(to_wire_message(SubscribeRequest{}, next_id_++));
+   SubscribeRequest request;
+   request.session_id = session_id_;
+   send_wire_message(to_wire_message(request, next_id_++));
 }
 
 void StratumClient::suggest_difficulty(const double difficulty) {
@@ -112,12 +227,40 @@ void StratumClient::authorize(const std::string& user,
 
 void StratumClient::run_until_ready() {
    while (!ready()) {
-      const std::string line = read_line();
+      const std::string_view line = read_line();
       if (line.empty()) continue;
       (void)handle_message(line);
    }
 }
 
+void StratumClient::run_until_notify() {
+   const std::uint64_t seen = notify_count_;
+   while (notify_count_ == seen) {
+      const std::string_view line = read_line();
+      if (line.empty()) continue;
+      (void)handle_message(line);
+   }
+}
+
+std::size_t StratumClient::reset_connection() {
+   boost::system::error_code ignored;
+   socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+   socket_.close(ignored);
+
+   buffer_.consume(buffer_.size());
+   pending_consume_ = 0;
+   write_batch_.clear();
+
+   const std::size_t dropped = pending_submits_.size();
+   pending_submits_.clear();
+   completed_submits_.clear();
+
+   subscription_.reset();
+   deferred_invalidation_ = false;
+   deferred_difficulty_change_ = false;
+   return dropped;
+}
+
 const std::string& StratumClient::worker_name() const noexcept {
    return worker_name_;
 }
@@ -131,8 +274,21 @@ const std::optional<MiningJob>& StratumClient::current_job() const noexcept {
    return current_job_;
 }
 
+const std::optional<DecodedJob>&
+StratumClient::current_decoded_job() const noexcept {
+   return current_decoded_job_;
+}
+
 double StratumClient::difficulty() const noexcept { return difficulty_; }
 
+const std::string& StratumClient::session_id() const noexcept {
+   return session_id_;
+}
+
+std::uint64_t StratumClient::notify_count() const noexcept {
+   return notify_count_;
+}
+
 const std::string& StratumClient::last_raw_incoming() const noexcept {
    return last_raw_incoming_;
 }
@@ -141,39 +297,188 @@ const std::string& StratumClient::last_raw_outgoing() const noexcept {
    return last_raw_outgoing_;
 }
 
+std::chrono::steady_clock::time_point
+StratumClient::last_notify_received() const noexcept {
+   return last_notify_received_;
+}
+
 const std::string& StratumClient::last_raw_notify() const noexcept {
    return last_raw_notify_;
 }
 
-const std::string& StratumClient::last_parsed_summary() const noexcept {
+const std::string& StratumClient::last_parsed_summary() const {
+   if (summary_pending_) {
+      const MiningJob& job = *current_job_;
+      last_parsed_summary_ = debug_summary(NotifyMessage{
+         .job_id = job.job_id,
+         .prevhash = job.prevhash,
+         .coinb1 = job.coinb1,
+         .coinb2 = job.coinb2,
+         .merkle_branch = job.merkle_branch,
+         .version = job.version,
+         .nbits = job.nbits,
+         .ntime = job.ntime,
+         .clean_jobs = job.clean_jobs,
+      });
+      summary_pending_ = false;
+   }
    return last_parsed_summary_;
 }
 
-void StratumClient::send_wire_message(const std::string& wire) {
-   last_raw_outgoing_ = wire;
+void StratumClient::send_wire_message(std::string_view wire) {
+   queue_wire_message(wire);
+   (void)flush_writes(true);
+}
+
+void StratumClient::queue_wire_message(std::string_view wire) {
+   last_raw_outgoing_.assign(wire);
+   if (capture_) capture_->record(WireDirection::to_pool, wire);
+   write_batch_.append(wire, WriteBatch::clock::now());
+}
 
-   std::string framed = wire;
-   framed.push_back('\n');
-   boost::asio::write(socket_, boost::asio::buffer(framed));
+void StratumClient::set_write_batching(WriteBatchConfig config) {
+   write_batch_.configure(config);
 }
 
-std::string StratumClient::read_line() {
-   boost::asio::read_until(socket_, buffer_, '\n');
+bool StratumClient::flush_writes(bool force) {
+   if (write_batch_.empty()) return false;
+   if (!force && !write_batch_.due(WriteBatch::clock::now())) return false;
 
-   std::istream input(&buffer_);
-   std::string line;
-   std::getline(input, line);
+   if (replay_) {
+      DiscardStream discard;
+      (void)write_batch_.write_to(discard);
+   } else {
+      (void)write_batch_.write_to(socket_);
+   }
+   return true;
+}
+
+std::optional<WriteBatch::clock::time_point>
+StratumClient::write_deadline() const noexcept {
+   if (write_batch_.empty()) return std::nullopt;
+   return write_batch_.deadline();
+}
+
+const WriteBatchStats& StratumClient::write_stats() const noexcept {
+   return write_batch_.stats();
+}
+
+std::size_t StratumClient::pending_submits() const noexcept {
+   return pending_submits_.size();
+}
+
+bool StratumClient::take_submit_result(SubmitShareResult& out) {
+   if (completed_submits_.empty()) return false;
+
+   out = std::move(completed_submits_.front());
+   completed_submits_.pop_front();
+   return true;
+}
+
+void StratumClient::complete_submit(const SubmitResponse& response,
+                                    std::string_view line) {
+   const auto it =
+      std::ranges::find(pending_submits_, response.id, &PendingSubmit::id);
+   if (it == pending_submits_.end()) return;
+
+   completed_submits_.push_back(SubmitShareResult{
+      .id = response.id,
+      .accepted = response.accepted,
+      .error_text = response.error_text,
+      .request_bytes = it->request_bytes,
+      .raw_response = std::string(line),
+   });
+   pending_submits_.erase(it);
+}
+
+std::string_view StratumClient::read_line() {
+   buffer_.consume(pending_consume_);
+   pending_consume_ = 0;
+
+   std::size_t n = 0;
+   if (replay_) {
+      if (!buffered_line_available()) (void)buffer_replayed_line(true);
+      const auto data = buffer_.data();
+      const std::string_view pending(static_cast<const char*>(data.data()),
+                                     data.size());
+      n = pending.find('\n') + 1U;
+   } else {
+      boost::system::error_code ec;
+      bool done = false;
+      boost::asio::async_read_until(
+         socket_, buffer_, '\n',
+         [&](const boost::system::error_code& result, std::size_t bytes) {
+            ec = result;
+            n = bytes;
+            done = true;
+         });
+      run_io_until(done, "stratum read");
+      if (ec) throw boost::system::system_error(ec, "stratum read");
+   }
+   pending_consume_ = n;
+   last_line_received_ = std::chrono::steady_clock::now();
+
+   const auto data = buffer_.data();
+   std::string_view line(static_cast<const char*>(data.data()), n - 1U);
 
    if (!line.empty() && line.back() == '\r') {
-      line.pop_back();
+      line.remove_suffix(1);
    }
 
-   last_raw_incoming_ = line;
+   last_raw_incoming_.assign(line);
+   if (capture_) capture_->record(WireDirection::from_pool, line);
    return line;
 }
 
+bool StratumClient::buffer_replayed_line(bool wait) {
+   if (replay_->finished()) throw WireReplayFinished();
+
+   const auto due = *replay_->next_due();
+   if (wait) std::this_thread::sleep_until(due);
+
+   const auto line = replay_->take_due(std::chrono::steady_clock::now());
+   if (!line) return false;
+
+   const auto out = buffer_.prepare(line->size() + 1U);
+   char* bytes = static_cast<char*>(out.data());
+   std::memcpy(bytes, line->data(), line->size());
+   bytes[line->size()] = '\n';
+   buffer_.commit(line->size() + 1U);
+   return true;
+}
+
+bool StratumClient::buffered_line_available() const {
+   const auto data = buffer_.data();
+   const std::string_view pending(static_cast<const char*>(data.data()),
+                                  data.size());
+   return pending.find('\n', pending_consume_) != std::string_view::npos;
+}
+
+bool StratumClient::try_fast_notify(std::string_view line,
+                                    PollResult& result) {
+   if (!parse_notify_line(line, notify_scratch_, decoded_scratch_)) {
+      return false;
+   }
+
+   summary_pending_ = true;
+   last_raw_notify_.assign(line);
+
+   adopt_notify(notify_scratch_, decoded_scratch_, current_job_,
+                current_decoded_job_);
+   ++notify_count_;
+   last_notify_received_ = last_line_received_;
+
+   result.got_message = true;
+   result.work_invalidated = true;
+   return true;
+}
+
 PollResult StratumClient::handle_message(std::string_view line) {
+   PollResult fast{};
+   if (try_fast_notify(line, fast)) return fast;
+
    const auto parsed = parse_incoming_message(line);
+   summary_pending_ = false;
    if (!parsed) {
       last_parsed_summary_.clear();
       return {};
@@ -182,80 +487,128 @@ PollResult StratumClient::handle_message(std::string_view line) {
    last_parsed_summary_ = debug_summary(*parsed);
 
    if (std::holds_alternative<NotifyMessage>(*parsed)) {
-      last_raw_notify_ = std::string(line);
+      last_raw_notify_.assign(line);
+      ++notify_count_;
+      last_notify_received_ = last_line_received_;
+   } else if (const auto* submit = std::get_if<SubmitResponse>(&*parsed)) {
+      complete_submit(*submit, line);
+   } else if (const auto* sub = std::get_if<SubscribeResponse>(&*parsed)) {
+      if (!sub->session_id.empty()) session_id_ = sub->session_id;
    }
 
    return apply_parsed_message(*parsed, subscription_, current_job_,
-                               difficulty_);
+                               current_decoded_job_, difficulty_);
 }
 
 bool StratumClient::ready() const noexcept {
    return subscription_.has_value() && current_job_.has_value();
 }
 
-PollResult StratumClient::poll() {
+// available() reports 0 both when the pool is quiet and when it has closed
+// the connection; a non-blocking peek tells the two apart.
+bool StratumClient::peer_closed() {
    boost::system::error_code ec;
-   const auto available = socket_.available(ec);
-   if (ec || available == 0U) {
-      return {};
+   socket_.non_blocking(true, ec);
+   if (ec) return true;
+
+   char probe{};
+   (void)socket_.receive(boost::asio::buffer(&probe, 1U),
+                         boost::asio::socket_base::message_peek, ec);
+
+   boost::system::error_code ignored;
+   socket_.non_blocking(false, ignored);
+
+   return ec && ec != boost::asio::error::would_block;
+}
+
+PollResult StratumClient::poll() {
+   PollResult result{};
+   result.work_invalidated = std::exchange(deferred_invalidation_, false);
+   result.difficulty_changed =
+      std::exchange(deferred_difficulty_change_, false);
+
+   if (replay_ && !buffered_line_available()) {
+      if (!buffer_replayed_line(false)) return result;
+   } else if (!buffered_line_available()) {
+      boost::system::error_code ec;
+      const auto available = socket_.available(ec);
+      if (ec) {
+         throw boost::system::system_error(ec, "stratum poll");
+      }
+      if (available == 0U) {
+         if (peer_closed()) {
+            throw boost::system::system_error(boost::asio::error::eof,
+                                              "stratum poll");
+         }
+         return result;
+      }
    }
 
-   const std::string line = read_line();
+   const std::string_view line = read_line();
    if (line.empty()) {
-      return {};
+      return result;
    }
 
-   return handle_message(line);
+   const PollResult handled = handle_message(line);
+   result.got_message = handled.got_message;
+   result.work_invalidated = result.work_invalidated || handled.work_invalidated;
+   result.difficulty_changed =
+      result.difficulty_changed || handled.difficulty_changed;
+   return result;
 }
 
-SubmitShareResult StratumClient::submit_share(const ShareSubmission& share) {
+int StratumClient::queue_share(const ShareSubmission& share) {
    if (worker_name_.empty()) {
       throw std::runtime_error("worker name is not set; authorize first");
    }
 
    const int submit_id = next_id_++;
+   if (!submit_template_.matches(worker_name_, share.job_id,
+                                 share.extranonce2_size)) {
+      submit_template_ =
+         SubmitTemplate(worker_name_, share.job_id, share.extranonce2_size);
+   }
 
-   const SubmitShareRequest request{
-      .worker_name = worker_name_,
-      .job_id = share.job_id,
-      .extranonce2_hex = share.extranonce2_hex,
-      .ntime_hex = share.ntime_hex,
-      .nonce_hex = share.nonce_hex,
-   };
-
-   const std::string wire = to_wire_message(request, submit_id);
-   send_wire_message(wire);
+   const std::string_view wire = submit_template_.fill(
+      submit_id, share.extranonce2_counter, share.ntime, share.nonce);
 
-   for (;;) {
-      const std::string line = read_line();
-      if (line.empty()) continue;
+   queue_wire_message(wire);
+   pending_submits_.push_back(
+      PendingSubmit{.id = submit_id, .request_bytes = wire.size()});
+   return submit_id;
+}
 
-      const auto parsed = parse_incoming_message(line);
-      if (!parsed) continue;
+std::string StratumClient::submit_request_text(const ShareSubmission& share,
+                                               int id) const {
+   SubmitTemplate submit_template(worker_name_, share.job_id,
+                                  share.extranonce2_size);
+   return std::string(submit_template.fill(id, share.extranonce2_counter,
+                                           share.ntime, share.nonce));
+}
 
-      last_parsed_summary_ = debug_summary(*parsed);
+SubmitShareResult StratumClient::submit_share(const ShareSubmission& share) {
+   const int submit_id = queue_share(share);
+   (void)flush_writes(true);
 
-      if (std::holds_alternative<NotifyMessage>(*parsed)) {
-         last_raw_notify_ = line;
+   for (;;) {
+      const auto it = std::ranges::find(completed_submits_, submit_id,
+                                        &SubmitShareResult::id);
+      if (it != completed_submits_.end()) {
+         SubmitShareResult result = std::move(*it);
+         completed_submits_.erase(it);
+         return result;
       }
 
-      if (const auto* submit = std::get_if<SubmitResponse>(&*parsed)) {
-         if (submit->id != submit_id) {
-            (void)apply_parsed_message(*parsed, subscription_, current_job_,
-                                       difficulty_);
-            continue;
-         }
+      const std::string_view line = read_line();
+      if (line.empty()) continue;
 
-         SubmitShareResult result;
-         result.accepted = submit->accepted;
-         result.error_text = submit->error_text;
-         result.raw_request = wire;
-         result.raw_response = line;
-         return result;
+      const PollResult handled = handle_message(line);
+      if (handled.work_invalidated) {
+         deferred_invalidation_ = true;
+      }
+      if (handled.difficulty_changed) {
+         deferred_difficulty_change_ = true;
       }
-
-      (void)apply_parsed_message(*parsed, subscription_, current_job_,
-                                 difficulty_);
    }
 }
 
@@ -5,12 +5,23 @@
 
 #include <boost/asio.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "mining_job/job.hpp"
 #include "mining_job/share.hpp"
+#include "stratum_client/messages.hpp"
+#include "stratum_client/submit_template.hpp"
+#include "stratum_client/wire_capture.hpp"
+#include "stratum_client/write_batch.hpp"
 
 /*******************************************************************************
 Purpose:
@@ -22,6 +33,8 @@ Scope:
   - raw incoming JSON line before parse
   - last raw mining.notify line
   - last parsed message summary
+  - optional capture of every wire line, and replay of a capture in place
+    of the socket (stratum_client/wire_capture.hpp)
 
 Requirements:
   - no printing from StratumClient
@@ -41,66 +54,167 @@ Stop when:
 namespace cpu_miner {
 
 struct SubmitShareResult {
+   int id{};
    bool accepted{};
    std::string error_text;
-   std::string raw_request;
+   // Length of the submit line as sent; submit_request_text() rebuilds the
+   // text itself when a rejection needs it.
+   std::size_t request_bytes{};
    std::string raw_response;
 };
 
 struct PollResult {
    bool got_message{};
+   // A new job arrived; the work must be rebuilt.
    bool work_invalidated{};
+   // mining.set_difficulty changed the share difficulty; the job is
+   // unchanged, so only the share target needs replacing.
+   bool difficulty_changed{};
 };
 
 class StratumClient {
  public:
    StratumClient(std::string host, std::string port);
+   // Reads the pool's side of a captured session instead of a socket;
+   // writes are discarded. The end of the capture throws
+   // WireReplayFinished.
+   explicit StratumClient(WireReplay replay);
+
+   // Records every line read or written from now on.
+   void capture_to(std::unique_ptr<WireCaptureWriter> capture);
 
    void connect();
+   // Connecting and reading past `deadline` throw a system_error carrying
+   // boost::asio::error::timed_out; std::nullopt waits indefinitely.
+   void set_deadline(
+      std::optional<std::chrono::steady_clock::time_point> deadline) noexcept;
+   // Thread-safe. The blocked connect or read, and every later one, throws
+   // a system_error carrying operation_aborted; for shutdown.
+   void abort_io() noexcept;
    void subscribe();
    void suggest_difficulty(double difficulty);
    void authorize(const std::string& user, const std::string& password);
 
    void run_until_ready();
+   // Reads until a mining.notify newer than the current one has been applied.
+   void run_until_notify();
+
+   // Closes the socket and forgets per-connection state: buffered input,
+   // queued writes, unanswered submits and the subscription. The last job,
+   // difficulty, worker name and session id survive so a reconnect can
+   // resume and workers can keep hashing. Returns the number of unanswered
+   // submits that were dropped.
+   std::size_t reset_connection();
    [[nodiscard]] PollResult poll();
    [[nodiscard]] SubmitShareResult submit_share(const ShareSubmission& share);
 
+   // Pipelined submission: queue_share() serialises the share into the write
+   // batch and returns its request id; the response is matched by poll() and
+   // handed out by take_submit_result().
+   void set_write_batching(WriteBatchConfig config);
+   [[nodiscard]] int queue_share(const ShareSubmission& share);
+   // The line queue_share() sent for `share` as request `id`, rebuilt from a
+   // fresh template; for the cold rejection path only.
+   [[nodiscard]] std::string
+   submit_request_text(const ShareSubmission& share, int id) const;
+   // Writes the batch when it is due, or unconditionally with `force`.
+   // Returns true if anything was written.
+   bool flush_writes(bool force = false);
+   [[nodiscard]] std::optional<WriteBatch::clock::time_point>
+   write_deadline() const noexcept;
+   [[nodiscard]] bool take_submit_result(SubmitShareResult& out);
+   [[nodiscard]] std::size_t pending_submits() const noexcept;
+   [[nodiscard]] const WriteBatchStats& write_stats() const noexcept;
+
    [[nodiscard]] const std::string& worker_name() const noexcept;
    [[nodiscard]] const std::optional<SubscriptionContext>&
    subscription() const noexcept;
    [[nodiscard]] const std::optional<MiningJob>& current_job() const noexcept;
+   [[nodiscard]] const std::optional<DecodedJob>&
+   current_decoded_job() const noexcept;
    [[nodiscard]] double difficulty() const noexcept;
+   [[nodiscard]] const std::string& session_id() const noexcept;
+   [[nodiscard]] std::uint64_t notify_count() const noexcept;
+   // When the line carrying the current job was read off the socket.
+   [[nodiscard]] std::chrono::steady_clock::time_point
+   last_notify_received() const noexcept;
 
    [[nodiscard]] const std::string& last_raw_incoming() const noexcept;
    [[nodiscard]] const std::string& last_raw_outgoing() const noexcept;
    [[nodiscard]] const std::string& last_raw_notify() const noexcept;
-   [[nodiscard]] const std::string& last_parsed_summary() const noexcept;
+   // After a notify read on the fast path, formatted on first call rather
+   // than per notify.
+   [[nodiscard]] const std::string& last_parsed_summary() const;
 
  private:
-   void send_wire_message(const std::string& wire);
-   std::string read_line();
+   struct PendingSubmit {
+      int id{};
+      std::size_t request_bytes{};
+   };
+
+   void send_wire_message(std::string_view wire);
+   void queue_wire_message(std::string_view wire);
+   void complete_submit(const SubmitResponse& response, std::string_view line);
+   // The returned view points into buffer_ and stays valid until the next
+   // read_line() call.
+   std::string_view read_line();
+   // Runs io_ until `done`, waking regularly to honour the deadline and
+   // abort_io(); on either, closes the socket and throws.
+   void run_io_until(const bool& done, const char* what);
+   [[nodiscard]] bool buffered_line_available() const;
+   // Appends the next replayed pool line to buffer_, waiting until it is
+   // due if `wait`. Returns false if none was due.
+   bool buffer_replayed_line(bool wait);
+   [[nodiscard]] bool try_fast_notify(std::string_view line,
+                                      PollResult& result);
    [[nodiscard]] PollResult handle_message(std::string_view line);
    [[nodiscard]] bool ready() const noexcept;
+   [[nodiscard]] bool peer_closed();
 
    std::string host_;
    std::string port_;
+   std::optional<WireReplay> replay_;
+   std::unique_ptr<WireCaptureWriter> capture_;
 
    boost::asio::io_context io_;
    boost::asio::ip::tcp::resolver resolver_;
    boost::asio::ip::tcp::socket socket_;
    boost::asio::streambuf buffer_;
+   std::size_t pending_consume_{0};
+   std::optional<std::chrono::steady_clock::time_point> deadline_;
+   std::atomic<bool> io_aborted_{false};
+
+   NotifyMessage notify_scratch_;
+   DecodedJob decoded_scratch_;
+
+   SubmitTemplate submit_template_;
+   WriteBatch write_batch_;
+   std::vector<PendingSubmit> pending_submits_;
+   std::deque<SubmitShareResult> completed_submits_;
+
+   // Set when a message consumed inside submit_share() changed the work or
+   // the difficulty; the next poll() reports it so the caller still acts.
+   bool deferred_invalidation_{false};
+   bool deferred_difficulty_change_{false};
 
    int next_id_{1};
 
    std::optional<SubscriptionContext> subscription_;
    std::optional<MiningJob> current_job_;
+   std::optional<DecodedJob> current_decoded_job_;
    double difficulty_{1.0};
    std::string worker_name_;
+   std::string session_id_;
+   std::uint64_t notify_count_{0};
+   std::chrono::steady_clock::time_point last_line_received_{};
+   std::chrono::steady_clock::time_point last_notify_received_{};
 
    std::string last_raw_incoming_;
    std::string last_raw_outgoing_;
    std::string last_raw_notify_;
-   std::string last_parsed_summary_;
+   mutable std::string last_parsed_summary_;
+   // last_parsed_summary_ is owed for current_job_ and not yet formatted.
+   mutable bool summary_pending_{false};
 };
 
 } // namespace cpu_miner
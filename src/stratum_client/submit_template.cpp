@@ -0,0 +1,105 @@
+// src/stratum_client/submit_template.cpp
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "stratum_client/submit_template.hpp"
+#include "util/hex.hpp"
+
+namespace cpu_miner {
+namespace {
+
+// Enough for any non-negative int.
+constexpr std::size_t kIdSlotChars = 10U;
+
+void append_json_string(std::string& out, std::string_view s) {
+   static constexpr char digits[] = "0123456789abcdef";
+
+   out.push_back('"');
+   for (const char ch : s) {
+      const auto uch = static_cast<unsigned char>(ch);
+      if (ch == '"' || ch == '\\') {
+         out.push_back('\\');
+         out.push_back(ch);
+      } else if (uch < 0x20U) {
+         out += "\\u00";
+         out.push_back(digits[uch >> 4U]);
+         out.push_back(digits[uch & 0x0fU]);
+      } else {
+         out.push_back(ch);
+      }
+   }
+   out.push_back('"');
+}
+
+} // namespace
+
+SubmitTemplate::SubmitTemplate(std::string_view worker_name,
+                               std::string_view job_id,
+                               std::size_t extranonce2_size)
+   : worker_name_(worker_name)
+   , job_id_(job_id)
+   , extranonce2_size_(extranonce2_size) {
+   buffer_ = "{\"id\":";
+   id_offset_ = buffer_.size();
+   buffer_.append(kIdSlotChars, ' ');
+
+   buffer_ += ",\"method\":\"mining.submit\",\"params\":[";
+   append_json_string(buffer_, worker_name_);
+   buffer_.push_back(',');
+   append_json_string(buffer_, job_id_);
+
+   buffer_ += ",\"";
+   extranonce2_offset_ = buffer_.size();
+   buffer_.append(extranonce2_size_ * 2U, '0');
+
+   buffer_ += "\",\"";
+   ntime_offset_ = buffer_.size();
+   buffer_.append(8U, '0');
+
+   buffer_ += "\",\"";
+   nonce_offset_ = buffer_.size();
+   buffer_.append(8U, '0');
+
+   buffer_ += "\"]}";
+}
+
+bool SubmitTemplate::empty() const noexcept { return buffer_.empty(); }
+
+bool SubmitTemplate::matches(std::string_view worker_name,
+                             std::string_view job_id,
+                             std::size_t extranonce2_size) const noexcept {
+   return !empty() && extranonce2_size_ == extranonce2_size &&
+          job_id_ == job_id && worker_name_ == worker_name;
+}
+
+std::string_view SubmitTemplate::fill(int id, std::uint64_t extranonce2,
+                                      std::uint32_t ntime,
+                                      std::uint32_t nonce) noexcept {
+   char* const base = buffer_.data();
+
+   char digits[kIdSlotChars];
+   const auto [end, ec] = std::to_chars(digits, digits + kIdSlotChars, id);
+   const auto used = (ec == std::errc{})
+                        ? static_cast<std::size_t>(end - digits)
+                        : std::size_t{0};
+
+   char* const id_slot = base + id_offset_;
+   std::fill(id_slot, id_slot + (kIdSlotChars - used), ' ');
+   std::copy(digits, digits + used, id_slot + (kIdSlotChars - used));
+
+   hex_from_u64_be_into(extranonce2,
+                        std::span<char>(base + extranonce2_offset_,
+                                        extranonce2_size_ * 2U));
+   hex_from_u64_be_into(ntime, std::span<char>(base + ntime_offset_, 8U));
+   hex_from_u64_be_into(nonce, std::span<char>(base + nonce_offset_, 8U));
+
+   return buffer_;
+}
+
+} // namespace cpu_miner
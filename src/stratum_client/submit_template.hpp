@@ -0,0 +1,59 @@
+// src/stratum_client/submit_template.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_SUBMIT_TEMPLATE_HPP
+#define CPU_MINER_STRATUM_CLIENT_SUBMIT_TEMPLATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*******************************************************************************
+Purpose:
+  Pre-serialised mining.submit line for one (worker, job) pair. The
+  constant parts are written once; each share only overwrites fixed-offset
+  slots for id, extranonce2, ntime and nonce in a reused buffer.
+
+Requirements:
+  - byte-for-byte valid JSON accepted by ckpool
+  - no allocation in fill()
+
+Notes:
+  - The id slot is right-aligned and padded with JSON whitespace so every
+    other slot keeps a fixed offset regardless of the id's digit count.
+*******************************************************************************/
+
+namespace cpu_miner {
+
+class SubmitTemplate {
+ public:
+   SubmitTemplate() = default;
+   SubmitTemplate(std::string_view worker_name, std::string_view job_id,
+                  std::size_t extranonce2_size);
+
+   [[nodiscard]] bool empty() const noexcept;
+   [[nodiscard]] bool matches(std::string_view worker_name,
+                              std::string_view job_id,
+                              std::size_t extranonce2_size) const noexcept;
+
+   // Returns the wire line without a trailing newline. The view stays valid
+   // until the next fill() or assignment. `id` must be non-negative.
+   [[nodiscard]] std::string_view fill(int id, std::uint64_t extranonce2,
+                                       std::uint32_t ntime,
+                                       std::uint32_t nonce) noexcept;
+
+ private:
+   std::string worker_name_;
+   std::string job_id_;
+   std::size_t extranonce2_size_{};
+
+   std::string buffer_;
+   std::size_t id_offset_{};
+   std::size_t extranonce2_offset_{};
+   std::size_t ntime_offset_{};
+   std::size_t nonce_offset_{};
+};
+
+} // namespace cpu_miner
+
+#endif
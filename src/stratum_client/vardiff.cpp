@@ -0,0 +1,109 @@
+// src/stratum_client/vardiff.cpp
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "stratum_client/vardiff.hpp"
+
+namespace cpu_miner {
+namespace {
+
+// Closer samples are skipped: the control loop calls update() far more
+// often than the hash counters move meaningfully.
+constexpr std::chrono::seconds kMinSampleSpacing{1};
+
+} // namespace
+
+VardiffController::VardiffController(VardiffConfig config)
+   : config_(config), suggested_(config.initial_difficulty) {
+   if (!(config_.shares_per_minute > 0.0) ||
+       !std::isfinite(config_.shares_per_minute)) {
+      throw std::invalid_argument("vardiff share rate must be finite and > 0");
+   }
+   if (!(config_.hysteresis >= 1.0) || !std::isfinite(config_.hysteresis)) {
+      throw std::invalid_argument("vardiff hysteresis must be >= 1");
+   }
+   if (!(config_.initial_difficulty > 0.0) ||
+       !std::isfinite(config_.initial_difficulty)) {
+      throw std::invalid_argument(
+         "vardiff initial difficulty must be finite and > 0");
+   }
+   if (config_.averaging.count() <= 0) {
+      throw std::invalid_argument("vardiff averaging time must be > 0");
+   }
+}
+
+std::optional<double> VardiffController::update(std::uint64_t total_hashes,
+                                                clock::time_point now) {
+   if (!last_sample_) {
+      last_sample_ = Sample{.hashes = total_hashes, .at = now};
+      last_suggestion_at_ = now;
+      return std::nullopt;
+   }
+
+   const std::chrono::duration<double> dt = now - last_sample_->at;
+   if (dt < kMinSampleSpacing) return std::nullopt;
+
+   const std::uint64_t delta = total_hashes >= last_sample_->hashes
+                                  ? total_hashes - last_sample_->hashes
+                                  : 0U;
+   const double rate = static_cast<double>(delta) / dt.count();
+   last_sample_ = Sample{.hashes = total_hashes, .at = now};
+
+   if (!have_rate_) {
+      hashrate_hps_ = rate;
+      have_rate_ = true;
+   } else {
+      const std::chrono::duration<double> tau = config_.averaging;
+      const double alpha = 1.0 - std::exp(-dt / tau);
+      hashrate_hps_ += alpha * (rate - hashrate_hps_);
+   }
+
+   if (now - last_suggestion_at_ < config_.min_interval) return std::nullopt;
+
+   const double ideal = std::max(
+      config_.initial_difficulty,
+      hashrate_hps_ * 60.0 /
+         (config_.shares_per_minute * kHashesPerDifficulty1Share));
+   if (ideal <= suggested_ * config_.hysteresis &&
+       ideal >= suggested_ / config_.hysteresis) {
+      return std::nullopt;
+   }
+
+   suggested_ = ideal;
+   last_suggestion_at_ = now;
+   ++suggestions_;
+   return ideal;
+}
+
+double VardiffController::suggested() const noexcept { return suggested_; }
+
+double VardiffController::hashrate_hps() const noexcept {
+   return hashrate_hps_;
+}
+
+std::uint64_t VardiffController::suggestions() const noexcept {
+   return suggestions_;
+}
+
+VardiffSavings
+estimate_vardiff_savings(std::uint64_t hashes, double baseline_difficulty,
+                         std::uint64_t submits,
+                         std::uint64_t submit_wire_bytes) noexcept {
+   VardiffSavings savings{};
+   savings.submits = submits;
+   savings.baseline_submits =
+      static_cast<double>(hashes) /
+      (baseline_difficulty * kHashesPerDifficulty1Share);
+   savings.avoided_submits =
+      std::max(0.0, savings.baseline_submits - static_cast<double>(submits));
+   if (submits != 0U) {
+      savings.avoided_bytes = savings.avoided_submits *
+                              static_cast<double>(submit_wire_bytes) /
+                              static_cast<double>(submits);
+   }
+   return savings;
+}
+
+} // namespace cpu_miner
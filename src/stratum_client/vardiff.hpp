@@ -0,0 +1,95 @@
+// src/stratum_client/vardiff.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_VARDIFF_HPP
+#define CPU_MINER_STRATUM_CLIENT_VARDIFF_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+/*******************************************************************************
+Purpose:
+  Client-side vardiff: pick the mining.suggest_difficulty that keeps one
+  connection near a target share rate from the measured hashrate, so a fast
+  machine does not flood the control thread and the pool with submits at
+  difficulty 1. Kept free of I/O so the decisions can be tested directly.
+
+Scope:
+  - hashrate: exponential moving average of the cumulative hash count
+  - ideal difficulty: hashrate * 60 / (shares_per_minute * 2^32)
+  - savings estimate against a fixed baseline difficulty
+
+Requirements:
+  - hysteresis: suggest again only when the ideal difficulty differs from
+    the last suggestion by more than the hysteresis factor either way
+  - at most one suggestion per min_interval, the first one min_interval
+    after the first sample
+
+Notes:
+  - the pool decides; a suggestion it ignores is not repeated until the
+    hashrate moves past the hysteresis band again
+*******************************************************************************/
+
+namespace cpu_miner {
+
+// Expected hashes per share at difficulty 1.
+inline constexpr double kHashesPerDifficulty1Share = 4294967296.0;
+
+struct VardiffConfig {
+   double shares_per_minute{6.0};
+   double hysteresis{2.0};
+   // Time constant of the hashrate average.
+   std::chrono::seconds averaging{60};
+   std::chrono::seconds min_interval{60};
+   // Sent at every handshake until the controller suggests otherwise; also
+   // the floor for suggestions.
+   double initial_difficulty{1.0};
+};
+
+class VardiffController {
+ public:
+   using clock = std::chrono::steady_clock;
+
+   explicit VardiffController(VardiffConfig config = {});
+
+   // Feeds the cumulative hash count. Returns the difficulty to suggest when
+   // the measured rate calls for a new one.
+   [[nodiscard]] std::optional<double> update(std::uint64_t total_hashes,
+                                              clock::time_point now);
+
+   [[nodiscard]] double suggested() const noexcept;
+   [[nodiscard]] double hashrate_hps() const noexcept;
+   [[nodiscard]] std::uint64_t suggestions() const noexcept;
+
+ private:
+   struct Sample {
+      std::uint64_t hashes{};
+      clock::time_point at{};
+   };
+
+   VardiffConfig config_;
+   std::optional<Sample> last_sample_;
+   clock::time_point last_suggestion_at_{};
+   double hashrate_hps_{};
+   bool have_rate_{};
+   double suggested_;
+   std::uint64_t suggestions_{};
+};
+
+struct VardiffSavings {
+   // Submits expected from `hashes` at the baseline difficulty.
+   double baseline_submits{};
+   std::uint64_t submits{};
+   double avoided_submits{};
+   // avoided_submits at the measured wire bytes per submit round trip.
+   double avoided_bytes{};
+};
+
+[[nodiscard]] VardiffSavings
+estimate_vardiff_savings(std::uint64_t hashes, double baseline_difficulty,
+                         std::uint64_t submits,
+                         std::uint64_t submit_wire_bytes) noexcept;
+
+} // namespace cpu_miner
+
+#endif
@@ -0,0 +1,125 @@
+// src/stratum_client/wire_capture.cpp
+
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+#include "stratum_client/wire_capture.hpp"
+
+namespace cpu_miner {
+namespace {
+
+[[noreturn]] void throw_malformed(std::size_t line_number) {
+   throw std::runtime_error("wire capture: malformed line " +
+                            std::to_string(line_number));
+}
+
+} // namespace
+
+WireCaptureWriter::WireCaptureWriter(const std::filesystem::path& path,
+                                     std::string_view label)
+   : out_(path, std::ios::binary | std::ios::trunc),
+     start_(std::chrono::steady_clock::now()) {
+   if (!out_) {
+      throw std::runtime_error("wire capture: cannot open " + path.string());
+   }
+   out_ << "# cpu_miner stratum capture v1 " << label << '\n';
+}
+
+void WireCaptureWriter::record(WireDirection direction, std::string_view text) {
+   const auto offset = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start_);
+
+   out_ << offset.count() << ' '
+        << (direction == WireDirection::from_pool ? '<' : '>') << ' ' << text
+        << '\n';
+   // Pool traffic is a few lines a second; flushing keeps a capture usable
+   // after a crash.
+   out_.flush();
+}
+
+std::vector<WireLine> parse_wire_capture(std::istream& in) {
+   std::vector<WireLine> lines;
+   std::string raw;
+   std::size_t line_number = 0;
+
+   while (std::getline(in, raw)) {
+      ++line_number;
+      if (!raw.empty() && raw.back() == '\r') raw.pop_back();
+      if (raw.empty() || raw.front() == '#') continue;
+
+      long long micros = 0;
+      const char* begin = raw.data();
+      const char* end = raw.data() + raw.size();
+      const auto [after, ec] = std::from_chars(begin, end, micros);
+      if (ec != std::errc{} || micros < 0 || end - after < 3 ||
+          after[0] != ' ' || after[2] != ' ') {
+         throw_malformed(line_number);
+      }
+
+      WireLine line;
+      line.offset = std::chrono::microseconds(micros);
+      if (after[1] == '<') {
+         line.direction = WireDirection::from_pool;
+      } else if (after[1] == '>') {
+         line.direction = WireDirection::to_pool;
+      } else {
+         throw_malformed(line_number);
+      }
+      line.text.assign(after + 3, end);
+      lines.push_back(std::move(line));
+   }
+
+   return lines;
+}
+
+std::vector<WireLine> load_wire_capture(const std::filesystem::path& path) {
+   std::ifstream in(path, std::ios::binary);
+   if (!in) {
+      throw std::runtime_error("wire capture: cannot open " + path.string());
+   }
+   return parse_wire_capture(in);
+}
+
+WireReplay::WireReplay(std::vector<WireLine> lines, double speed)
+   : lines_(std::move(lines)), speed_(speed) {
+   if (!(speed_ >= 0.0) || !std::isfinite(speed_)) {
+      throw std::invalid_argument("replay speed must be finite and >= 0");
+   }
+   skip_outgoing();
+}
+
+void WireReplay::start(clock::time_point now) { start_ = now; }
+
+void WireReplay::skip_outgoing() noexcept {
+   while (next_ < lines_.size() &&
+          lines_[next_].direction != WireDirection::from_pool) {
+      ++next_;
+   }
+}
+
+std::optional<WireReplay::clock::time_point> WireReplay::next_due() const {
+   if (finished()) return std::nullopt;
+   if (speed_ == 0.0) return start_;
+
+   const std::chrono::duration<double, std::micro> scaled(
+      static_cast<double>(lines_[next_].offset.count()) / speed_);
+   return start_ + std::chrono::duration_cast<clock::duration>(scaled);
+}
+
+std::optional<std::string_view> WireReplay::take_due(clock::time_point now) {
+   const auto due = next_due();
+   if (!due || *due > now) return std::nullopt;
+
+   const std::string_view text = lines_[next_].text;
+   ++next_;
+   ++delivered_;
+   skip_outgoing();
+   return text;
+}
+
+bool WireReplay::finished() const noexcept { return next_ == lines_.size(); }
+
+std::size_t WireReplay::delivered() const noexcept { return delivered_; }
+
+} // namespace cpu_miner
@@ -0,0 +1,115 @@
+// src/stratum_client/wire_capture.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_WIRE_CAPTURE_HPP
+#define CPU_MINER_STRATUM_CLIENT_WIRE_CAPTURE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Record a Stratum session's wire lines with their timing, and play the
+  pool's side of a recording back into StratumClient in place of a socket,
+  so job switching, stale rates and parsing can be measured against real
+  pool traffic offline.
+
+Scope:
+  - capture file: one line per wire line, "<microseconds> <dir> <json>",
+    dir '<' from the pool and '>' to it; '#' lines are comments
+  - replay at the recorded pace, a multiple of it, or as fast as possible
+
+Requirements:
+  - capture costs the client one buffered file write per wire line
+  - replay delivers pool lines in recorded order, each no earlier than its
+    recorded offset (divided by the speed) after connect
+
+Do not:
+  - answer the miner's requests during replay: recorded responses carry the
+    recorded request ids, so submits in a replay are never completed
+
+Notes:
+  - offsets count from when the capture was opened, which is just before
+    the connection, so replay keeps the original handshake latency
+*******************************************************************************/
+
+namespace cpu_miner {
+
+enum class WireDirection {
+   from_pool,
+   to_pool,
+};
+
+struct WireLine {
+   std::chrono::microseconds offset{};
+   WireDirection direction{WireDirection::from_pool};
+   std::string text;
+
+   bool operator==(const WireLine&) const = default;
+};
+
+// Thrown by a replaying StratumClient once every recorded pool line has
+// been delivered; takes the place of the socket's end of file.
+class WireReplayFinished : public std::runtime_error {
+ public:
+   WireReplayFinished() : std::runtime_error("stratum replay finished") {}
+};
+
+class WireCaptureWriter {
+ public:
+   // Truncates `path`; `label` goes into the header comment.
+   WireCaptureWriter(const std::filesystem::path& path, std::string_view label);
+
+   void record(WireDirection direction, std::string_view text);
+
+ private:
+   std::ofstream out_;
+   std::chrono::steady_clock::time_point start_;
+};
+
+// Throws std::runtime_error naming the line number of a malformed line.
+[[nodiscard]] std::vector<WireLine> parse_wire_capture(std::istream& in);
+[[nodiscard]] std::vector<WireLine>
+load_wire_capture(const std::filesystem::path& path);
+
+class WireReplay {
+ public:
+   using clock = std::chrono::steady_clock;
+
+   // speed 1 is the recorded pace, 10 ten times faster; 0 does not wait.
+   WireReplay(std::vector<WireLine> lines, double speed);
+
+   // Starts the replay clock; called on connect.
+   void start(clock::time_point now);
+
+   // When the next pool line is due; std::nullopt once all were delivered.
+   [[nodiscard]] std::optional<clock::time_point> next_due() const;
+
+   // The next pool line if it is due at `now`. The view stays valid until
+   // the replay is moved or destroyed.
+   [[nodiscard]] std::optional<std::string_view>
+   take_due(clock::time_point now);
+
+   [[nodiscard]] bool finished() const noexcept;
+   [[nodiscard]] std::size_t delivered() const noexcept;
+
+ private:
+   void skip_outgoing() noexcept;
+
+   std::vector<WireLine> lines_;
+   double speed_;
+   std::size_t next_{0};
+   std::size_t delivered_{0};
+   clock::time_point start_{};
+};
+
+} // namespace cpu_miner
+
+#endif
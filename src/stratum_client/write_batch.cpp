@@ -0,0 +1,59 @@
+// src/stratum_client/write_batch.cpp
+
+#include "stratum_client/write_batch.hpp"
+
+namespace cpu_miner {
+namespace {
+
+constexpr char kNewline = '\n';
+
+} // namespace
+
+WriteBatch::WriteBatch(WriteBatchConfig config) { configure(config); }
+
+void WriteBatch::configure(WriteBatchConfig config) {
+   if (config.max_messages == 0U) config.max_messages = 1U;
+   if (config.max_linger.count() < 0) config.max_linger = {};
+   config_ = config;
+}
+
+const WriteBatchConfig& WriteBatch::config() const noexcept { return config_; }
+
+void WriteBatch::append(std::string_view line, clock::time_point now) {
+   if (count_ == 0U) oldest_ = now;
+   if (count_ == slots_.size()) slots_.emplace_back();
+
+   slots_[count_].assign(line);
+   ++count_;
+}
+
+bool WriteBatch::empty() const noexcept { return count_ == 0U; }
+
+std::size_t WriteBatch::size() const noexcept { return count_; }
+
+bool WriteBatch::due(clock::time_point now) const noexcept {
+   if (count_ == 0U) return false;
+   return count_ >= config_.max_messages || now >= deadline();
+}
+
+WriteBatch::clock::time_point WriteBatch::deadline() const noexcept {
+   return oldest_ + config_.max_linger;
+}
+
+const std::vector<boost::asio::const_buffer>& WriteBatch::buffers() {
+   gather_.clear();
+   for (std::size_t i = 0; i < count_; ++i) {
+      gather_.push_back(boost::asio::buffer(slots_[i]));
+      gather_.push_back(boost::asio::buffer(&kNewline, 1U));
+   }
+   return gather_;
+}
+
+void WriteBatch::clear() noexcept {
+   count_ = 0U;
+   gather_.clear();
+}
+
+const WriteBatchStats& WriteBatch::stats() const noexcept { return stats_; }
+
+} // namespace cpu_miner
@@ -0,0 +1,99 @@
+// src/stratum_client/write_batch.hpp
+
+#ifndef CPU_MINER_STRATUM_CLIENT_WRITE_BATCH_HPP
+#define CPU_MINER_STRATUM_CLIENT_WRITE_BATCH_HPP
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/write.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Coalesce outgoing Stratum lines so several queued messages leave in one
+  gather write (sendmsg with an iovec per line) instead of one write each.
+
+Requirements:
+  - lines are written in the order they were appended
+  - slot storage and the gather list are reused; steady state does not
+    allocate
+  - a line lingers no longer than max_linger, and a batch never holds more
+    than max_messages lines before it is due
+
+Notes:
+  - The default configuration (no linger, one message) reproduces the old
+    write-per-message behaviour.
+*******************************************************************************/
+
+namespace cpu_miner {
+
+struct WriteBatchConfig {
+   std::chrono::microseconds max_linger{0};
+   std::size_t max_messages{1};
+};
+
+struct WriteBatchStats {
+   std::uint64_t gather_writes{};
+   std::uint64_t lines_written{};
+};
+
+class WriteBatch {
+ public:
+   using clock = std::chrono::steady_clock;
+
+   WriteBatch() = default;
+   explicit WriteBatch(WriteBatchConfig config);
+
+   void configure(WriteBatchConfig config);
+   [[nodiscard]] const WriteBatchConfig& config() const noexcept;
+
+   // Copies `line` (without its trailing newline) into the next free slot.
+   void append(std::string_view line, clock::time_point now);
+
+   [[nodiscard]] bool empty() const noexcept;
+   [[nodiscard]] std::size_t size() const noexcept;
+
+   // True once the batch is full or its oldest line has lingered long enough.
+   [[nodiscard]] bool due(clock::time_point now) const noexcept;
+
+   // Latest time the batch may be flushed. Only meaningful when not empty().
+   [[nodiscard]] clock::time_point deadline() const noexcept;
+
+   // Newline-framed gather list over the queued lines. Valid until the next
+   // append() or clear().
+   [[nodiscard]] const std::vector<boost::asio::const_buffer>& buffers();
+
+   void clear() noexcept;
+
+   [[nodiscard]] const WriteBatchStats& stats() const noexcept;
+
+   // Writes every queued line with one gather write and empties the batch.
+   // Returns the number of bytes written; 0 when the batch was empty.
+   template<class SyncWriteStream>
+   std::size_t write_to(SyncWriteStream& stream) {
+      if (empty()) return 0U;
+
+      const std::size_t written = boost::asio::write(stream, buffers());
+      stats_.gather_writes += 1U;
+      stats_.lines_written += count_;
+      clear();
+      return written;
+   }
+
+ private:
+   WriteBatchConfig config_{};
+   std::vector<std::string> slots_;
+   std::size_t count_{0};
+   clock::time_point oldest_{};
+   std::vector<boost::asio::const_buffer> gather_;
+   WriteBatchStats stats_{};
+};
+
+} // namespace cpu_miner
+
+#endif
@@ -0,0 +1,95 @@
+// src/tools/journal_dump.cpp
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "mining_job/event_journal.hpp"
+#include "util/journal.hpp"
+
+/*******************************************************************************
+Purpose:
+  Post-mortem reader for the miner's event journal (cpu_miner --journal
+  PATH): prints every record still in the file, oldest first, with the
+  same text the miner printed live.
+
+Scope:
+  - one line of sequence number and UTC time per record, then its text
+  - a note where records were overwritten or left unfinished by a crash
+
+Requirements:
+  - read-only; safe to run while the miner is still writing the file
+*******************************************************************************/
+
+namespace {
+
+std::string utc_time(std::int64_t unix_ns) {
+   using namespace std::chrono;
+
+   const sys_time<nanoseconds> when{nanoseconds(unix_ns)};
+   const auto day = floor<days>(when);
+   const year_month_day ymd{day};
+   const hh_mm_ss<nanoseconds> time{when - day};
+
+   std::array<char, 48> stamp{};
+   std::snprintf(
+      stamp.data(), stamp.size(), "%04d-%02u-%02uT%02d:%02d:%02d.%06lldZ",
+      static_cast<int>(ymd.year()), static_cast<unsigned>(ymd.month()),
+      static_cast<unsigned>(ymd.day()), static_cast<int>(time.hours().count()),
+      static_cast<int>(time.minutes().count()),
+      static_cast<int>(time.seconds().count()),
+      static_cast<long long>(
+         duration_cast<microseconds>(time.subseconds()).count()));
+   return stamp.data();
+}
+
+} // namespace
+
+// Usage: journal_dump PATH
+int main(int argc, char* argv[]) {
+   try {
+      if (argc != 2) {
+         std::cerr << "usage: journal_dump PATH\n";
+         return 2;
+      }
+
+      const auto journal =
+         cpu_miner::util::MappedJournal::open_read_only(argv[1]);
+      cpu_miner::JournalRenderer renderer(journal.capacity());
+
+      const std::uint64_t end = journal.next_sequence();
+      std::uint64_t sequence = journal.oldest_sequence();
+      std::cout << "journal: " << argv[1] << ", records " << sequence << " to "
+                << end << " of capacity " << journal.capacity() << '\n';
+
+      cpu_miner::util::JournalRecord record;
+      for (; sequence < end; ++sequence) {
+         switch (journal.read(sequence, record)) {
+         case cpu_miner::util::JournalReadStatus::ok: {
+            const std::string text = renderer.render(record);
+            if (!text.empty()) {
+               std::cout << '#' << sequence << ' ' << utc_time(record.unix_ns)
+                         << '\n'
+                         << text;
+            }
+            break;
+         }
+         case cpu_miner::util::JournalReadStatus::pending:
+            std::cout << '#' << sequence << " unfinished\n";
+            break;
+         case cpu_miner::util::JournalReadStatus::overwritten:
+            std::cout << '#' << sequence << " overwritten\n";
+            break;
+         }
+      }
+
+      return 0;
+   } catch (const std::exception& ex) {
+      std::cerr << "fatal: " << ex.what() << '\n';
+      return 1;
+   }
+}
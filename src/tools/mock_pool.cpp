@@ -0,0 +1,654 @@
+// src/tools/mock_pool.cpp
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "mining_job/job.hpp"
+#include "mining_job/share_check.hpp"
+#include "mining_job/target.hpp"
+#include "sha256/sha256.hpp"
+#include "stratum_client/messages.hpp"
+#include "util/hex.hpp"
+
+/*******************************************************************************
+Purpose:
+  A local Stratum V1 pool for offline end-to-end runs of the miner. It speaks
+  the subset in doc/ckpool-derived-stratum-v1-spec.md, issues synthetic jobs
+  at a fixed rate, and validates every submitted share by rebuilding the
+  header with the miner's own prepare_work path.
+
+Scope:
+  - mining.subscribe (with session resume), mining.authorize,
+    mining.suggest_difficulty, mining.submit
+  - mining.set_difficulty and mining.notify on a timer
+  - accepted shares/s, rejects by reason, and notify-to-first-share latency
+
+Requirements:
+  - single-threaded: one io_context, no locks
+  - jobs are deterministic from their index so runs are reproducible
+  - a share is checked against the difficulty in force when its job was sent
+
+Do not:
+  - grow this into a real pool (no payouts, no vardiff, no block submission)
+
+Notes:
+  - --duration-s and --min-accepted make a run self-terminating with an exit
+    status, for CI.
+*******************************************************************************/
+
+namespace {
+
+using namespace std::chrono_literals;
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+// Common Stratum V1 error codes, as used by ckpool-style pools.
+constexpr int kErrorOther = 20;
+constexpr int kErrorJobNotFound = 21;
+constexpr int kErrorDuplicate = 22;
+constexpr int kErrorLowDifficulty = 23;
+constexpr int kErrorUnauthorized = 24;
+constexpr int kErrorNotSubscribed = 25;
+
+// Jobs kept valid between clean jobs.
+constexpr std::size_t kMaxLiveJobs = 16U;
+
+// Coinbase halves from a captured ckpool job; only their shape matters.
+constexpr std::string_view kSyntheticCoinb1 =
+   "0100000001000000000000000000000000000000000000000000000000000000"
+   "0000000000ffffffff3503405d0e0004f7cebc6904d997a02810";
+constexpr std::string_view kSyntheticCoinb2 =
+   "0a636b706f6f6c0d2f42697441786520427272722fffffffff02288aa1120000"
+   "0000160014f42e1a5f41c23247de0022aca1b069ca3e43e0bc00000000000000"
+   "00266a24aa21a9ed7f45ecf1c44f416bda0266b14e8f3e6c553963a34bee620a"
+   "6d34656dee710bd000000000";
+
+struct PoolOptions {
+   unsigned short port{3333};
+   std::chrono::milliseconds notify_interval{30000ms};
+   std::vector<double> difficulties{0.001};
+   std::size_t extranonce2_size{8U};
+   std::uint64_t clean_every{1U};
+   std::chrono::seconds duration{0s};
+   std::chrono::seconds report_interval{5s};
+   std::uint64_t min_accepted{0U};
+};
+
+struct PoolJob {
+   cpu_miner::MiningJob job;
+   cpu_miner::DecodedJob decoded;
+   double difficulty{};
+   cpu_miner::uint256 share_target{};
+   std::unordered_set<std::string> seen;
+};
+
+struct PoolStats {
+   std::uint64_t accepted{};
+   std::uint64_t blocks{};
+   std::uint64_t jobs{};
+   std::map<std::string, std::uint64_t> rejected;
+   std::vector<double> first_share_ms;
+};
+
+struct PoolState {
+   PoolOptions options;
+   std::deque<std::shared_ptr<PoolJob>> jobs;
+   std::uint64_t next_job_index{};
+   std::uint32_t start_ntime{};
+   std::uint32_t next_extranonce1{};
+   std::unordered_map<std::string, std::string> resumable;
+   PoolStats stats;
+   Clock::time_point started{Clock::now()};
+
+   [[nodiscard]] std::shared_ptr<PoolJob> find_job(std::string_view id) const {
+      for (const auto& job : jobs) {
+         if (job->job.job_id == id) return job;
+      }
+      return nullptr;
+   }
+};
+
+std::string hash_hex(std::string_view label, std::uint64_t index) {
+   const std::string seed = std::string(label) + std::to_string(index);
+   const std::span<const std::uint8_t> bytes(
+      reinterpret_cast<const std::uint8_t*>(seed.data()), seed.size());
+   return cpu_miner::bytes_to_hex(cpu_miner::sha256::digest_words_to_bytes_be(
+      cpu_miner::sha256::sha256_words(bytes)));
+}
+
+std::shared_ptr<PoolJob> make_job(const PoolState& state, std::uint64_t index,
+                                  bool clean) {
+   auto job = std::make_shared<PoolJob>();
+   job->job.job_id = cpu_miner::hex_from_u64_be(index, 8U);
+   job->job.prevhash = hash_hex("prevhash", index);
+   job->job.coinb1 = std::string(kSyntheticCoinb1);
+   job->job.coinb2 = std::string(kSyntheticCoinb2);
+   job->job.merkle_branch = {hash_hex("branch0", index),
+                             hash_hex("branch1", index)};
+   job->job.version = "20000000";
+   job->job.nbits = "1d00ffff";
+   job->job.ntime = cpu_miner::hex_from_u32_be(
+      state.start_ntime + static_cast<std::uint32_t>(index));
+   job->job.clean_jobs = clean;
+
+   const auto& difficulties = state.options.difficulties;
+   job->difficulty = difficulties[index % difficulties.size()];
+   job->share_target =
+      cpu_miner::share_target_from_difficulty(job->difficulty);
+   job->decoded = cpu_miner::decode_job(job->job);
+   return job;
+}
+
+cpu_miner::NotifyMessage to_notify(const cpu_miner::MiningJob& job,
+                                   bool clean) {
+   return cpu_miner::NotifyMessage{
+      .job_id = job.job_id,
+      .prevhash = job.prevhash,
+      .coinb1 = job.coinb1,
+      .coinb2 = job.coinb2,
+      .merkle_branch = job.merkle_branch,
+      .version = job.version,
+      .nbits = job.nbits,
+      .ntime = job.ntime,
+      .clean_jobs = clean,
+   };
+}
+
+class Session : public std::enable_shared_from_this<Session> {
+ public:
+   Session(tcp::socket socket, PoolState& state)
+      : socket_(std::move(socket))
+      , state_(state) {}
+
+   void start() {
+      endpoint_ = socket_.remote_endpoint().address().to_string();
+      read_next();
+   }
+
+   [[nodiscard]] bool open() const { return !closed_; }
+
+   void send_job(const PoolJob& job, bool clean) {
+      if (!authorized_) return;
+
+      if (sent_difficulty_ != job.difficulty) {
+         sent_difficulty_ = job.difficulty;
+         send(cpu_miner::to_wire_message(
+            cpu_miner::SetDifficultyMessage{.difficulty = job.difficulty}));
+      }
+
+      send(cpu_miner::to_wire_message(to_notify(job.job, clean)));
+      awaiting_job_ = job.job.job_id;
+      notified_at_ = Clock::now();
+   }
+
+ private:
+   void read_next() {
+      boost::asio::async_read_until(
+         socket_, buffer_, '\n',
+         [self = shared_from_this()](boost::system::error_code ec,
+                                     std::size_t bytes) {
+            if (ec) {
+               self->close();
+               return;
+            }
+
+            std::string line(bytes, '\0');
+            std::istream in(&self->buffer_);
+            in.read(line.data(), static_cast<std::streamsize>(bytes));
+            while (!line.empty() &&
+                   (line.back() == '\n' || line.back() == '\r')) {
+               line.pop_back();
+            }
+
+            if (!line.empty()) self->handle_line(line);
+            if (!self->closed_) self->read_next();
+         });
+   }
+
+   void handle_line(std::string_view line) {
+      const auto request = cpu_miner::parse_client_request(line);
+      if (!request) {
+         ++state_.stats.rejected["malformed request"];
+         return;
+      }
+
+      std::visit([&](const auto& body) { handle(request->id, body); },
+                 request->body);
+   }
+
+   void handle(int id, const cpu_miner::SubscribeRequest& request) {
+      const auto known = state_.resumable.find(request.session_id);
+      if (!request.session_id.empty() && known != state_.resumable.end()) {
+         extranonce1_ = known->second;
+      } else {
+         extranonce1_ = cpu_miner::hex_from_u32_be(++state_.next_extranonce1);
+      }
+
+      session_id_ = extranonce1_;
+      state_.resumable[session_id_] = extranonce1_;
+      subscribed_ = true;
+
+      send(cpu_miner::to_wire_message(cpu_miner::SubscribeResponse{
+         .id = id,
+         .extranonce1 = extranonce1_,
+         .extranonce2_size = state_.options.extranonce2_size,
+         .session_id = session_id_,
+      }));
+   }
+
+   void handle(int id, const cpu_miner::AuthorizeRequest& request) {
+      worker_ = request.user;
+      authorized_ = subscribed_;
+      send(cpu_miner::to_wire_result(id, authorized_));
+
+      if (authorized_ && !state_.jobs.empty()) {
+         send_job(*state_.jobs.back(), true);
+      }
+   }
+
+   void handle(int id, const cpu_miner::SuggestDifficultyRequest&) {
+      // Difficulty is driven by --difficulty; acknowledge and carry on.
+      send(cpu_miner::to_wire_result(id, true));
+   }
+
+   void handle(int id, const cpu_miner::SubmitShareRequest& request) {
+      if (!subscribed_) {
+         reject(id, kErrorNotSubscribed, "Not subscribed");
+         return;
+      }
+      if (!authorized_) {
+         reject(id, kErrorUnauthorized, "Unauthorized worker");
+         return;
+      }
+
+      const auto job = state_.find_job(request.job_id);
+      if (!job) {
+         reject(id, kErrorJobNotFound, "Job not found");
+         return;
+      }
+
+      const cpu_miner::SubscriptionContext subscription{
+         .extranonce1 = extranonce1_,
+         .extranonce2_size = state_.options.extranonce2_size,
+      };
+
+      const auto check = cpu_miner::check_share(
+         job->job, job->decoded, subscription, request.extranonce2_hex,
+         request.ntime_hex, request.nonce_hex, job->share_target);
+
+      if (check.verdict == cpu_miner::ShareVerdict::above_target) {
+         reject(id, kErrorLowDifficulty, "Low difficulty share");
+         return;
+      }
+      if (check.verdict != cpu_miner::ShareVerdict::accepted) {
+         reject(id, kErrorOther,
+                std::string(cpu_miner::to_string(check.verdict)));
+         return;
+      }
+
+      const std::string key = extranonce1_ + request.extranonce2_hex +
+                              request.ntime_hex + request.nonce_hex;
+      if (!job->seen.insert(key).second) {
+         reject(id, kErrorDuplicate, "Duplicate share");
+         return;
+      }
+
+      ++state_.stats.accepted;
+      if (check.block_candidate) ++state_.stats.blocks;
+
+      if (awaiting_job_ == request.job_id) {
+         const std::chrono::duration<double, std::milli> latency =
+            Clock::now() - notified_at_;
+         state_.stats.first_share_ms.push_back(latency.count());
+         awaiting_job_.clear();
+      }
+
+      send(cpu_miner::to_wire_result(id, true));
+   }
+
+   void reject(int id, int code, const std::string& reason) {
+      ++state_.stats.rejected[reason];
+      send(cpu_miner::to_wire_result(id, false, code, reason));
+   }
+
+   void send(std::string line) {
+      if (closed_) return;
+
+      line.push_back('\n');
+      outbox_.push_back(std::move(line));
+      if (outbox_.size() == 1U) write_next();
+   }
+
+   void write_next() {
+      boost::asio::async_write(
+         socket_, boost::asio::buffer(outbox_.front()),
+         [self = shared_from_this()](boost::system::error_code ec,
+                                     std::size_t) {
+            if (ec) {
+               self->close();
+               return;
+            }
+
+            self->outbox_.pop_front();
+            if (!self->outbox_.empty()) self->write_next();
+         });
+   }
+
+   void close() {
+      if (closed_) return;
+      closed_ = true;
+      outbox_.clear();
+
+      boost::system::error_code ignored;
+      socket_.close(ignored);
+      std::cout << "session " << session_id_ << " (" << endpoint_
+                << ") closed\n";
+   }
+
+   tcp::socket socket_;
+   PoolState& state_;
+   boost::asio::streambuf buffer_;
+   std::deque<std::string> outbox_;
+
+   std::string endpoint_;
+   std::string extranonce1_;
+   std::string session_id_;
+   std::string worker_;
+   bool subscribed_{};
+   bool authorized_{};
+   bool closed_{};
+   std::optional<double> sent_difficulty_;
+
+   // Job whose first accepted share has not been seen yet.
+   std::string awaiting_job_;
+   Clock::time_point notified_at_{};
+};
+
+double percentile(std::vector<double> samples, double p) {
+   if (samples.empty()) return 0.0;
+   std::sort(samples.begin(), samples.end());
+   const auto rank = static_cast<std::size_t>(
+      std::ceil(p * static_cast<double>(samples.size())));
+   return samples[std::clamp<std::size_t>(rank, 1U, samples.size()) - 1U];
+}
+
+void print_report(const PoolState& state, const char* label) {
+   const std::chrono::duration<double> elapsed = Clock::now() - state.started;
+   const auto& stats = state.stats;
+
+   std::uint64_t rejected = 0;
+   for (const auto& [reason, count] : stats.rejected) {
+      rejected += count;
+   }
+
+   std::ostringstream out;
+   out << std::fixed << std::setprecision(2);
+   out << label << ": " << elapsed.count() << " s, jobs " << stats.jobs
+       << ", accepted " << stats.accepted << " ("
+       << (elapsed.count() > 0.0
+              ? static_cast<double>(stats.accepted) / elapsed.count()
+              : 0.0)
+       << "/s), rejected " << rejected << ", blocks " << stats.blocks << '\n';
+
+   for (const auto& [reason, count] : stats.rejected) {
+      out << "  rejected[" << reason << "]: " << count << '\n';
+   }
+
+   const auto& lat = stats.first_share_ms;
+   if (!lat.empty()) {
+      out << "  notify->first share ms: n=" << lat.size()
+          << " min=" << *std::min_element(lat.begin(), lat.end())
+          << " p50=" << percentile(lat, 0.50)
+          << " p95=" << percentile(lat, 0.95)
+          << " max=" << *std::max_element(lat.begin(), lat.end()) << '\n';
+   }
+
+   std::cout << out.str() << std::flush;
+}
+
+class MockPool {
+ public:
+   MockPool(boost::asio::io_context& io, PoolOptions options)
+      : io_(io)
+      , acceptor_(io, tcp::endpoint(tcp::v4(), options.port))
+      , notify_timer_(io)
+      , report_timer_(io)
+      , stop_timer_(io)
+      , signals_(io, SIGINT, SIGTERM) {
+      state_.options = std::move(options);
+      state_.start_ntime = static_cast<std::uint32_t>(
+         std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+   }
+
+   void start() {
+      issue_job();
+      accept_next();
+      schedule_notify();
+      schedule_report();
+
+      if (state_.options.duration > 0s) {
+         stop_timer_.expires_after(state_.options.duration);
+         stop_timer_.async_wait([this](boost::system::error_code ec) {
+            if (!ec) stop();
+         });
+      }
+
+      signals_.async_wait([this](boost::system::error_code ec, int) {
+         if (!ec) stop();
+      });
+
+      std::cout << "mock_pool listening on port " << state_.options.port
+                << '\n';
+   }
+
+   [[nodiscard]] const PoolState& state() const { return state_; }
+
+ private:
+   void accept_next() {
+      acceptor_.async_accept(
+         [this](boost::system::error_code ec, tcp::socket socket) {
+            if (ec) return;
+
+            auto session = std::make_shared<Session>(std::move(socket), state_);
+            session->start();
+            sessions_.push_back(session);
+            accept_next();
+         });
+   }
+
+   void issue_job() {
+      const std::uint64_t index = state_.next_job_index++;
+      const bool clean = index % state_.options.clean_every == 0U;
+
+      if (clean) state_.jobs.clear();
+      state_.jobs.push_back(make_job(state_, index, clean));
+      while (state_.jobs.size() > kMaxLiveJobs) {
+         state_.jobs.pop_front();
+      }
+      ++state_.stats.jobs;
+
+      std::erase_if(sessions_, [](const std::weak_ptr<Session>& weak) {
+         const auto session = weak.lock();
+         return !session || !session->open();
+      });
+
+      for (const auto& weak : sessions_) {
+         if (const auto session = weak.lock()) {
+            session->send_job(*state_.jobs.back(), clean);
+         }
+      }
+   }
+
+   void schedule_notify() {
+      notify_timer_.expires_after(state_.options.notify_interval);
+      notify_timer_.async_wait([this](boost::system::error_code ec) {
+         if (ec) return;
+         issue_job();
+         schedule_notify();
+      });
+   }
+
+   void schedule_report() {
+      if (state_.options.report_interval <= 0s) return;
+
+      report_timer_.expires_after(state_.options.report_interval);
+      report_timer_.async_wait([this](boost::system::error_code ec) {
+         if (ec) return;
+         print_report(state_, "report");
+         schedule_report();
+      });
+   }
+
+   void stop() {
+      boost::system::error_code ignored;
+      acceptor_.close(ignored);
+      notify_timer_.cancel();
+      report_timer_.cancel();
+      stop_timer_.cancel();
+      signals_.cancel();
+      io_.stop();
+   }
+
+   boost::asio::io_context& io_;
+   tcp::acceptor acceptor_;
+   boost::asio::steady_timer notify_timer_;
+   boost::asio::steady_timer report_timer_;
+   boost::asio::steady_timer stop_timer_;
+   boost::asio::signal_set signals_;
+   std::vector<std::weak_ptr<Session>> sessions_;
+   PoolState state_;
+};
+
+std::vector<double> parse_difficulties(const std::string& value) {
+   std::vector<double> out;
+   std::istringstream in(value);
+   std::string item;
+
+   while (std::getline(in, item, ',')) {
+      std::size_t used = 0;
+      const double difficulty = std::stod(item, &used);
+      if (used != item.size() || !(difficulty > 0.0)) {
+         throw std::invalid_argument("bad difficulty: " + item);
+      }
+      out.push_back(difficulty);
+   }
+
+   if (out.empty()) throw std::invalid_argument("--difficulty needs a value");
+   return out;
+}
+
+std::uint64_t parse_count(const std::string& arg, const std::string& value) {
+   std::size_t used = 0;
+   const unsigned long long n = std::stoull(value, &used);
+   if (used != value.size()) {
+      throw std::invalid_argument(arg + ": not a number: " + value);
+   }
+   return static_cast<std::uint64_t>(n);
+}
+
+PoolOptions parse_options(int argc, char* argv[]) {
+   PoolOptions options;
+
+   for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (i + 1 >= argc) {
+         throw std::invalid_argument(arg + " needs a value");
+      }
+      const std::string value = argv[++i];
+
+      if (arg == "--port") {
+         const auto port = parse_count(arg, value);
+         if (port == 0U || port > 65535U) {
+            throw std::invalid_argument("--port out of range");
+         }
+         options.port = static_cast<unsigned short>(port);
+      } else if (arg == "--notify-ms") {
+         options.notify_interval =
+            std::chrono::milliseconds(parse_count(arg, value));
+         if (options.notify_interval <= 0ms) {
+            throw std::invalid_argument("--notify-ms must be positive");
+         }
+      } else if (arg == "--difficulty") {
+         options.difficulties = parse_difficulties(value);
+      } else if (arg == "--extranonce2-size") {
+         options.extranonce2_size = parse_count(arg, value);
+         if (options.extranonce2_size == 0U ||
+             options.extranonce2_size > 8U) {
+            throw std::invalid_argument("--extranonce2-size must be 1..8");
+         }
+      } else if (arg == "--clean-every") {
+         options.clean_every =
+            std::max<std::uint64_t>(parse_count(arg, value), 1U);
+      } else if (arg == "--duration-s") {
+         options.duration = std::chrono::seconds(parse_count(arg, value));
+      } else if (arg == "--report-s") {
+         options.report_interval =
+            std::chrono::seconds(parse_count(arg, value));
+      } else if (arg == "--min-accepted") {
+         options.min_accepted = parse_count(arg, value);
+      } else {
+         throw std::invalid_argument("unknown option: " + arg);
+      }
+   }
+
+   return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+   try {
+      const PoolOptions options = parse_options(argc, argv);
+      const std::uint64_t min_accepted = options.min_accepted;
+
+      boost::asio::io_context io;
+      MockPool pool(io, options);
+      pool.start();
+      io.run();
+
+      print_report(pool.state(), "final");
+
+      if (pool.state().stats.accepted < min_accepted) {
+         std::cerr << "error: accepted " << pool.state().stats.accepted
+                   << " shares, expected at least " << min_accepted << '\n';
+         return 2;
+      }
+
+      return 0;
+   } catch (const std::exception& ex) {
+      std::cerr << "fatal: " << ex.what() << '\n';
+      return 1;
+   }
+}
@@ -0,0 +1,139 @@
+// src/util/cycles.cpp
+
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+#include "util/cycles.hpp"
+
+namespace cpu_miner::util {
+namespace {
+
+struct RegisteredThread {
+   std::string name;
+   ThreadCycleCounters counters;
+};
+
+struct Registry {
+   std::mutex mutex;
+   std::deque<std::unique_ptr<RegisteredThread>> threads;
+};
+
+Registry& registry() {
+   static Registry instance;
+   return instance;
+}
+
+thread_local RegisteredThread* t_registered = nullptr;
+
+constexpr std::array<std::string_view, kCycleStageCount> kStageNames{
+   "hash",         "target_compare", "share_callback", "make_submission",
+   "queue_share",  "stale_check",    "backend_setup",
+};
+
+} // namespace
+
+std::string_view cycle_stage_name(CycleStage stage) noexcept {
+   return kStageNames[static_cast<std::size_t>(stage)];
+}
+
+bool cycle_stage_nested(CycleStage stage) noexcept {
+   return stage == CycleStage::make_submission ||
+          stage == CycleStage::queue_share;
+}
+
+std::string_view cycle_counter_source() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+   return "rdtsc";
+#elif defined(__aarch64__)
+   return "cntvct_el0";
+#else
+   return "steady_clock ns";
+#endif
+}
+
+ThreadCycleCounters& register_cycle_thread() {
+   if (t_registered == nullptr) {
+      auto& reg = registry();
+      std::lock_guard<std::mutex> lock(reg.mutex);
+      reg.threads.push_back(std::make_unique<RegisteredThread>());
+      t_registered = reg.threads.back().get();
+      t_registered->name = "thread " + std::to_string(reg.threads.size());
+   }
+   return t_registered->counters;
+}
+
+void name_cycle_thread(std::string name) {
+   if constexpr (!kCycleCountersEnabled) return;
+
+   (void)register_cycle_thread();
+
+   std::lock_guard<std::mutex> lock(registry().mutex);
+   t_registered->name = std::move(name);
+}
+
+std::vector<CycleSnapshot> snapshot_cycle_counters() {
+   auto& reg = registry();
+   std::lock_guard<std::mutex> lock(reg.mutex);
+
+   std::vector<CycleSnapshot> snapshots;
+   snapshots.reserve(reg.threads.size());
+   for (const auto& thread : reg.threads) {
+      CycleSnapshot snapshot;
+      snapshot.thread = thread->name;
+      for (std::size_t i = 0; i < kCycleStageCount; ++i) {
+         const auto stage = static_cast<CycleStage>(i);
+         snapshot.cycles[i] = thread->counters.cycles(stage);
+         snapshot.events[i] = thread->counters.events(stage);
+      }
+      snapshots.push_back(std::move(snapshot));
+   }
+   return snapshots;
+}
+
+void print_cycle_counters(std::ostream& out) {
+   if constexpr (!kCycleCountersEnabled) {
+      out << "cycle counters: not compiled in "
+             "(configure with -DCPU_MINER_ENABLE_CYCLE_COUNTERS=ON)\n";
+      return;
+   }
+
+   const auto snapshots = snapshot_cycle_counters();
+   out << "cycle counters (" << cycle_counter_source() << " ticks):\n";
+
+   for (const auto& snapshot : snapshots) {
+      std::uint64_t top_level = 0;
+      for (std::size_t i = 0; i < kCycleStageCount; ++i) {
+         if (!cycle_stage_nested(static_cast<CycleStage>(i))) {
+            top_level += snapshot.cycles[i];
+         }
+      }
+      if (top_level == 0U) continue;
+
+      out << "  " << snapshot.thread << ":\n";
+      for (std::size_t i = 0; i < kCycleStageCount; ++i) {
+         const auto stage = static_cast<CycleStage>(i);
+         const std::uint64_t cycles = snapshot.cycles[i];
+         const std::uint64_t events = snapshot.events[i];
+         if (events == 0U) continue;
+
+         const std::string label =
+            std::string(cycle_stage_nested(stage) ? "      " : "    ") +
+            std::string(cycle_stage_name(stage));
+         const double per_event =
+            static_cast<double>(cycles) / static_cast<double>(events);
+         const double share = 100.0 * static_cast<double>(cycles) /
+                              static_cast<double>(top_level);
+
+         out << std::left << std::setw(22) << label << std::right
+             << std::setw(18) << cycles << std::setw(14) << events
+             << std::fixed << std::setprecision(1) << std::setw(12)
+             << per_event << std::setw(7) << share << "%\n";
+      }
+   }
+}
+
+} // namespace cpu_miner::util
@@ -0,0 +1,184 @@
+// src/util/cycles.hpp
+
+#ifndef CPU_MINER_UTIL_CYCLES_HPP
+#define CPU_MINER_UTIL_CYCLES_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/sharded_counters.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <chrono>
+#endif
+
+/*******************************************************************************
+Purpose:
+  Per-stage cycle accounting for the hashing hot path, so a profile-free
+  build can say where a worker's time goes: hashing, target compares, share
+  callbacks, queueing, stale checks.
+
+Scope:
+  - compiled in only with CPU_MINER_CYCLE_COUNTERS (CMake option
+    CPU_MINER_ENABLE_CYCLE_COUNTERS); otherwise CycleScope and CycleLap are
+    empty and the hot path is unchanged
+  - raw counter ticks: rdtsc on x86, cntvct_el0 on arm64 (a fixed-frequency
+    timer, not core cycles), steady_clock nanoseconds elsewhere
+
+Requirements:
+  - each thread adds only to its own counters, with plain loads and stores;
+    no lock-prefixed or read-modify-write instructions on the hot path
+  - readers may snapshot at any time from another thread; a snapshot taken
+    mid-update can lag by one sample
+
+Notes:
+  - stages nest: share_callback includes make_submission and queue_share
+*******************************************************************************/
+
+namespace cpu_miner::util {
+
+#ifdef CPU_MINER_CYCLE_COUNTERS
+inline constexpr bool kCycleCountersEnabled = true;
+#else
+inline constexpr bool kCycleCountersEnabled = false;
+#endif
+
+enum class CycleStage : std::size_t {
+   hash,
+   target_compare,
+   share_callback,
+   make_submission,
+   queue_share,
+   stale_check,
+   backend_setup,
+};
+
+inline constexpr std::size_t kCycleStageCount = 7U;
+
+[[nodiscard]] std::string_view cycle_stage_name(CycleStage stage) noexcept;
+
+// True for stages counted inside another stage.
+[[nodiscard]] bool cycle_stage_nested(CycleStage stage) noexcept;
+
+[[nodiscard]] std::string_view cycle_counter_source() noexcept;
+
+[[nodiscard]] inline std::uint64_t read_cycles() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+   return __rdtsc();
+#elif defined(__aarch64__)
+   std::uint64_t ticks;
+   asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+   return ticks;
+#else
+   return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch())
+         .count());
+#endif
+}
+
+class alignas(kCacheLineBytes) ThreadCycleCounters {
+ public:
+   // Owning thread only.
+   void add(CycleStage stage, std::uint64_t cycles) noexcept {
+      const auto i = static_cast<std::size_t>(stage);
+      single_writer_add(cycles_[i], cycles);
+      single_writer_add(events_[i], 1U);
+   }
+
+   [[nodiscard]] std::uint64_t cycles(CycleStage stage) const noexcept {
+      return cycles_[static_cast<std::size_t>(stage)].load(
+         std::memory_order_relaxed);
+   }
+
+   [[nodiscard]] std::uint64_t events(CycleStage stage) const noexcept {
+      return events_[static_cast<std::size_t>(stage)].load(
+         std::memory_order_relaxed);
+   }
+
+ private:
+   std::array<std::atomic<std::uint64_t>, kCycleStageCount> cycles_{};
+   std::array<std::atomic<std::uint64_t>, kCycleStageCount> events_{};
+};
+
+// Registers the calling thread's counters; they outlive the thread so a
+// shutdown dump still sees exited workers.
+[[nodiscard]] ThreadCycleCounters& register_cycle_thread();
+
+[[nodiscard]] inline ThreadCycleCounters& thread_cycle_counters() {
+   thread_local ThreadCycleCounters* counters = &register_cycle_thread();
+   return *counters;
+}
+
+// Label for the calling thread in dumps (default "thread N").
+void name_cycle_thread(std::string name);
+
+struct CycleSnapshot {
+   std::string thread;
+   std::array<std::uint64_t, kCycleStageCount> cycles{};
+   std::array<std::uint64_t, kCycleStageCount> events{};
+};
+
+[[nodiscard]] std::vector<CycleSnapshot> snapshot_cycle_counters();
+
+// Per-thread table of ticks, events, ticks/event and share of the thread's
+// top-level total.
+void print_cycle_counters(std::ostream& out);
+
+// Charges the ticks between construction and destruction to one stage.
+class CycleScope {
+ public:
+#ifdef CPU_MINER_CYCLE_COUNTERS
+   explicit CycleScope(CycleStage stage) noexcept
+      : stage_(stage), start_(read_cycles()) {}
+
+   ~CycleScope() {
+      thread_cycle_counters().add(stage_, read_cycles() - start_);
+   }
+#else
+   explicit CycleScope(CycleStage /*stage*/) noexcept {}
+#endif
+
+   CycleScope(const CycleScope&) = delete;
+   CycleScope& operator=(const CycleScope&) = delete;
+
+#ifdef CPU_MINER_CYCLE_COUNTERS
+ private:
+   CycleStage stage_;
+   std::uint64_t start_;
+#endif
+};
+
+// Back-to-back stages with one counter read per boundary: mark(stage)
+// charges everything since the previous mark (or construction) to stage.
+class CycleLap {
+ public:
+#ifdef CPU_MINER_CYCLE_COUNTERS
+   CycleLap() noexcept
+      : counters_(&thread_cycle_counters()), last_(read_cycles()) {}
+
+   void mark(CycleStage stage) noexcept {
+      const std::uint64_t now = read_cycles();
+      counters_->add(stage, now - last_);
+      last_ = now;
+   }
+
+ private:
+   ThreadCycleCounters* counters_;
+   std::uint64_t last_;
+#else
+   void mark(CycleStage /*stage*/) noexcept {}
+#endif
+};
+
+} // namespace cpu_miner::util
+
+#endif
@@ -10,17 +10,272 @@
 #include <string_view>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace cpu_miner {
 namespace {
 
 constexpr char hex_digits[] = "0123456789abcdef";
 
-int hex_value(char ch) noexcept {
-   if (ch >= '0' && ch <= '9') return ch - '0';
-   if (ch >= 'a' && ch <= 'f') return 10 + (ch - 'a');
-   return -1;
+// 0xff marks anything that is not a lowercase hex digit.
+constexpr std::array<std::uint8_t, 256> make_decode_table() {
+   std::array<std::uint8_t, 256> table{};
+   for (auto& v : table) v = 0xffU;
+   for (int c = '0'; c <= '9'; ++c) {
+      table[static_cast<std::size_t>(c)] = static_cast<std::uint8_t>(c - '0');
+   }
+   for (int c = 'a'; c <= 'f'; ++c) {
+      table[static_cast<std::size_t>(c)] =
+         static_cast<std::uint8_t>(10 + (c - 'a'));
+   }
+   return table;
+}
+
+constexpr auto decode_table = make_decode_table();
+
+bool decode_scalar(const char* in, std::uint8_t* out,
+                   std::size_t out_len) noexcept {
+   std::uint8_t invalid = 0U;
+
+   for (std::size_t i = 0; i < out_len; ++i) {
+      const std::uint8_t hi =
+         decode_table[static_cast<unsigned char>(in[i * 2U])];
+      const std::uint8_t lo =
+         decode_table[static_cast<unsigned char>(in[i * 2U + 1U])];
+      invalid |= static_cast<std::uint8_t>((hi | lo) & 0xf0U);
+      out[i] = static_cast<std::uint8_t>((hi << 4U) | lo);
+   }
+
+   return invalid == 0U;
+}
+
+void encode_scalar(const std::uint8_t* in, char* out,
+                   std::size_t in_len) noexcept {
+   for (std::size_t i = 0; i < in_len; ++i) {
+      out[i * 2U] = hex_digits[(in[i] >> 4U) & 0x0fU];
+      out[i * 2U + 1U] = hex_digits[in[i] & 0x0fU];
+   }
+}
+
+#if defined(__SSE2__)
+
+// Map 16 ASCII bytes to nibble values. Lanes that are not lowercase hex are
+// cleared in `valid`. Bytes >= 0x80 compare as negative and fail both ranges.
+inline __m128i nibbles_from_ascii_16(__m128i c, __m128i& valid) noexcept {
+   const __m128i is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+   const __m128i is_alpha =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), c));
+   valid = _mm_or_si128(is_digit, is_alpha);
+
+   // 'a' - '0' - 10 == 39
+   return _mm_sub_epi8(_mm_sub_epi8(c, _mm_set1_epi8('0')),
+                       _mm_and_si128(is_alpha, _mm_set1_epi8(39)));
+}
+
+// Nibble pairs (hi at the even byte) to one byte per 16-bit lane.
+inline __m128i join_nibbles_16(__m128i n) noexcept {
+#if defined(__SSSE3__)
+   return _mm_maddubs_epi16(n, _mm_set1_epi16(0x0110));
+#else
+   const __m128i hi = _mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00ff)),
+                                     4);
+   return _mm_or_si128(hi, _mm_srli_epi16(n, 8));
+#endif
+}
+
+// Nibble values (0..15) to lowercase ASCII.
+inline __m128i ascii_from_nibbles_16(__m128i n) noexcept {
+#if defined(__SSSE3__)
+   const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                     '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+   return _mm_shuffle_epi8(lut, n);
+#else
+   const __m128i above_9 = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+   return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')),
+                       _mm_and_si128(above_9, _mm_set1_epi8(39)));
+#endif
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+std::size_t decode_simd(const char* in, std::uint8_t* out, std::size_t out_len,
+                        bool& ok) noexcept {
+   std::size_t done = 0;
+   __m256i all_valid = _mm256_set1_epi8(-1);
+
+   for (; done + 16U <= out_len; done += 16U) {
+      const __m256i c = _mm256_loadu_si256(
+         reinterpret_cast<const __m256i*>(in + done * 2U));
+
+      const __m256i is_digit =
+         _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+      const __m256i is_alpha =
+         _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), c));
+      all_valid =
+         _mm256_and_si256(all_valid, _mm256_or_si256(is_digit, is_alpha));
+
+      const __m256i n = _mm256_sub_epi8(
+         _mm256_sub_epi8(c, _mm256_set1_epi8('0')),
+         _mm256_and_si256(is_alpha, _mm256_set1_epi8(39)));
+      const __m256i words = _mm256_maddubs_epi16(n, _mm256_set1_epi16(0x0110));
+
+      const __m128i packed =
+         _mm_packus_epi16(_mm256_castsi256_si128(words),
+                          _mm256_extracti128_si256(words, 1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), packed);
+   }
+
+   ok = _mm256_movemask_epi8(all_valid) == -1;
+   return done;
 }
 
+std::size_t encode_simd(const std::uint8_t* in, char* out,
+                        std::size_t in_len) noexcept {
+   const __m256i lut = _mm256_setr_epi8(
+      '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd',
+      'e', 'f', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c',
+      'd', 'e', 'f');
+   const __m256i mask = _mm256_set1_epi8(0x0f);
+
+   std::size_t done = 0;
+   for (; done + 32U <= in_len; done += 32U) {
+      const __m256i b =
+         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + done));
+      const __m256i hi = _mm256_shuffle_epi8(
+         lut, _mm256_and_si256(_mm256_srli_epi16(b, 4), mask));
+      const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(b, mask));
+
+      // unpack works per 128-bit lane; stitch the lanes back into order.
+      const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+      const __m256i c = _mm256_unpackhi_epi8(hi, lo);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done * 2U),
+                          _mm256_permute2x128_si256(a, c, 0x20));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done * 2U + 32U),
+                          _mm256_permute2x128_si256(a, c, 0x31));
+   }
+
+   return done;
+}
+
+#elif defined(__SSE2__)
+
+std::size_t decode_simd(const char* in, std::uint8_t* out, std::size_t out_len,
+                        bool& ok) noexcept {
+   std::size_t done = 0;
+   __m128i all_valid = _mm_set1_epi8(-1);
+
+   for (; done + 8U <= out_len; done += 8U) {
+      const __m128i c =
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done * 2U));
+      __m128i valid;
+      const __m128i n = nibbles_from_ascii_16(c, valid);
+      all_valid = _mm_and_si128(all_valid, valid);
+
+      const __m128i words = join_nibbles_16(n);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out + done),
+                       _mm_packus_epi16(words, words));
+   }
+
+   ok = _mm_movemask_epi8(all_valid) == 0xffff;
+   return done;
+}
+
+std::size_t encode_simd(const std::uint8_t* in, char* out,
+                        std::size_t in_len) noexcept {
+   const __m128i mask = _mm_set1_epi8(0x0f);
+
+   std::size_t done = 0;
+   for (; done + 16U <= in_len; done += 16U) {
+      const __m128i b =
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+      const __m128i hi =
+         ascii_from_nibbles_16(_mm_and_si128(_mm_srli_epi16(b, 4), mask));
+      const __m128i lo = ascii_from_nibbles_16(_mm_and_si128(b, mask));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done * 2U),
+                       _mm_unpacklo_epi8(hi, lo));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done * 2U + 16U),
+                       _mm_unpackhi_epi8(hi, lo));
+   }
+
+   return done;
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+std::size_t decode_simd(const char* in, std::uint8_t* out, std::size_t out_len,
+                        bool& ok) noexcept {
+   std::size_t done = 0;
+   uint8x16_t all_valid = vdupq_n_u8(0xffU);
+
+   const auto nibbles = [&all_valid](uint8x16_t c) {
+      const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+      const uint8x16_t alpha = vsubq_u8(c, vdupq_n_u8('a'));
+      const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10U));
+      const uint8x16_t is_alpha = vcltq_u8(alpha, vdupq_n_u8(6U));
+      all_valid = vandq_u8(all_valid, vorrq_u8(is_digit, is_alpha));
+      return vbslq_u8(is_digit, digit, vaddq_u8(alpha, vdupq_n_u8(10U)));
+   };
+
+   for (; done + 16U <= out_len; done += 16U) {
+      // vld2 splits even (high nibble) and odd (low nibble) characters.
+      const uint8x16x2_t c =
+         vld2q_u8(reinterpret_cast<const std::uint8_t*>(in + done * 2U));
+      const uint8x16_t hi = nibbles(c.val[0]);
+      const uint8x16_t lo = nibbles(c.val[1]);
+      vst1q_u8(out + done, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+   }
+
+   ok = vminvq_u8(all_valid) == 0xffU;
+   return done;
+}
+
+std::size_t encode_simd(const std::uint8_t* in, char* out,
+                        std::size_t in_len) noexcept {
+   const uint8x16_t lut =
+      vld1q_u8(reinterpret_cast<const std::uint8_t*>(hex_digits));
+
+   std::size_t done = 0;
+   for (; done + 16U <= in_len; done += 16U) {
+      const uint8x16_t b = vld1q_u8(in + done);
+      uint8x16x2_t chars;
+      chars.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(b, 4));
+      chars.val[1] = vqtbl1q_u8(lut, vandq_u8(b, vdupq_n_u8(0x0fU)));
+      vst2q_u8(reinterpret_cast<std::uint8_t*>(out + done * 2U), chars);
+   }
+
+   return done;
+}
+
+#else
+
+std::size_t decode_simd(const char*, std::uint8_t*, std::size_t,
+                        bool& ok) noexcept {
+   ok = true;
+   return 0;
+}
+
+std::size_t encode_simd(const std::uint8_t*, char*, std::size_t) noexcept {
+   return 0;
+}
+
+#endif
+
 std::string hex_from_u32_impl(std::uint32_t value, bool little_endian) {
    std::string out(8U, '0');
 
@@ -36,6 +291,20 @@ std::string hex_from_u32_impl(std::uint32_t value, bool little_endian) {
    return out;
 }
 
+std::array<std::uint8_t, 4> decode_u32_hex(std::string_view hex,
+                                           const char* what) {
+   if (hex.size() != 8U) {
+      throw std::invalid_argument(std::string(what) + " requires 8 hex chars");
+   }
+
+   std::array<std::uint8_t, 4> bytes{};
+   if (!hex_decode_into(hex, bytes)) {
+      throw std::invalid_argument(std::string(what) +
+                                  " requires lowercase hex");
+   }
+   return bytes;
+}
+
 } // namespace
 
 bool is_lower_hex_digit(char ch) {
@@ -51,6 +320,31 @@ bool is_lower_hex_string(std::string_view s) {
    return true;
 }
 
+bool hex_decode_into(std::string_view hex,
+                     std::span<std::uint8_t> out) noexcept {
+   if ((hex.size() % 2U) != 0U) return false;
+   if (out.size() != hex.size() / 2U) return false;
+
+   bool simd_ok = true;
+   const std::size_t done =
+      decode_simd(hex.data(), out.data(), out.size(), simd_ok);
+
+   const bool tail_ok =
+      decode_scalar(hex.data() + done * 2U, out.data() + done,
+                    out.size() - done);
+
+   return simd_ok && tail_ok;
+}
+
+void hex_encode_into(std::span<const std::uint8_t> bytes,
+                     std::span<char> out) noexcept {
+   if (out.size() < bytes.size() * 2U) return;
+
+   const std::size_t done = encode_simd(bytes.data(), out.data(), bytes.size());
+   encode_scalar(bytes.data() + done, out.data() + done * 2U,
+                 bytes.size() - done);
+}
+
 std::string hex_from_u32_be(std::uint32_t value) {
    return hex_from_u32_impl(value, false);
 }
@@ -65,53 +359,42 @@ std::string hex_from_u64_be(std::uint64_t value, std::size_t size_bytes) {
    }
 
    std::string out(size_bytes * 2U, '0');
+   hex_from_u64_be_into(value, out);
+   return out;
+}
 
-   for (std::size_t i = 0; i < size_bytes; ++i) {
-      const std::size_t shift_bytes = size_bytes - 1U - i;
-      const auto shift_bits =
-         static_cast<unsigned>(shift_bytes * static_cast<std::size_t>(8U));
-      const std::uint8_t byte = static_cast<std::uint8_t>(value >> shift_bits);
-
-      out[i * 2U] = hex_digits[(byte >> 4U) & 0x0fU];
-      out[i * 2U + 1U] = hex_digits[byte & 0x0fU];
+void hex_from_u64_be_into(std::uint64_t value, std::span<char> out) noexcept {
+   for (std::size_t i = out.size(); i > 0U; --i) {
+      out[i - 1U] = hex_digits[value & 0x0fU];
+      value >>= 4U;
    }
-
-   return out;
 }
 
 std::vector<std::uint8_t> hex_to_bytes(std::string_view hex) {
-   if (!is_lower_hex_string(hex)) {
+   if ((hex.size() % 2U) != 0U) {
       throw std::invalid_argument(
          "hex_to_bytes requires lowercase even-length hex");
    }
 
-   std::vector<std::uint8_t> out;
-   out.reserve(hex.size() / 2U);
+   std::vector<std::uint8_t> out(hex.size() / 2U);
 
-   for (std::size_t i = 0; i < hex.size(); i += 2U) {
-      const int hi = hex_value(hex[i]);
-      const int lo = hex_value(hex[i + 1U]);
-
-      if (hi < 0 || lo < 0) {
-         throw std::invalid_argument(
-            "hex_to_bytes encountered invalid hex digit");
-      }
-
-      out.push_back(static_cast<std::uint8_t>((hi << 4) | lo));
+   if (!hex_decode_into(hex, out)) {
+      throw std::invalid_argument(
+         "hex_to_bytes encountered invalid hex digit");
    }
 
    return out;
 }
 
 std::array<std::uint8_t, 32> hex_to_array_32(std::string_view hex) {
-   const auto bytes = hex_to_bytes(hex);
-   if (bytes.size() != 32U) {
+   if (hex.size() != 64U) {
       throw std::invalid_argument("expected 32-byte hash hex");
    }
 
    std::array<std::uint8_t, 32> out{};
-   for (std::size_t i = 0; i < out.size(); ++i) {
-      out[i] = bytes[i];
+   if (!hex_decode_into(hex, out)) {
+      throw std::invalid_argument(
+         "hex_to_array_32 encountered invalid hex digit");
    }
    return out;
 }
@@ -119,46 +402,21 @@ std::array<std::uint8_t, 32> hex_to_array_32(std::string_view hex) {
 std::string bytes_to_hex(std::span<const std::uint8_t> bytes) {
    std::string out;
    out.resize(bytes.size() * 2U);
-
-   for (std::size_t i = 0; i < bytes.size(); ++i) {
-      const std::uint8_t byte = bytes[i];
-      out[i * 2U] = hex_digits[(byte >> 4U) & 0x0fU];
-      out[i * 2U + 1U] = hex_digits[byte & 0x0fU];
-   }
-
+   hex_encode_into(bytes, out);
    return out;
 }
 
 std::uint32_t u32_from_hex_be(std::string_view hex) {
-   if (hex.size() != 8U) {
-      throw std::invalid_argument("u32_from_hex_be requires 8 hex chars");
-   }
-   if (!is_lower_hex_string(hex)) {
-      throw std::invalid_argument("u32_from_hex_be requires lowercase hex");
-   }
+   const auto bytes = decode_u32_hex(hex, "u32_from_hex_be");
 
-   std::uint32_t value = 0U;
-   for (char ch : hex) {
-      const int v = hex_value(ch);
-      if (v < 0) {
-         throw std::invalid_argument(
-            "u32_from_hex_be encountered invalid hex digit");
-      }
-      value = static_cast<std::uint32_t>((value << 4U) |
-                                         static_cast<std::uint32_t>(v));
-   }
-   return value;
+   return (static_cast<std::uint32_t>(bytes[0]) << 24U) |
+          (static_cast<std::uint32_t>(bytes[1]) << 16U) |
+          (static_cast<std::uint32_t>(bytes[2]) << 8U) |
+          static_cast<std::uint32_t>(bytes[3]);
 }
 
 std::uint32_t u32_from_hex_le(std::string_view hex) {
-   if (hex.size() != 8U) {
-      throw std::invalid_argument("u32_from_hex_le requires 8 hex chars");
-   }
-   if (!is_lower_hex_string(hex)) {
-      throw std::invalid_argument("u32_from_hex_le requires lowercase hex");
-   }
-
-   const auto bytes = hex_to_bytes(hex);
+   const auto bytes = decode_u32_hex(hex, "u32_from_hex_le");
 
    return static_cast<std::uint32_t>(bytes[0]) |
           (static_cast<std::uint32_t>(bytes[1]) << 8U) |
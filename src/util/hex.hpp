@@ -21,6 +21,21 @@ namespace cpu_miner {
 [[nodiscard]] std::string hex_from_u64_be(std::uint64_t value,
                                           std::size_t size_bytes);
 
+// Write the low out.size() / 2 bytes of `value` as big-endian lowercase hex.
+// out.size() must be even and at most 16.
+void hex_from_u64_be_into(std::uint64_t value, std::span<char> out) noexcept;
+
+// Decode lowercase hex straight into `out`, validating as it goes. Fails on
+// odd length, when out.size() != hex.size() / 2, or on any character outside
+// [0-9a-f]. `out` contents are unspecified on failure.
+[[nodiscard]] bool hex_decode_into(std::string_view hex,
+                                   std::span<std::uint8_t> out) noexcept;
+
+// Encode `bytes` as lowercase hex into `out`, which must hold at least
+// 2 * bytes.size() characters; otherwise nothing is written.
+void hex_encode_into(std::span<const std::uint8_t> bytes,
+                     std::span<char> out) noexcept;
+
 [[nodiscard]] std::vector<std::uint8_t> hex_to_bytes(std::string_view hex);
 [[nodiscard]] std::array<std::uint8_t, 32>
 hex_to_array_32(std::string_view hex);
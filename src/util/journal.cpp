@@ -0,0 +1,228 @@
+// src/util/journal.cpp
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "util/journal.hpp"
+
+namespace cpu_miner::util {
+
+struct alignas(64) MappedJournal::Header {
+   std::array<char, 8> magic{};
+   std::uint32_t version{};
+   std::uint32_t record_size{};
+   std::uint64_t capacity{};
+   // Next sequence to reserve; shared by every appending thread.
+   std::uint64_t cursor{};
+};
+
+namespace {
+
+constexpr std::array<char, 8> kMagic{'C', 'P', 'U', 'M', 'J', 'R', 'N', '1'};
+constexpr std::uint32_t kVersion = 1U;
+
+static_assert(sizeof(JournalRecord) % 64U == 0U);
+
+[[nodiscard]] std::size_t mapped_size(std::size_t header_bytes,
+                                      std::size_t capacity) {
+   return header_bytes + capacity * sizeof(JournalRecord);
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+   throw std::system_error(errno, std::generic_category(), "journal: " + what);
+}
+
+void require_capacity(std::size_t capacity) {
+   if (capacity == 0U) {
+      throw std::invalid_argument("journal: zero capacity");
+   }
+}
+
+// Closes the descriptor once the mapping exists; the mapping keeps the file.
+class FileDescriptor {
+ public:
+   explicit FileDescriptor(int fd) : fd_(fd) {}
+   ~FileDescriptor() {
+      if (fd_ >= 0) ::close(fd_);
+   }
+   FileDescriptor(const FileDescriptor&) = delete;
+   FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+   [[nodiscard]] int get() const noexcept { return fd_; }
+
+ private:
+   int fd_;
+};
+
+} // namespace
+
+MappedJournal::MappedJournal(void* base, std::size_t mapped_bytes) noexcept
+   : header_(static_cast<Header*>(base)),
+     records_(reinterpret_cast<JournalRecord*>(static_cast<std::byte*>(base) +
+                                               sizeof(Header))),
+     mapped_bytes_(mapped_bytes) {}
+
+MappedJournal MappedJournal::create(const std::filesystem::path& path,
+                                    std::size_t capacity) {
+   require_capacity(capacity);
+   const std::size_t bytes = mapped_size(sizeof(Header), capacity);
+
+   const FileDescriptor fd(
+      ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+   if (fd.get() < 0) throw_errno("open " + path.string());
+   if (::ftruncate(fd.get(), static_cast<off_t>(bytes)) != 0) {
+      throw_errno("resize " + path.string());
+   }
+
+   void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       fd.get(), 0);
+   if (base == MAP_FAILED) throw_errno("map " + path.string());
+
+   // ftruncate zero-filled the records, so every commit word starts at 0.
+   auto* header = new (base) Header{};
+   header->magic = kMagic;
+   header->version = kVersion;
+   header->record_size = sizeof(JournalRecord);
+   header->capacity = capacity;
+   return MappedJournal(base, bytes);
+}
+
+MappedJournal MappedJournal::anonymous(std::size_t capacity) {
+   require_capacity(capacity);
+   const std::size_t bytes = mapped_size(sizeof(Header), capacity);
+
+   void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (base == MAP_FAILED) throw_errno("map anonymous");
+
+   auto* header = new (base) Header{};
+   header->magic = kMagic;
+   header->version = kVersion;
+   header->record_size = sizeof(JournalRecord);
+   header->capacity = capacity;
+   return MappedJournal(base, bytes);
+}
+
+MappedJournal
+MappedJournal::open_read_only(const std::filesystem::path& path) {
+   const FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+   if (fd.get() < 0) throw_errno("open " + path.string());
+
+   struct stat info{};
+   if (::fstat(fd.get(), &info) != 0) throw_errno("stat " + path.string());
+   const auto bytes = static_cast<std::size_t>(info.st_size);
+   if (bytes < sizeof(Header)) {
+      throw std::runtime_error("journal: " + path.string() + " is too short");
+   }
+
+   void* base = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd.get(), 0);
+   if (base == MAP_FAILED) throw_errno("map " + path.string());
+
+   MappedJournal journal(base, bytes);
+   const Header& header = *journal.header_;
+   if (header.magic != kMagic || header.version != kVersion ||
+       header.record_size != sizeof(JournalRecord) || header.capacity == 0U ||
+       mapped_size(sizeof(Header), header.capacity) > bytes) {
+      throw std::runtime_error("journal: " + path.string() +
+                               " is not a journal this build can read");
+   }
+   return journal;
+}
+
+MappedJournal::MappedJournal(MappedJournal&& other) noexcept
+   : header_(std::exchange(other.header_, nullptr)),
+     records_(std::exchange(other.records_, nullptr)),
+     mapped_bytes_(std::exchange(other.mapped_bytes_, 0U)) {}
+
+MappedJournal& MappedJournal::operator=(MappedJournal&& other) noexcept {
+   if (this != &other) {
+      if (header_ != nullptr) ::munmap(header_, mapped_bytes_);
+      header_ = std::exchange(other.header_, nullptr);
+      records_ = std::exchange(other.records_, nullptr);
+      mapped_bytes_ = std::exchange(other.mapped_bytes_, 0U);
+   }
+   return *this;
+}
+
+MappedJournal::~MappedJournal() {
+   if (header_ != nullptr) ::munmap(header_, mapped_bytes_);
+}
+
+std::size_t MappedJournal::capacity() const noexcept {
+   return static_cast<std::size_t>(header_->capacity);
+}
+
+std::uint64_t MappedJournal::next_sequence() const noexcept {
+   return std::atomic_ref<std::uint64_t>(header_->cursor)
+      .load(std::memory_order_acquire);
+}
+
+std::uint64_t MappedJournal::oldest_sequence() const noexcept {
+   const std::uint64_t next = next_sequence();
+   return next > header_->capacity ? next - header_->capacity : 0U;
+}
+
+std::uint64_t MappedJournal::append_bytes(std::uint32_t type,
+                                          const void* payload,
+                                          std::size_t size) noexcept {
+   const std::uint64_t sequence =
+      std::atomic_ref<std::uint64_t>(header_->cursor)
+         .fetch_add(1U, std::memory_order_relaxed);
+   JournalRecord& slot = records_[sequence % header_->capacity];
+   std::atomic_ref<std::uint64_t> commit(slot.commit);
+
+   // Readers of the slot's previous record see 0 and give up on it.
+   commit.store(0U, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_release);
+
+   slot.unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+   slot.type = type;
+   slot.payload_size = static_cast<std::uint32_t>(size);
+   std::memcpy(slot.payload.data(), payload, size);
+   std::memset(slot.payload.data() + size, 0, kJournalPayloadBytes - size);
+
+   commit.store(sequence + 1U, std::memory_order_release);
+   return sequence;
+}
+
+JournalReadStatus MappedJournal::read(std::uint64_t sequence,
+                                      JournalRecord& out) const noexcept {
+   if (sequence >= next_sequence()) return JournalReadStatus::pending;
+   if (sequence < oldest_sequence()) return JournalReadStatus::overwritten;
+
+   JournalRecord& slot = records_[sequence % header_->capacity];
+   std::atomic_ref<std::uint64_t> commit(slot.commit);
+
+   const std::uint64_t before = commit.load(std::memory_order_acquire);
+   if (before > sequence + 1U) return JournalReadStatus::overwritten;
+   if (before != sequence + 1U) {
+      // Either our writer is mid-record or a lapping writer is; only the
+      // cursor tells which.
+      return sequence < oldest_sequence() ? JournalReadStatus::overwritten
+                                          : JournalReadStatus::pending;
+   }
+
+   std::memcpy(static_cast<void*>(&out), &slot, sizeof(JournalRecord));
+   std::atomic_thread_fence(std::memory_order_acquire);
+
+   if (commit.load(std::memory_order_relaxed) != before) {
+      return JournalReadStatus::overwritten;
+   }
+   out.commit = before;
+   return JournalReadStatus::ok;
+}
+
+} // namespace cpu_miner::util
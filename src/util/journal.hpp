@@ -0,0 +1,140 @@
+// src/util/journal.hpp
+
+#ifndef CPU_MINER_UTIL_JOURNAL_HPP
+#define CPU_MINER_UTIL_JOURNAL_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <type_traits>
+
+/*******************************************************************************
+Purpose:
+  Append-only journal of fixed-size binary records in a memory-mapped ring.
+  A hot thread records an event with one slot copy; readers (the console,
+  a post-mortem dump of the file) consume records by sequence number later.
+
+Scope:
+  - 128-byte records: commit word, wall-clock time, type tag and the bytes
+    of any trivially copyable payload struct that fits
+  - file-backed, so the last capacity records survive the process, or
+    anonymous when nothing needs to outlive it
+  - any number of appending threads and readers
+
+Requirements:
+  - append() never blocks, allocates or makes a system call
+  - a reader that falls more than capacity records behind sees the lost
+    records as overwritten, never as torn data
+
+Do not:
+  - put pointers or owning types in payloads; the file outlives the process
+  - append to a journal opened with open_read_only()
+
+Notes:
+  - POSIX mmap; the file layout is native-endian and meant to be read on
+    the machine that wrote it
+*******************************************************************************/
+
+namespace cpu_miner::util {
+
+inline constexpr std::size_t kJournalPayloadBytes = 104U;
+
+struct alignas(64) JournalRecord {
+   // sequence + 1 once the record is complete; 0 while it is being written.
+   std::uint64_t commit{};
+   std::int64_t unix_ns{};
+   std::uint32_t type{};
+   std::uint32_t payload_size{};
+   std::array<std::byte, kJournalPayloadBytes> payload{};
+};
+
+static_assert(sizeof(JournalRecord) == 128U);
+
+// A payload names its record type tag as a static kJournalType member.
+template <typename T>
+concept JournalPayload =
+   std::is_trivially_copyable_v<T> && std::default_initializable<T> &&
+   sizeof(T) <= kJournalPayloadBytes &&
+   requires { static_cast<std::uint32_t>(T::kJournalType); };
+
+template <JournalPayload P>
+[[nodiscard]] constexpr std::uint32_t journal_type() noexcept {
+   return static_cast<std::uint32_t>(P::kJournalType);
+}
+
+// The record's payload as P, if its type tag is P's.
+template <JournalPayload P>
+[[nodiscard]] std::optional<P>
+journal_payload(const JournalRecord& record) noexcept {
+   if (record.type != journal_type<P>() || record.payload_size != sizeof(P)) {
+      return std::nullopt;
+   }
+   P payload;
+   std::memcpy(&payload, record.payload.data(), sizeof(P));
+   return payload;
+}
+
+enum class JournalReadStatus {
+   ok,
+   // Not appended yet, or its writer has not finished it.
+   pending,
+   // Lapped by writers; the record is gone.
+   overwritten,
+};
+
+class MappedJournal {
+ public:
+   // Creates or truncates a journal file with room for `capacity` records.
+   [[nodiscard]] static MappedJournal
+   create(const std::filesystem::path& path, std::size_t capacity);
+
+   // Process-private journal with no file behind it.
+   [[nodiscard]] static MappedJournal anonymous(std::size_t capacity);
+
+   // Maps a journal file written by create(), for reading only.
+   [[nodiscard]] static MappedJournal
+   open_read_only(const std::filesystem::path& path);
+
+   MappedJournal(MappedJournal&& other) noexcept;
+   MappedJournal& operator=(MappedJournal&& other) noexcept;
+   MappedJournal(const MappedJournal&) = delete;
+   MappedJournal& operator=(const MappedJournal&) = delete;
+   ~MappedJournal();
+
+   [[nodiscard]] std::size_t capacity() const noexcept;
+
+   // Sequence the next append() gets; every earlier one has been reserved.
+   [[nodiscard]] std::uint64_t next_sequence() const noexcept;
+
+   // Oldest sequence the ring can still hold.
+   [[nodiscard]] std::uint64_t oldest_sequence() const noexcept;
+
+   // Returns the record's sequence number.
+   template <JournalPayload P>
+   std::uint64_t append(const P& payload) noexcept {
+      return append_bytes(journal_type<P>(), &payload, sizeof(P));
+   }
+
+   [[nodiscard]] JournalReadStatus read(std::uint64_t sequence,
+                                        JournalRecord& out) const noexcept;
+
+ private:
+   struct Header;
+
+   MappedJournal(void* base, std::size_t mapped_bytes) noexcept;
+
+   std::uint64_t append_bytes(std::uint32_t type, const void* payload,
+                              std::size_t size) noexcept;
+
+   Header* header_{};
+   JournalRecord* records_{};
+   std::size_t mapped_bytes_{};
+};
+
+} // namespace cpu_miner::util
+
+#endif
@@ -0,0 +1,241 @@
+// src/util/log.cpp
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/log.hpp"
+#include "util/sharded_counters.hpp"
+
+namespace cpu_miner::util {
+namespace {
+
+struct RingRegistry {
+   std::mutex mutex;
+   std::deque<std::unique_ptr<LogRing>> rings;
+};
+
+RingRegistry& ring_registry() {
+   static RingRegistry instance;
+   return instance;
+}
+
+// Rings outlive their threads so the writer still drains a thread's last
+// records after it exits.
+LogRing& register_log_ring() {
+   auto& registry = ring_registry();
+   std::lock_guard<std::mutex> lock(registry.mutex);
+   registry.rings.push_back(std::make_unique<LogRing>());
+   return *registry.rings.back();
+}
+
+std::vector<LogRing*> registered_rings() {
+   auto& registry = ring_registry();
+   std::lock_guard<std::mutex> lock(registry.mutex);
+
+   std::vector<LogRing*> rings;
+   rings.reserve(registry.rings.size());
+   for (const auto& ring : registry.rings) {
+      rings.push_back(ring.get());
+   }
+   return rings;
+}
+
+void append_arg(std::string& out, const LogRecord& record, std::size_t arg,
+                std::size_t& offset) {
+   const char* data = record.payload.data() + offset;
+
+   if (record.types[arg] == LogArgType::str) {
+      const auto length =
+         static_cast<std::size_t>(static_cast<unsigned char>(data[0]));
+      out.append(data + 1, length);
+      offset += 1U + length;
+      return;
+   }
+
+   std::array<char, 32> buf{};
+   int written = 0;
+   switch (record.types[arg]) {
+   case LogArgType::u64: {
+      std::uint64_t value{};
+      std::memcpy(&value, data, 8U);
+      written = std::snprintf(buf.data(), buf.size(), "%llu",
+                              static_cast<unsigned long long>(value));
+      break;
+   }
+   case LogArgType::i64: {
+      std::int64_t value{};
+      std::memcpy(&value, data, 8U);
+      written = std::snprintf(buf.data(), buf.size(), "%lld",
+                              static_cast<long long>(value));
+      break;
+   }
+   case LogArgType::f64: {
+      double value{};
+      std::memcpy(&value, data, 8U);
+      written = std::snprintf(buf.data(), buf.size(), "%g", value);
+      break;
+   }
+   case LogArgType::boolean: {
+      std::uint64_t value{};
+      std::memcpy(&value, data, 8U);
+      written = std::snprintf(buf.data(), buf.size(), "%s",
+                              value != 0U ? "true" : "false");
+      break;
+   }
+   case LogArgType::str:
+      break;
+   }
+
+   out.append(buf.data(), static_cast<std::size_t>(std::max(written, 0)));
+   offset += 8U;
+}
+
+} // namespace
+
+std::string_view log_level_name(LogLevel level) noexcept {
+   switch (level) {
+   case LogLevel::debug:
+      return "DEBUG";
+   case LogLevel::info:
+      return "INFO";
+   case LogLevel::warn:
+      return "WARN";
+   case LogLevel::error:
+      return "ERROR";
+   }
+   return "?";
+}
+
+void submit_log_record(const LogRecord& record) noexcept {
+   thread_local LogRing* ring = &register_log_ring();
+   if (!ring->try_push(record)) ring->note_dropped();
+}
+
+std::string format_log_message(const LogRecord& record) {
+   std::string out;
+   const std::string_view format =
+      record.site != nullptr ? record.site->format : "";
+
+   std::size_t arg = 0;
+   std::size_t offset = 0;
+   for (std::size_t i = 0; i < format.size(); ++i) {
+      if (format[i] == '{' && i + 1U < format.size() &&
+          format[i + 1U] == '}' && arg < record.arg_count) {
+         append_arg(out, record, arg++, offset);
+         ++i;
+         continue;
+      }
+      out += format[i];
+   }
+
+   if (record.truncated) out += " [truncated]";
+   return out;
+}
+
+std::string format_log_line(const LogRecord& record) {
+   using namespace std::chrono;
+
+   const sys_time<nanoseconds> when{nanoseconds(record.unix_ns)};
+   const auto day = floor<days>(when);
+   const year_month_day ymd{day};
+   const hh_mm_ss<nanoseconds> time{when - day};
+
+   std::array<char, 48> stamp{};
+   std::snprintf(
+      stamp.data(), stamp.size(), "%04d-%02u-%02uT%02d:%02d:%02d.%06lldZ ",
+      static_cast<int>(ymd.year()), static_cast<unsigned>(ymd.month()),
+      static_cast<unsigned>(ymd.day()), static_cast<int>(time.hours().count()),
+      static_cast<int>(time.minutes().count()),
+      static_cast<int>(time.seconds().count()),
+      static_cast<long long>(
+         duration_cast<microseconds>(time.subseconds()).count()));
+
+   std::string line = stamp.data();
+   if (record.site != nullptr) {
+      line += log_level_name(record.site->level);
+      line += ' ';
+   }
+   line += format_log_message(record);
+   line += '\n';
+   return line;
+}
+
+bool LogRing::try_push(const LogRecord& record) noexcept {
+   const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+   if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return false;
+   }
+
+   slots_[tail % kCapacity] = record;
+   tail_.store(tail + 1U, std::memory_order_release);
+   return true;
+}
+
+bool LogRing::try_pop(LogRecord& record) noexcept {
+   const std::uint64_t head = head_.load(std::memory_order_relaxed);
+   if (head == tail_.load(std::memory_order_acquire)) return false;
+
+   record = slots_[head % kCapacity];
+   head_.store(head + 1U, std::memory_order_release);
+   return true;
+}
+
+void LogRing::note_dropped() noexcept { single_writer_add(dropped_, 1U); }
+
+LogWriter::LogWriter(std::FILE* out, std::chrono::milliseconds idle_poll)
+   : out_(out), idle_poll_(idle_poll) {
+   thread_ = std::jthread([this](std::stop_token stop_token) {
+      while (!stop_token.stop_requested()) {
+         if (drain() == 0U) std::this_thread::sleep_for(idle_poll_);
+      }
+      while (drain() != 0U) {
+      }
+   });
+}
+
+LogWriter::~LogWriter() {
+   thread_.request_stop();
+   if (thread_.joinable()) thread_.join();
+}
+
+std::size_t LogWriter::drain() {
+   std::vector<LogRecord> batch;
+   std::uint64_t drops = 0;
+
+   for (LogRing* ring : registered_rings()) {
+      drops += ring->dropped();
+
+      // Bounded per ring so one chatty thread cannot starve the others.
+      LogRecord record;
+      for (std::size_t i = 0; i < LogRing::kCapacity && ring->try_pop(record);
+           ++i) {
+         batch.push_back(record);
+      }
+   }
+
+   std::stable_sort(batch.begin(), batch.end(),
+                    [](const LogRecord& a, const LogRecord& b) {
+                       return a.unix_ns < b.unix_ns;
+                    });
+
+   std::string text;
+   for (const auto& record : batch) {
+      text += format_log_line(record);
+   }
+   if (drops > reported_drops_) {
+      text += "log: " + std::to_string(drops - reported_drops_) +
+              " records dropped (ring full)\n";
+      reported_drops_ = drops;
+   }
+
+   if (!text.empty()) {
+      std::fwrite(text.data(), 1U, text.size(), out_);
+      std::fflush(out_);
+   }
+   return batch.size();
+}
+
+} // namespace cpu_miner::util
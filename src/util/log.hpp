@@ -0,0 +1,251 @@
+// src/util/log.hpp
+
+#ifndef CPU_MINER_UTIL_LOG_HPP
+#define CPU_MINER_UTIL_LOG_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+/*******************************************************************************
+Purpose:
+  Logging that costs a hot thread one fixed-size record copy: the format
+  string stays static, the arguments are packed as binary, and a background
+  thread does all formatting and I/O.
+
+Scope:
+  - CPU_MINER_LOG_DEBUG/INFO/WARN/ERROR(format, args...) with {} placeholders
+  - integer, floating, bool and string arguments (strings are copied and
+    truncated to the record's payload)
+  - one SPSC ring per producing thread, drained by LogWriter
+
+Requirements:
+  - producers never block or allocate: a full ring drops the record and
+    counts it, and the writer reports the count
+  - levels below CPU_MINER_LOG_LEVEL (CMake cache variable, default info)
+    compile to nothing, arguments included
+  - format strings are string literals; the record stores only a pointer
+    to its static LogSite
+
+Do not:
+  - log from signal handlers
+*******************************************************************************/
+
+#ifndef CPU_MINER_LOG_LEVEL
+#define CPU_MINER_LOG_LEVEL 1
+#endif
+
+namespace cpu_miner::util {
+
+enum class LogLevel : std::uint8_t {
+   debug = 0,
+   info = 1,
+   warn = 2,
+   error = 3,
+};
+
+inline constexpr int kCompiledLogLevel = CPU_MINER_LOG_LEVEL;
+
+[[nodiscard]] constexpr bool log_enabled(LogLevel level) noexcept {
+   return static_cast<int>(level) >= kCompiledLogLevel;
+}
+
+[[nodiscard]] std::string_view log_level_name(LogLevel level) noexcept;
+
+// The static half of a log statement; its address is the record's format id.
+struct LogSite {
+   LogLevel level;
+   const char* format;
+};
+
+enum class LogArgType : std::uint8_t {
+   u64,
+   i64,
+   f64,
+   boolean,
+   str,
+};
+
+inline constexpr std::size_t kLogMaxArgs = 8U;
+inline constexpr std::size_t kLogPayloadBytes = 100U;
+
+struct alignas(64) LogRecord {
+   const LogSite* site{};
+   std::int64_t unix_ns{};
+   std::array<LogArgType, kLogMaxArgs> types{};
+   std::uint8_t arg_count{};
+   bool truncated{};
+   std::uint16_t payload_used{};
+   std::array<char, kLogPayloadBytes> payload{};
+};
+
+static_assert(sizeof(LogRecord) == 128U);
+
+namespace log_detail {
+
+inline void put_scalar(LogRecord& record, LogArgType type, const void* value) {
+   if (record.arg_count == kLogMaxArgs ||
+       record.payload_used + 8U > kLogPayloadBytes) {
+      record.truncated = true;
+      return;
+   }
+   std::memcpy(record.payload.data() + record.payload_used, value, 8U);
+   record.payload_used = static_cast<std::uint16_t>(record.payload_used + 8U);
+   record.types[record.arg_count++] = type;
+}
+
+// Strings are a one-byte length followed by the bytes.
+inline void put_string(LogRecord& record, std::string_view value) {
+   const std::size_t room = kLogPayloadBytes - record.payload_used;
+   if (record.arg_count == kLogMaxArgs || room < 1U) {
+      record.truncated = true;
+      return;
+   }
+
+   std::size_t length = std::min<std::size_t>({value.size(), room - 1U, 255U});
+   if (length < value.size()) record.truncated = true;
+
+   char* out = record.payload.data() + record.payload_used;
+   out[0] = static_cast<char>(static_cast<unsigned char>(length));
+   std::memcpy(out + 1, value.data(), length);
+   record.payload_used =
+      static_cast<std::uint16_t>(record.payload_used + 1U + length);
+   record.types[record.arg_count++] = LogArgType::str;
+}
+
+inline void put(LogRecord& record, bool value) {
+   const std::uint64_t bits = value ? 1U : 0U;
+   put_scalar(record, LogArgType::boolean, &bits);
+}
+
+template <std::integral T>
+   requires(!std::same_as<T, bool> && !std::same_as<T, char>)
+void put(LogRecord& record, T value) {
+   if constexpr (std::is_signed_v<T>) {
+      const auto wide = static_cast<std::int64_t>(value);
+      put_scalar(record, LogArgType::i64, &wide);
+   } else {
+      const auto wide = static_cast<std::uint64_t>(value);
+      put_scalar(record, LogArgType::u64, &wide);
+   }
+}
+
+template <std::floating_point T>
+void put(LogRecord& record, T value) {
+   const auto wide = static_cast<double>(value);
+   put_scalar(record, LogArgType::f64, &wide);
+}
+
+inline void put(LogRecord& record, std::string_view value) {
+   put_string(record, value);
+}
+
+inline void put(LogRecord& record, const char* value) {
+   put_string(record, value == nullptr ? std::string_view("(null)") : value);
+}
+
+inline void put(LogRecord& record, const std::string& value) {
+   put_string(record, value);
+}
+
+} // namespace log_detail
+
+// Hands the record to the calling thread's ring; drops it if the ring is
+// full. Never blocks.
+void submit_log_record(const LogRecord& record) noexcept;
+
+template <typename... Args>
+void log_write(const LogSite& site, const Args&... args) {
+   static_assert(sizeof...(Args) <= kLogMaxArgs, "too many log arguments");
+
+   LogRecord record;
+   record.site = &site;
+   record.unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+   (log_detail::put(record, args), ...);
+   submit_log_record(record);
+}
+
+// The message with {} placeholders filled in; no timestamp or level.
+[[nodiscard]] std::string format_log_message(const LogRecord& record);
+
+// One line as LogWriter writes it: UTC timestamp, level, message.
+[[nodiscard]] std::string format_log_line(const LogRecord& record);
+
+// Fixed-capacity single-producer single-consumer ring of records.
+class LogRing {
+ public:
+   static constexpr std::size_t kCapacity = 1024U;
+
+   [[nodiscard]] bool try_push(const LogRecord& record) noexcept;
+   [[nodiscard]] bool try_pop(LogRecord& record) noexcept;
+
+   // Producer-side count of records dropped because the ring was full.
+   [[nodiscard]] std::uint64_t dropped() const noexcept {
+      return dropped_.load(std::memory_order_relaxed);
+   }
+   void note_dropped() noexcept;
+
+ private:
+   std::array<LogRecord, kCapacity> slots_;
+   alignas(64) std::atomic<std::uint64_t> head_{0}; // next pop
+   alignas(64) std::atomic<std::uint64_t> tail_{0}; // next push
+   std::atomic<std::uint64_t> dropped_{0};
+};
+
+// Background thread that drains every ring, formats and writes. Records
+// from all threads are written in timestamp order within each drain pass.
+// Destruction drains what is left and joins.
+class LogWriter {
+ public:
+   explicit LogWriter(std::FILE* out,
+                      std::chrono::milliseconds idle_poll =
+                         std::chrono::milliseconds(2));
+   ~LogWriter();
+
+   LogWriter(const LogWriter&) = delete;
+   LogWriter& operator=(const LogWriter&) = delete;
+
+ private:
+   // Returns the number of records written.
+   std::size_t drain();
+
+   std::FILE* out_;
+   std::chrono::milliseconds idle_poll_;
+   std::uint64_t reported_drops_{};
+   std::jthread thread_;
+};
+
+} // namespace cpu_miner::util
+
+#define CPU_MINER_LOG(level, format, ...)                                     \
+   do {                                                                       \
+      if constexpr (::cpu_miner::util::log_enabled(level)) {                  \
+         static constexpr ::cpu_miner::util::LogSite cpu_miner_log_site{      \
+            level, format};                                                   \
+         ::cpu_miner::util::log_write(cpu_miner_log_site __VA_OPT__(, )       \
+                                         __VA_ARGS__);                        \
+      }                                                                       \
+   } while (false)
+
+#define CPU_MINER_LOG_DEBUG(...)                                              \
+   CPU_MINER_LOG(::cpu_miner::util::LogLevel::debug, __VA_ARGS__)
+#define CPU_MINER_LOG_INFO(...)                                               \
+   CPU_MINER_LOG(::cpu_miner::util::LogLevel::info, __VA_ARGS__)
+#define CPU_MINER_LOG_WARN(...)                                               \
+   CPU_MINER_LOG(::cpu_miner::util::LogLevel::warn, __VA_ARGS__)
+#define CPU_MINER_LOG_ERROR(...)                                              \
+   CPU_MINER_LOG(::cpu_miner::util::LogLevel::error, __VA_ARGS__)
+
+#endif
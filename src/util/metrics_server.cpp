@@ -0,0 +1,113 @@
+// src/util/metrics_server.cpp
+
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include <istream>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "util/metrics_server.hpp"
+#include "util/openmetrics.hpp"
+
+namespace cpu_miner::util {
+namespace {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+// Scrapers send a few hundred bytes of headers; anything larger is dropped.
+constexpr std::size_t kMaxRequestBytes = 8192U;
+
+std::string http_response(std::string_view status,
+                          std::string_view content_type,
+                          std::string_view body) {
+   std::string response = "HTTP/1.1 ";
+   response += status;
+   response += "\r\nContent-Type: ";
+   response += content_type;
+   response += "\r\nContent-Length: ";
+   response += std::to_string(body.size());
+   response += "\r\nConnection: close\r\n\r\n";
+   response += body;
+   return response;
+}
+
+struct Connection : std::enable_shared_from_this<Connection> {
+   Connection(tcp::socket s, const MetricsServer::Render& r)
+      : socket(std::move(s)), render(r), request(kMaxRequestBytes) {}
+
+   void start() {
+      auto self = shared_from_this();
+      asio::async_read_until(
+         socket, request, "\r\n\r\n",
+         [self](const boost::system::error_code& ec, std::size_t) {
+            if (ec) return;
+            self->respond();
+         });
+   }
+
+   void respond() {
+      std::istream in(&request);
+      std::string method;
+      std::string target;
+      in >> method >> target;
+
+      if (method != "GET") {
+         response = http_response("405 Method Not Allowed", "text/plain",
+                                  "GET only\n");
+      } else if (target != "/metrics") {
+         response = http_response("404 Not Found", "text/plain",
+                                  "try /metrics\n");
+      } else {
+         response = http_response("200 OK", kOpenMetricsContentType,
+                                  render());
+      }
+
+      auto self = shared_from_this();
+      asio::async_write(socket, asio::buffer(response),
+                        [self](const boost::system::error_code&, std::size_t) {
+                           boost::system::error_code ignored;
+                           self->socket.shutdown(tcp::socket::shutdown_both,
+                                                 ignored);
+                        });
+   }
+
+   tcp::socket socket;
+   const MetricsServer::Render& render;
+   asio::streambuf request;
+   std::string response;
+};
+
+} // namespace
+
+MetricsServer::MetricsServer(const std::string& bind_address,
+                             std::uint16_t port, Render render)
+   : render_(std::move(render))
+   , acceptor_(io_,
+               tcp::endpoint(asio::ip::make_address(bind_address), port)) {
+   port_ = acceptor_.local_endpoint().port();
+   accept_next();
+   thread_ = std::jthread([this]() { io_.run(); });
+}
+
+MetricsServer::~MetricsServer() {
+   io_.stop();
+   if (thread_.joinable()) thread_.join();
+}
+
+std::uint16_t MetricsServer::port() const noexcept { return port_; }
+
+void MetricsServer::accept_next() {
+   acceptor_.async_accept([this](const boost::system::error_code& ec,
+                                 tcp::socket socket) {
+      if (!ec) {
+         std::make_shared<Connection>(std::move(socket), render_)->start();
+      }
+      if (acceptor_.is_open()) accept_next();
+   });
+}
+
+} // namespace cpu_miner::util
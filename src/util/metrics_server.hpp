@@ -0,0 +1,60 @@
+// src/util/metrics_server.hpp
+
+#ifndef CPU_MINER_UTIL_METRICS_SERVER_HPP
+#define CPU_MINER_UTIL_METRICS_SERVER_HPP
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+/*******************************************************************************
+Purpose:
+  Serve GET /metrics over plain HTTP/1.1 for a Prometheus scraper, on a
+  thread of its own.
+
+Scope:
+  - one request per connection, answered and closed
+  - 404 for other paths, 405 for other methods
+
+Requirements:
+  - the render callback runs on the server thread; it must only read
+    atomics or other lock-free state so a scrape never stalls hashing
+  - the constructor binds or throws, so a bad port fails at startup
+
+Do not:
+  - grow this into a general HTTP server; no keep-alive, no TLS
+*******************************************************************************/
+
+namespace cpu_miner::util {
+
+class MetricsServer {
+ public:
+   using Render = std::function<std::string()>;
+
+   // Port 0 picks an ephemeral port; see port().
+   MetricsServer(const std::string& bind_address, std::uint16_t port,
+                 Render render);
+   ~MetricsServer();
+
+   MetricsServer(const MetricsServer&) = delete;
+   MetricsServer& operator=(const MetricsServer&) = delete;
+
+   [[nodiscard]] std::uint16_t port() const noexcept;
+
+ private:
+   void accept_next();
+
+   Render render_;
+   boost::asio::io_context io_;
+   boost::asio::ip::tcp::acceptor acceptor_;
+   std::uint16_t port_{};
+   std::jthread thread_;
+};
+
+} // namespace cpu_miner::util
+
+#endif
@@ -0,0 +1,174 @@
+// src/util/openmetrics.cpp
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <system_error>
+
+#include "util/openmetrics.hpp"
+
+namespace cpu_miner::util {
+namespace {
+
+void append_label_value(std::string& out, std::string_view value) {
+   for (const char c : value) {
+      switch (c) {
+      case '\\':
+         out += "\\\\";
+         break;
+      case '"':
+         out += "\\\"";
+         break;
+      case '\n':
+         out += "\\n";
+         break;
+      default:
+         out += c;
+         break;
+      }
+   }
+}
+
+void append_double(std::string& out, double value) {
+   if (std::isnan(value)) {
+      out += "NaN";
+      return;
+   }
+   if (std::isinf(value)) {
+      out += value > 0.0 ? "+Inf" : "-Inf";
+      return;
+   }
+
+   std::array<char, 32> buf{};
+   const auto [end, ec] =
+      std::to_chars(buf.data(), buf.data() + buf.size(), value);
+   if (ec != std::errc{}) {
+      out += "NaN";
+      return;
+   }
+   out.append(buf.data(), end);
+}
+
+} // namespace
+
+void LatencyHistogram::observe(std::chrono::nanoseconds latency) noexcept {
+   const double seconds = std::chrono::duration<double>(latency).count();
+
+   std::size_t bucket = 0;
+   while (bucket < kBoundsSeconds.size() && seconds > kBoundsSeconds[bucket]) {
+      ++bucket;
+   }
+
+   buckets_[bucket].fetch_add(1U, std::memory_order_relaxed);
+   sum_ns_.fetch_add(static_cast<std::uint64_t>(std::max<std::int64_t>(
+                        latency.count(), 0)),
+                     std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const noexcept {
+   Snapshot snapshot;
+   for (std::size_t i = 0; i < buckets_.size(); ++i) {
+      snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+      snapshot.count += snapshot.buckets[i];
+   }
+   snapshot.sum_seconds =
+      static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / 1e9;
+   return snapshot;
+}
+
+void OpenMetricsWriter::family(std::string_view name, std::string_view type,
+                               std::string_view help, std::string_view unit) {
+   text_ += "# TYPE ";
+   text_ += name;
+   text_ += ' ';
+   text_ += type;
+   text_ += '\n';
+
+   if (!unit.empty()) {
+      text_ += "# UNIT ";
+      text_ += name;
+      text_ += ' ';
+      text_ += unit;
+      text_ += '\n';
+   }
+
+   text_ += "# HELP ";
+   text_ += name;
+   text_ += ' ';
+   text_ += help;
+   text_ += '\n';
+}
+
+void OpenMetricsWriter::write_sample_prefix(std::string_view name,
+                                            const MetricLabels& labels) {
+   text_ += name;
+   if (!labels.empty()) {
+      text_ += '{';
+      for (std::size_t i = 0; i < labels.size(); ++i) {
+         if (i != 0U) text_ += ',';
+         text_ += labels[i].first;
+         text_ += "=\"";
+         append_label_value(text_, labels[i].second);
+         text_ += '"';
+      }
+      text_ += '}';
+   }
+   text_ += ' ';
+}
+
+void OpenMetricsWriter::sample(std::string_view name,
+                               const MetricLabels& labels,
+                               std::uint64_t value) {
+   write_sample_prefix(name, labels);
+   text_ += std::to_string(value);
+   text_ += '\n';
+}
+
+void OpenMetricsWriter::sample(std::string_view name,
+                               const MetricLabels& labels, double value) {
+   write_sample_prefix(name, labels);
+   append_double(text_, value);
+   text_ += '\n';
+}
+
+void OpenMetricsWriter::counter(std::string_view name, std::string_view help,
+                                std::uint64_t value) {
+   family(name, "counter", help);
+   sample(std::string(name) + "_total", {}, value);
+}
+
+void OpenMetricsWriter::gauge(std::string_view name, std::string_view help,
+                              double value, std::string_view unit) {
+   family(name, "gauge", help, unit);
+   sample(name, {}, value);
+}
+
+void OpenMetricsWriter::histogram(std::string_view name,
+                                  std::string_view help,
+                                  std::string_view unit,
+                                  const LatencyHistogram::Snapshot& snapshot) {
+   family(name, "histogram", help, unit);
+
+   const std::string bucket_name = std::string(name) + "_bucket";
+   std::uint64_t cumulative = 0;
+   for (std::size_t i = 0; i < LatencyHistogram::kBoundsSeconds.size(); ++i) {
+      cumulative += snapshot.buckets[i];
+
+      // OpenMetrics wants canonical floats for le: "1.0", not "1".
+      std::string bound;
+      append_double(bound, LatencyHistogram::kBoundsSeconds[i]);
+      if (bound.find_first_of(".e") == std::string::npos) bound += ".0";
+      sample(bucket_name, {{"le", bound}}, cumulative);
+   }
+   sample(bucket_name, {{"le", "+Inf"}}, snapshot.count);
+   sample(std::string(name) + "_count", {}, snapshot.count);
+   sample(std::string(name) + "_sum", {}, snapshot.sum_seconds);
+}
+
+std::string OpenMetricsWriter::finish() {
+   text_ += "# EOF\n";
+   return std::move(text_);
+}
+
+} // namespace cpu_miner::util
@@ -0,0 +1,99 @@
+// src/util/openmetrics.hpp
+
+#ifndef CPU_MINER_UTIL_OPENMETRICS_HPP
+#define CPU_MINER_UTIL_OPENMETRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Build OpenMetrics text exposition (the format Prometheus scrapes) from
+  values the caller has already snapshotted.
+
+Scope:
+  - counter, gauge and histogram families with optional labels
+  - a lock-free fixed-bucket latency histogram for the recording side
+
+Requirements:
+  - counters are emitted as <name>_total under a "# TYPE <name> counter"
+    family, histograms as _bucket/_sum/_count, and the text ends in # EOF
+  - label values are escaped (backslash, quote, newline)
+
+Do not:
+  - read shared miner state here; callers pass plain values
+*******************************************************************************/
+
+namespace cpu_miner::util {
+
+inline constexpr std::string_view kOpenMetricsContentType =
+   "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+// Submit-to-response style latencies, in seconds.
+class LatencyHistogram {
+ public:
+   static constexpr std::array<double, 11> kBoundsSeconds{
+      0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0,
+   };
+
+   struct Snapshot {
+      // Non-cumulative; the last entry counts observations above every
+      // bound.
+      std::array<std::uint64_t, kBoundsSeconds.size() + 1U> buckets{};
+      double sum_seconds{};
+      std::uint64_t count{};
+   };
+
+   void observe(std::chrono::nanoseconds latency) noexcept;
+
+   [[nodiscard]] Snapshot snapshot() const noexcept;
+
+ private:
+   std::array<std::atomic<std::uint64_t>, kBoundsSeconds.size() + 1U>
+      buckets_{};
+   std::atomic<std::uint64_t> sum_ns_{0};
+};
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+class OpenMetricsWriter {
+ public:
+   // Starts a family; type is "counter", "gauge" or "histogram".
+   void family(std::string_view name, std::string_view type,
+               std::string_view help, std::string_view unit = {});
+
+   // One sample line. For counters pass name + "_total".
+   void sample(std::string_view name, const MetricLabels& labels,
+               std::uint64_t value);
+   void sample(std::string_view name, const MetricLabels& labels,
+               double value);
+
+   // Single-sample families.
+   void counter(std::string_view name, std::string_view help,
+                std::uint64_t value);
+   void gauge(std::string_view name, std::string_view help, double value,
+              std::string_view unit = {});
+
+   void histogram(std::string_view name, std::string_view help,
+                  std::string_view unit,
+                  const LatencyHistogram::Snapshot& snapshot);
+
+   // The exposition, terminated by "# EOF".
+   [[nodiscard]] std::string finish();
+
+ private:
+   void write_sample_prefix(std::string_view name, const MetricLabels& labels);
+
+   std::string text_;
+};
+
+} // namespace cpu_miner::util
+
+#endif
@@ -0,0 +1,85 @@
+// src/util/rapl.cpp
+
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "util/rapl.hpp"
+
+namespace cpu_miner::util {
+namespace {
+
+[[nodiscard]] std::optional<std::uint64_t>
+read_counter(const std::filesystem::path& file) {
+   std::ifstream in(file);
+   std::uint64_t value{};
+   if (!(in >> value)) return std::nullopt;
+   return value;
+}
+
+[[nodiscard]] bool is_package_zone(const std::filesystem::path& dir) {
+   std::ifstream in(dir / "name");
+   std::string name;
+   return static_cast<bool>(in >> name) && name.starts_with("package");
+}
+
+} // namespace
+
+RaplEnergyMeter::RaplEnergyMeter(std::vector<Zone> zones)
+   : zones_(std::move(zones)) {}
+
+std::optional<RaplEnergyMeter>
+RaplEnergyMeter::open(const std::filesystem::path& powercap_root) {
+   std::error_code ec;
+   std::filesystem::directory_iterator it(powercap_root, ec);
+   if (ec) return std::nullopt;
+
+   std::vector<Zone> zones;
+   for (const auto& entry : it) {
+      const auto dir = entry.path();
+      const std::string leaf = dir.filename().string();
+
+      // intel-rapl:0 is a package; intel-rapl:0:1 is one of its subzones.
+      const auto colon = leaf.find(':');
+      if (colon == std::string::npos ||
+          leaf.find(':', colon + 1U) != std::string::npos) {
+         continue;
+      }
+      if (!is_package_zone(dir)) continue;
+
+      const auto energy = read_counter(dir / "energy_uj");
+      const auto range = read_counter(dir / "max_energy_range_uj");
+      if (!energy || !range) continue;
+
+      zones.push_back(Zone{
+         .energy_file = dir / "energy_uj",
+         .max_range_uj = *range,
+         .last_uj = *energy,
+      });
+   }
+
+   if (zones.empty()) return std::nullopt;
+   return RaplEnergyMeter(std::move(zones));
+}
+
+std::optional<double> RaplEnergyMeter::joules_since_last() {
+   std::uint64_t total_uj = 0;
+
+   for (auto& zone : zones_) {
+      const auto now = read_counter(zone.energy_file);
+      if (!now) return std::nullopt;
+
+      if (*now >= zone.last_uj) {
+         total_uj += *now - zone.last_uj;
+      } else {
+         // Counter wrapped at max_energy_range_uj.
+         total_uj += zone.max_range_uj - zone.last_uj + *now;
+      }
+      zone.last_uj = *now;
+   }
+
+   return static_cast<double>(total_uj) / 1e6;
+}
+
+} // namespace cpu_miner::util
@@ -0,0 +1,52 @@
+// src/util/rapl.hpp
+
+#ifndef CPU_MINER_UTIL_RAPL_HPP
+#define CPU_MINER_UTIL_RAPL_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Read package energy from the Linux powercap RAPL interface so hashrate
+  benchmarks can report joules per hash.
+
+Scope:
+  - top-level zones only (intel-rapl:N, named package-N); subzones such as
+    core and dram are already included in their package
+  - counter wrap, using each zone's max_energy_range_uj
+
+Notes:
+  - energy_uj is root-only on most current kernels. open() returns nullopt
+    when no package zone is readable, and callers report energy as
+    unavailable.
+*******************************************************************************/
+
+namespace cpu_miner::util {
+
+class RaplEnergyMeter {
+ public:
+   [[nodiscard]] static std::optional<RaplEnergyMeter>
+   open(const std::filesystem::path& powercap_root = "/sys/class/powercap");
+
+   // Joules consumed by all packages since the previous call (or since
+   // open() for the first call). nullopt if a counter became unreadable.
+   [[nodiscard]] std::optional<double> joules_since_last();
+
+ private:
+   struct Zone {
+      std::filesystem::path energy_file;
+      std::uint64_t max_range_uj{};
+      std::uint64_t last_uj{};
+   };
+
+   explicit RaplEnergyMeter(std::vector<Zone> zones);
+
+   std::vector<Zone> zones_;
+};
+
+} // namespace cpu_miner::util
+
+#endif
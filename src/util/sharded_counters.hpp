@@ -0,0 +1,81 @@
+// src/util/sharded_counters.hpp
+
+#ifndef CPU_MINER_UTIL_SHARDED_COUNTERS_HPP
+#define CPU_MINER_UTIL_SHARDED_COUNTERS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/*******************************************************************************
+Purpose:
+  Per-thread counter blocks, each on its own cache line, so hashing threads
+  never write a line another thread writes. Readers sum the blocks on
+  demand.
+
+Requirements:
+  - Block is alignas(64) and holds only the fields its owning thread writes
+  - each block has exactly one writer, which uses single_writer_add() or a
+    relaxed store; readers use relaxed loads and tolerate a slightly stale
+    total
+
+Notes:
+  - counters written by several threads (pool control threads, for
+    example) stay plain fetch_add atomics outside these blocks
+*******************************************************************************/
+
+namespace cpu_miner::util {
+
+inline constexpr std::size_t kCacheLineBytes = 64U;
+
+// One writer only: a relaxed load and store, so no lock-prefixed
+// read-modify-write. Concurrent readers see either the old or new value.
+inline void single_writer_add(std::atomic<std::uint64_t>& counter,
+                              std::uint64_t delta) noexcept {
+   counter.store(counter.load(std::memory_order_relaxed) + delta,
+                 std::memory_order_relaxed);
+}
+
+template <typename Block>
+class ShardedCounters {
+   static_assert(alignof(Block) >= kCacheLineBytes,
+                 "counter blocks must be cache-line aligned");
+
+ public:
+   explicit ShardedCounters(std::size_t shards) : blocks_(shards) {
+      if (shards == 0U) {
+         throw std::invalid_argument("ShardedCounters: zero shards");
+      }
+   }
+
+   [[nodiscard]] std::size_t size() const noexcept { return blocks_.size(); }
+
+   [[nodiscard]] Block& operator[](std::size_t shard) noexcept {
+      return blocks_[shard];
+   }
+
+   [[nodiscard]] const Block& operator[](std::size_t shard) const noexcept {
+      return blocks_[shard];
+   }
+
+   // Relaxed sum of one field across every block.
+   template <typename Field>
+   [[nodiscard]] std::uint64_t sum(std::atomic<Field> Block::*field) const
+      noexcept {
+      std::uint64_t total = 0;
+      for (const auto& block : blocks_) {
+         total += static_cast<std::uint64_t>(
+            (block.*field).load(std::memory_order_relaxed));
+      }
+      return total;
+   }
+
+ private:
+   std::vector<Block> blocks_;
+};
+
+} // namespace cpu_miner::util
+
+#endif
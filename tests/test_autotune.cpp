@@ -0,0 +1,115 @@
+// tests/test_autotune.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mining_job/autotune.hpp"
+
+namespace {
+
+std::filesystem::path scratch_dir() {
+   const auto dir =
+      std::filesystem::temp_directory_path() / "cpu_miner_autotune_test";
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir);
+   return dir;
+}
+
+cpu_miner::HashrateRun make_run(const char* backend, std::size_t threads,
+                                double hps) {
+   cpu_miner::HashrateRun run{};
+   run.backend = backend;
+   run.threads = threads;
+   run.hash_rate_hps = hps;
+   return run;
+}
+
+} // namespace
+
+TEST_CASE("cpu model key comes from the cpuinfo model name", "[autotune]") {
+   const auto dir = scratch_dir();
+   const auto cpuinfo = dir / "cpuinfo";
+   {
+      std::ofstream out(cpuinfo);
+      out << "processor\t: 0\n"
+          << "vendor_id\t: GenuineIntel\n"
+          << "model name\t: Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz\n";
+   }
+
+   const std::string key = cpu_miner::cpu_model_key(cpuinfo);
+   REQUIRE(key.starts_with("Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz|"));
+   REQUIRE(cpu_miner::cpu_model_key(dir / "missing").starts_with("unknown|"));
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("tune cache keeps one choice per cpu model", "[autotune]") {
+   using cpu_miner::TuneChoice;
+
+   const auto dir = scratch_dir();
+   const auto cache = dir / "nested" / "tune";
+
+   REQUIRE_FALSE(cpu_miner::load_tune_choice(cache, "a|4").has_value());
+
+   REQUIRE(cpu_miner::save_tune_choice(
+      cache, "a|4", TuneChoice{.backend = "cpu", .threads = 4U,
+                               .hash_rate_hps = 1000.0}));
+   REQUIRE(cpu_miner::save_tune_choice(
+      cache, "b|8", TuneChoice{.backend = "cpu", .threads = 8U,
+                               .hash_rate_hps = 2000.0}));
+   REQUIRE(cpu_miner::save_tune_choice(
+      cache, "a|4", TuneChoice{.backend = "cpu", .threads = 2U,
+                               .hash_rate_hps = 1500.0}));
+
+   const auto a = cpu_miner::load_tune_choice(cache, "a|4");
+   REQUIRE(a.has_value());
+   REQUIRE(a->backend == "cpu");
+   REQUIRE(a->threads == 2U);
+   REQUIRE(a->hash_rate_hps == 1500.0);
+
+   const auto b = cpu_miner::load_tune_choice(cache, "b|8");
+   REQUIRE(b.has_value());
+   REQUIRE(b->threads == 8U);
+
+   REQUIRE_FALSE(cpu_miner::load_tune_choice(cache, "c|1").has_value());
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("malformed tune cache lines are ignored", "[autotune]") {
+   const auto dir = scratch_dir();
+   const auto cache = dir / "tune";
+   {
+      std::ofstream out(cache);
+      out << "a|4\tcpu\tmany\t10\n"
+          << "a|4\tcpu\t0\t10\n"
+          << "garbage\n";
+   }
+
+   REQUIRE_FALSE(cpu_miner::load_tune_choice(cache, "a|4").has_value());
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("pick_fastest prefers the earlier run on a tie", "[autotune]") {
+   REQUIRE_FALSE(cpu_miner::pick_fastest({}).has_value());
+
+   const std::vector<cpu_miner::HashrateRun> runs{
+      make_run("cpu", 1U, 100.0),
+      make_run("cpu", 2U, 180.0),
+      make_run("cpu", 4U, 180.0),
+   };
+
+   const auto best = cpu_miner::pick_fastest(runs);
+   REQUIRE(best.has_value());
+   REQUIRE(best->threads == 2U);
+   REQUIRE(best->hash_rate_hps == 180.0);
+}
+
+TEST_CASE("cached backend names resolve to backends", "[autotune]") {
+   REQUIRE(cpu_miner::make_backend("cpu") != nullptr);
+   REQUIRE(cpu_miner::make_backend("no-such-kernel") == nullptr);
+}
@@ -3,10 +3,10 @@
 #include <cstdint>
 #include <vector>
 
+#include "mining_job/accepted_fixture.hpp"
 #include "mining_job/cpu_backend.hpp"
 #include "mining_job/target.hpp"
 #include "mining_job/work_state.hpp"
-#include "support/accepted_fixture.hpp"
 #include "util/hex.hpp"
 
 TEST_CASE("cpu backend scans prepared work and reports a share candidate",
@@ -14,8 +14,7 @@ TEST_CASE("cpu backend scans prepared work and reports a share candidate",
    using namespace cpu_miner;
 
    const auto prepared =
-      prepare_work(test_support::make_accepted_job(),
-                   test_support::make_accepted_subscription(), 0U);
+      prepare_work(make_accepted_job(), make_accepted_subscription(), 0U);
    const auto target_nonce = u32_from_hex_be("00293f3b");
 
    BackendScanRequest request{
@@ -25,7 +24,6 @@ TEST_CASE("cpu backend scans prepared work and reports a share candidate",
       .share_target = share_target_from_difficulty(std::uint64_t{1}),
       .nonce_begin = target_nonce,
       .nonce_end = target_nonce,
-      .progress_interval = 0U,
       .control = {},
    };
 
@@ -0,0 +1,52 @@
+// tests/test_backoff.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <stdexcept>
+
+#include "stratum_client/backoff.hpp"
+
+TEST_CASE("reconnect backoff doubles up to its cap", "[backoff]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   ReconnectBackoff backoff(BackoffConfig{
+      .initial = milliseconds(250), .max = milliseconds(1500), .multiplier = 2U});
+
+   REQUIRE(backoff.next_delay() == milliseconds(250));
+   REQUIRE(backoff.next_delay() == milliseconds(500));
+   REQUIRE(backoff.next_delay() == milliseconds(1000));
+   REQUIRE(backoff.next_delay() == milliseconds(1500));
+   REQUIRE(backoff.next_delay() == milliseconds(1500));
+   REQUIRE(backoff.attempts() == 5U);
+
+   backoff.reset();
+   REQUIRE(backoff.attempts() == 0U);
+   REQUIRE(backoff.next_delay() == milliseconds(250));
+}
+
+TEST_CASE("reconnect backoff stays capped over a long outage", "[backoff]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   ReconnectBackoff backoff;
+   milliseconds delay{};
+   for (int i = 0; i < 200; ++i) {
+      delay = backoff.next_delay();
+   }
+
+   REQUIRE(delay == BackoffConfig{}.max);
+}
+
+TEST_CASE("reconnect backoff rejects bad configuration", "[backoff]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   REQUIRE_THROWS_AS(ReconnectBackoff(BackoffConfig{.initial = milliseconds(0)}),
+                     std::invalid_argument);
+   REQUIRE_THROWS_AS(ReconnectBackoff(BackoffConfig{.initial = milliseconds(10),
+                                                    .max = milliseconds(5)}),
+                     std::invalid_argument);
+   REQUIRE_THROWS_AS(ReconnectBackoff(BackoffConfig{.multiplier = 0U}),
+                     std::invalid_argument);
+}
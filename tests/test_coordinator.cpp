@@ -2,10 +2,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "mining_job/accepted_fixture.hpp"
 #include "mining_job/coordinator.hpp"
 #include "mining_job/cpu_backend.hpp"
 #include "mining_job/target.hpp"
-#include "support/accepted_fixture.hpp"
 #include "util/hex.hpp"
 
 TEST_CASE("coordinator produces correct share submission", "[coordinator]") {
@@ -14,8 +14,8 @@ TEST_CASE("coordinator produces correct share submission", "[coordinator]") {
    CpuHasherBackend backend;
    MiningCoordinator coordinator{backend};
 
-   coordinator.set_job(test_support::make_accepted_job(),
-                       test_support::make_accepted_subscription());
+   coordinator.set_job(make_accepted_job(),
+                       make_accepted_subscription());
 
    ShareSubmission submission{};
    bool called = false;
@@ -31,7 +31,7 @@ TEST_CASE("coordinator produces correct share submission", "[coordinator]") {
    const auto result =
       coordinator.scan_range(target_nonce, target_nonce,
                              expand_compact_target(u32_from_hex_be("1701f0cc")),
-                             share_target_from_difficulty(std::uint64_t{1}), 0U,
+                             share_target_from_difficulty(std::uint64_t{1}),
                              ScanControl{});
 
    REQUIRE(result.hashes_done == 1U);
@@ -39,8 +39,9 @@ TEST_CASE("coordinator produces correct share submission", "[coordinator]") {
    REQUIRE(called);
 
    REQUIRE(submission.job_id == "69b23e1000005c34");
-   REQUIRE(submission.extranonce2_hex == "0000000000000000");
-   REQUIRE(submission.ntime_hex == "69bccef7");
-   REQUIRE(submission.nonce_hex == "00293f3b");
+   REQUIRE(submission.extranonce2_counter == 0U);
+   REQUIRE(submission.extranonce2_size == 8U);
+   REQUIRE(submission.ntime == 0x69bccef7U);
+   REQUIRE(submission.nonce == 0x00293f3bU);
 }
 
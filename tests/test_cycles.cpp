@@ -0,0 +1,67 @@
+// tests/test_cycles.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "util/cycles.hpp"
+
+using namespace cpu_miner::util;
+
+TEST_CASE("thread cycle counters accumulate per stage", "[cycles]") {
+   ThreadCycleCounters counters;
+   counters.add(CycleStage::hash, 100U);
+   counters.add(CycleStage::hash, 50U);
+   counters.add(CycleStage::stale_check, 7U);
+
+   REQUIRE(counters.cycles(CycleStage::hash) == 150U);
+   REQUIRE(counters.events(CycleStage::hash) == 2U);
+   REQUIRE(counters.cycles(CycleStage::stale_check) == 7U);
+   REQUIRE(counters.events(CycleStage::target_compare) == 0U);
+}
+
+TEST_CASE("cycle stage names cover every stage", "[cycles]") {
+   for (std::size_t i = 0; i < kCycleStageCount; ++i) {
+      REQUIRE_FALSE(cycle_stage_name(static_cast<CycleStage>(i)).empty());
+   }
+   REQUIRE(cycle_stage_nested(CycleStage::queue_share));
+   REQUIRE_FALSE(cycle_stage_nested(CycleStage::hash));
+}
+
+TEST_CASE("cycle counter reads do not go backwards", "[cycles]") {
+   const std::uint64_t first = read_cycles();
+   const std::uint64_t second = read_cycles();
+   REQUIRE(second >= first);
+}
+
+TEST_CASE("scoped stages reach the named thread's snapshot", "[cycles]") {
+   std::thread([]() {
+      name_cycle_thread("cycles test");
+      CycleLap lap;
+      {
+         const CycleScope scope(CycleStage::queue_share);
+      }
+      lap.mark(CycleStage::share_callback);
+   }).join();
+
+   const auto snapshots = snapshot_cycle_counters();
+   std::ostringstream out;
+   print_cycle_counters(out);
+
+   if constexpr (kCycleCountersEnabled) {
+      bool found = false;
+      for (const auto& snapshot : snapshots) {
+         if (snapshot.thread != "cycles test") continue;
+         found = true;
+         REQUIRE(snapshot.events[static_cast<std::size_t>(
+                    CycleStage::queue_share)] == 1U);
+         REQUIRE(snapshot.events[static_cast<std::size_t>(
+                    CycleStage::share_callback)] == 1U);
+      }
+      REQUIRE(found);
+      REQUIRE(out.str().find("cycles test") != std::string::npos);
+   } else {
+      REQUIRE(out.str().find("not compiled in") != std::string::npos);
+   }
+}
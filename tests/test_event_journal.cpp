@@ -0,0 +1,110 @@
+// tests/test_event_journal.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/event_journal.hpp"
+#include "mining_job/target.hpp"
+#include "util/hex.hpp"
+
+using namespace cpu_miner;
+
+namespace {
+
+constexpr std::uint32_t kAcceptedNonce = 0x00293f3bU;
+
+WorkState accepted_work() {
+   return work_state_from_prepared(
+      prepare_work(make_accepted_job(), make_accepted_subscription(), 0U));
+}
+
+std::string render_all(const util::MappedJournal& journal,
+                       JournalRenderer& renderer) {
+   std::string text;
+   util::JournalRecord record;
+   for (std::uint64_t seq = 0; seq < journal.next_sequence(); ++seq) {
+      REQUIRE(journal.read(seq, record) == util::JournalReadStatus::ok);
+      text += renderer.render(record);
+   }
+   return text;
+}
+
+bool contains(const std::string& text, const std::string& needle) {
+   return text.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("journaled worker events render with their work", "[event_journal]") {
+   auto journal = util::MappedJournal::anonymous(16U);
+   const WorkState work = accepted_work();
+
+   const std::uint64_t work_id = journal_work(journal, work, 7U);
+   journal_chunk_started(journal, work_id, 0U, 0xffffffffULL);
+
+   ShareCandidate candidate;
+   candidate.work = work;
+   candidate.nonce = kAcceptedNonce;
+   candidate.hash = hash_prepared_work_nonce(
+      prepare_work(make_accepted_job(), make_accepted_subscription(), 0U),
+      kAcceptedNonce);
+   journal_share_found(journal, work_id, candidate,
+                       share_target_from_difficulty(std::uint64_t{1}));
+
+   ScanResult result;
+   result.hashes_done = 2'000'000U;
+   result.shares_found = 1U;
+   result.elapsed_seconds = 2.0;
+   result.stop_reason = ScanStopReason::stale;
+   journal_scan_finished(journal, work_id, result);
+
+   JournalRenderer renderer;
+   const std::string text = render_all(journal, renderer);
+
+   REQUIRE(contains(text, "mining chunk:\n  generation: 7\n  job_id: " +
+                             work.job.job_id + "\n  extranonce2: " +
+                             work.coinbase.extranonce2_hex +
+                             "\n  nonce range: [0, 4294967295]\n"));
+   REQUIRE(contains(text, "SHARE HIT generation=7 nonce=" +
+                             std::to_string(kAcceptedNonce)));
+   REQUIRE(contains(text, "    hash (display, BE):  " +
+                             bytes_to_hex_fixed_msb(candidate.hash)));
+   REQUIRE(contains(text, "    meets share target:  true\n"));
+   REQUIRE(contains(text, "    meets network target: false\n"));
+   REQUIRE(contains(text,
+                    "    merkle root (BE):    " + work.merkle_root_raw_hex));
+   REQUIRE(contains(text, "  average rate: 1000000 H/s\n"));
+   REQUIRE(contains(text, "  stop reason: stale\n"));
+}
+
+TEST_CASE("events whose work record is gone render as unknown work",
+          "[event_journal]") {
+   auto journal = util::MappedJournal::anonymous(16U);
+   const WorkState work = accepted_work();
+
+   const std::uint64_t first = journal_work(journal, work, 1U);
+   const std::uint64_t second = journal_work(journal, work, 2U);
+   journal_chunk_started(journal, first, 0U, 9U);
+   journal_chunk_started(journal, second, 10U, 19U);
+
+   JournalRenderer renderer(1U);
+   const std::string text = render_all(journal, renderer);
+
+   REQUIRE(contains(text, "  generation: ?\n  job_id: ?\n"));
+   REQUIRE(contains(text, "  generation: 2\n"));
+}
+
+TEST_CASE("long job ids are truncated in work records", "[event_journal]") {
+   auto journal = util::MappedJournal::anonymous(4U);
+   WorkState work = accepted_work();
+   work.job.job_id = std::string(40U, 'a');
+
+   const std::uint64_t work_id = journal_work(journal, work, 3U);
+   journal_chunk_started(journal, work_id, 0U, 0U);
+
+   JournalRenderer renderer;
+   const std::string text = render_all(journal, renderer);
+   REQUIRE(contains(text, "  job_id: " + std::string(32U, 'a') + "...\n"));
+}
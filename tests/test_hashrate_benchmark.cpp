@@ -0,0 +1,56 @@
+// tests/test_hashrate_benchmark.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <vector>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/hashrate_benchmark.hpp"
+#include "mining_job/target.hpp"
+#include "util/hex.hpp"
+
+TEST_CASE("benchmark thread counts double up to the hardware count",
+          "[hashrate_benchmark]") {
+   using cpu_miner::benchmark_thread_counts;
+
+   REQUIRE(benchmark_thread_counts(0U) == std::vector<std::size_t>{1U});
+   REQUIRE(benchmark_thread_counts(1U) == std::vector<std::size_t>{1U});
+   REQUIRE(benchmark_thread_counts(4U) ==
+           std::vector<std::size_t>{1U, 2U, 4U});
+   REQUIRE(benchmark_thread_counts(6U) ==
+           std::vector<std::size_t>{1U, 2U, 4U, 6U});
+}
+
+TEST_CASE("embedded benchmark job matches the accepted fixture",
+          "[hashrate_benchmark]") {
+   using namespace cpu_miner;
+
+   const auto embedded = benchmark_prepared_work(0U);
+   const auto fixture =
+      prepare_work(make_accepted_job(), make_accepted_subscription(), 0U);
+
+   REQUIRE(embedded.merkle_root_raw_hex == fixture.merkle_root_raw_hex);
+
+   // The fixture's accepted nonce still meets difficulty 1 on the embedded
+   // copy, so the benchmark hashes real work.
+   const auto hash =
+      hash_prepared_work_nonce(embedded, u32_from_hex_be("00293f3b"));
+   REQUIRE(hash_meets_target(hash, share_target_from_difficulty(1.0)));
+}
+
+TEST_CASE("a short hashrate run counts hashes on every thread",
+          "[hashrate_benchmark]") {
+   using namespace cpu_miner;
+
+   const auto backends = available_backends();
+   REQUIRE_FALSE(backends.empty());
+
+   const auto run = run_hashrate(*backends.front(), 2U,
+                                 std::chrono::milliseconds(30), nullptr);
+
+   REQUIRE(run.backend == "cpu");
+   REQUIRE(run.threads == 2U);
+   REQUIRE(run.hashes > 0U);
+   REQUIRE(run.hash_rate_hps > 0.0);
+   REQUIRE_FALSE(run.joules_per_hash.has_value());
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "util/hex.hpp"
 
@@ -25,3 +26,47 @@ TEST_CASE("u32 hex conversions preserve endianness intent", "[hex]") {
    REQUIRE(u32_from_hex_be("12345678") == value);
    REQUIRE(u32_from_hex_le("78563412") == value);
 }
+
+TEST_CASE("hex codecs match a scalar reference at every length", "[hex]") {
+   using namespace cpu_miner;
+
+   static constexpr char digits[] = "0123456789abcdef";
+
+   for (std::size_t len = 0; len <= 130U; ++len) {
+      std::vector<std::uint8_t> bytes(len);
+      std::string expected;
+      for (std::size_t i = 0; i < len; ++i) {
+         bytes[i] = static_cast<std::uint8_t>((i * 37U + len * 11U) & 0xffU);
+         expected.push_back(digits[bytes[i] >> 4U]);
+         expected.push_back(digits[bytes[i] & 0x0fU]);
+      }
+
+      std::string encoded(len * 2U, '?');
+      hex_encode_into(bytes, encoded);
+      REQUIRE(encoded == expected);
+
+      std::vector<std::uint8_t> decoded(len);
+      REQUIRE(hex_decode_into(expected, decoded));
+      REQUIRE(decoded == bytes);
+   }
+}
+
+TEST_CASE("hex decode rejects bad digits at any position", "[hex]") {
+   using namespace cpu_miner;
+
+   const std::string valid(96U, 'a');
+   std::vector<std::uint8_t> out(valid.size() / 2U);
+
+   for (const char bad : {'A', 'F', 'g', '/', ':', '`', ' ', '\x80', '\xff'}) {
+      for (std::size_t pos = 0; pos < valid.size(); ++pos) {
+         std::string hex = valid;
+         hex[pos] = bad;
+         REQUIRE_FALSE(hex_decode_into(hex, out));
+      }
+   }
+
+   REQUIRE_FALSE(hex_decode_into("abc", out));
+   REQUIRE_FALSE(hex_decode_into("abcd", out));
+   REQUIRE_THROWS(hex_to_bytes("DEADBEEF"));
+   REQUIRE_THROWS(u32_from_hex_be("1234567g"));
+}
@@ -0,0 +1,71 @@
+// tests/test_job_table.cpp
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "mining_job/job_table.hpp"
+
+TEST_CASE("jobs stay valid until clean_jobs", "[job_table]") {
+   using namespace cpu_miner;
+
+   JobTable table;
+   table.note_job("a", true);
+   table.note_job("b", false);
+   table.note_job("c", false);
+
+   REQUIRE(table.size() == 3U);
+   REQUIRE(table.contains("a"));
+   REQUIRE(table.contains("b"));
+   REQUIRE(table.contains("c"));
+
+   table.note_job("d", true);
+   REQUIRE(table.size() == 1U);
+   REQUIRE_FALSE(table.contains("a"));
+   REQUIRE_FALSE(table.contains("c"));
+   REQUIRE(table.contains("d"));
+
+   table.clear();
+   REQUIRE(table.size() == 0U);
+   REQUIRE_FALSE(table.contains("d"));
+}
+
+TEST_CASE("job table drops the oldest job past capacity", "[job_table]") {
+   using namespace cpu_miner;
+
+   JobTable table(2U);
+   table.note_job("a", false);
+   table.note_job("b", false);
+   // A repeated id becomes the newest instead of a second entry.
+   table.note_job("a", false);
+   table.note_job("c", false);
+
+   REQUIRE(table.size() == 2U);
+   REQUIRE(table.contains("a"));
+   REQUIRE_FALSE(table.contains("b"));
+   REQUIRE(table.contains("c"));
+
+   REQUIRE(JobTable(0U).capacity() == 1U);
+}
+
+TEST_CASE("job table drops duplicate shares per job", "[job_table]") {
+   using namespace cpu_miner;
+   using ShareRecord = JobTable::ShareRecord;
+
+   JobTable table;
+   table.note_job("a", true);
+   table.note_job("b", false);
+
+   REQUIRE(table.note_share("a", 7U) == ShareRecord::recorded);
+   REQUIRE(table.note_share("a", 7U) == ShareRecord::duplicate);
+   // The same fingerprint on another job is a different share.
+   REQUIRE(table.note_share("b", 7U) == ShareRecord::recorded);
+   REQUIRE(table.note_share("z", 7U) == ShareRecord::unknown_job);
+
+   // A repeated notify for a held job keeps what it has seen.
+   table.note_job("a", false);
+   REQUIRE(table.note_share("a", 7U) == ShareRecord::duplicate);
+
+   // clean_jobs starts over, even for a reused job id.
+   table.note_job("a", true);
+   REQUIRE(table.note_share("a", 7U) == ShareRecord::recorded);
+   REQUIRE(table.note_share("b", 7U) == ShareRecord::unknown_job);
+}
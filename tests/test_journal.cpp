@@ -0,0 +1,142 @@
+// tests/test_journal.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "util/journal.hpp"
+
+using namespace cpu_miner::util;
+
+namespace {
+
+struct Tick {
+   static constexpr std::uint32_t kJournalType = 7U;
+
+   std::uint64_t thread{};
+   std::uint64_t value{};
+};
+
+struct Tock {
+   static constexpr std::uint32_t kJournalType = 8U;
+
+   std::uint32_t value{};
+};
+
+std::filesystem::path scratch_file() {
+   const auto dir =
+      std::filesystem::temp_directory_path() / "cpu_miner_journal_test";
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir);
+   return dir / "events.journal";
+}
+
+} // namespace
+
+TEST_CASE("journal records read back by sequence and type", "[journal]") {
+   auto journal = MappedJournal::anonymous(8U);
+
+   REQUIRE(journal.append(Tick{.thread = 1U, .value = 42U}) == 0U);
+   REQUIRE(journal.append(Tock{.value = 9U}) == 1U);
+   REQUIRE(journal.next_sequence() == 2U);
+
+   JournalRecord record;
+   REQUIRE(journal.read(0U, record) == JournalReadStatus::ok);
+   REQUIRE(record.commit == 1U);
+   REQUIRE(record.unix_ns > 0);
+   REQUIRE_FALSE(journal_payload<Tock>(record).has_value());
+   const auto tick = journal_payload<Tick>(record);
+   REQUIRE(tick.has_value());
+   REQUIRE(tick->value == 42U);
+
+   REQUIRE(journal.read(1U, record) == JournalReadStatus::ok);
+   REQUIRE(journal_payload<Tock>(record)->value == 9U);
+
+   REQUIRE(journal.read(2U, record) == JournalReadStatus::pending);
+}
+
+TEST_CASE("a lapped journal reports overwritten records", "[journal]") {
+   auto journal = MappedJournal::anonymous(4U);
+   for (std::uint64_t i = 0; i < 10U; ++i) {
+      (void)journal.append(Tick{.thread = 0U, .value = i});
+   }
+
+   REQUIRE(journal.oldest_sequence() == 6U);
+
+   JournalRecord record;
+   REQUIRE(journal.read(5U, record) == JournalReadStatus::overwritten);
+   REQUIRE(journal.read(6U, record) == JournalReadStatus::ok);
+   REQUIRE(journal_payload<Tick>(record)->value == 6U);
+   REQUIRE(journal.read(9U, record) == JournalReadStatus::ok);
+   REQUIRE(journal_payload<Tick>(record)->value == 9U);
+}
+
+TEST_CASE("journal appends from several threads keep every record",
+          "[journal]") {
+   constexpr std::uint64_t kThreads = 4U;
+   constexpr std::uint64_t kPerThread = 1000U;
+   auto journal = MappedJournal::anonymous(kThreads * kPerThread);
+
+   {
+      std::vector<std::jthread> threads;
+      for (std::uint64_t t = 0; t < kThreads; ++t) {
+         threads.emplace_back([&journal, t]() {
+            for (std::uint64_t i = 0; i < kPerThread; ++i) {
+               (void)journal.append(Tick{.thread = t, .value = i});
+            }
+         });
+      }
+   }
+
+   // Each thread's records appear in its own append order.
+   std::vector<std::uint64_t> expected(kThreads, 0U);
+   JournalRecord record;
+   for (std::uint64_t seq = 0; seq < journal.next_sequence(); ++seq) {
+      REQUIRE(journal.read(seq, record) == JournalReadStatus::ok);
+      const auto tick = journal_payload<Tick>(record);
+      REQUIRE(tick.has_value());
+      REQUIRE(tick->value == expected[tick->thread]++);
+   }
+   for (const auto count : expected) {
+      REQUIRE(count == kPerThread);
+   }
+}
+
+TEST_CASE("a journal file can be read after its writer is gone",
+          "[journal]") {
+   const auto path = scratch_file();
+   {
+      auto journal = MappedJournal::create(path, 16U);
+      (void)journal.append(Tick{.thread = 3U, .value = 5U});
+      (void)journal.append(Tock{.value = 6U});
+   }
+
+   const auto journal = MappedJournal::open_read_only(path);
+   REQUIRE(journal.capacity() == 16U);
+   REQUIRE(journal.next_sequence() == 2U);
+
+   JournalRecord record;
+   REQUIRE(journal.read(0U, record) == JournalReadStatus::ok);
+   REQUIRE(journal_payload<Tick>(record)->thread == 3U);
+   REQUIRE(journal.read(1U, record) == JournalReadStatus::ok);
+   REQUIRE(journal_payload<Tock>(record)->value == 6U);
+
+   std::filesystem::remove_all(path.parent_path());
+}
+
+TEST_CASE("files that are not journals are refused", "[journal]") {
+   const auto path = scratch_file();
+   {
+      std::ofstream out(path, std::ios::binary);
+      out << std::string(256U, 'x');
+   }
+
+   REQUIRE_THROWS_AS(MappedJournal::open_read_only(path), std::runtime_error);
+   REQUIRE_THROWS(MappedJournal::anonymous(0U));
+
+   std::filesystem::remove_all(path.parent_path());
+}
@@ -0,0 +1,105 @@
+// tests/test_log.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "util/log.hpp"
+
+using namespace cpu_miner::util;
+
+namespace {
+
+constexpr LogSite kShareSite{LogLevel::info,
+                             "share {} job={} ok={} rate={} delta={}"};
+
+LogRecord make_record(const LogSite& site) {
+   LogRecord record;
+   record.site = &site;
+   return record;
+}
+
+} // namespace
+
+TEST_CASE("log records pack arguments and format later", "[log]") {
+   LogRecord record = make_record(kShareSite);
+   log_detail::put(record, std::uint32_t{7});
+   log_detail::put(record, std::string("69b23e10"));
+   log_detail::put(record, true);
+   log_detail::put(record, 1.5);
+   log_detail::put(record, -3);
+
+   REQUIRE(record.arg_count == 5U);
+   REQUIRE_FALSE(record.truncated);
+   REQUIRE(format_log_message(record) ==
+           "share 7 job=69b23e10 ok=true rate=1.5 delta=-3");
+}
+
+TEST_CASE("log strings are truncated to the record payload", "[log]") {
+   static constexpr LogSite site{LogLevel::debug, "raw {} then {}"};
+
+   LogRecord record = make_record(site);
+   log_detail::put(record, std::string(300U, 'x'));
+   log_detail::put(record, std::uint64_t{1});
+
+   REQUIRE(record.truncated);
+   const std::string message = format_log_message(record);
+   REQUIRE(message.starts_with("raw " + std::string(kLogPayloadBytes - 1U,
+                                                    'x')));
+   REQUIRE(message.ends_with(" then {} [truncated]"));
+}
+
+TEST_CASE("log lines carry a UTC timestamp and level", "[log]") {
+   LogRecord record = make_record(kShareSite);
+   // 2024-01-02T03:04:05.000006Z
+   record.unix_ns = 1704164645000006000LL;
+
+   const std::string line = format_log_line(record);
+   REQUIRE(line.starts_with("2024-01-02T03:04:05.000006Z INFO share "));
+   REQUIRE(line.ends_with("\n"));
+}
+
+TEST_CASE("log ring drops instead of blocking when full", "[log]") {
+   static LogRing ring;
+   const LogRecord record = make_record(kShareSite);
+
+   for (std::size_t i = 0; i < LogRing::kCapacity; ++i) {
+      REQUIRE(ring.try_push(record));
+   }
+   REQUIRE_FALSE(ring.try_push(record));
+
+   LogRecord out;
+   REQUIRE(ring.try_pop(out));
+   REQUIRE(out.site == &kShareSite);
+   REQUIRE(ring.try_push(record));
+
+   std::size_t popped = 0;
+   while (ring.try_pop(out)) ++popped;
+   REQUIRE(popped == LogRing::kCapacity);
+}
+
+TEST_CASE("log writer drains every thread's records", "[log]") {
+   std::FILE* file = std::tmpfile();
+   REQUIRE(file != nullptr);
+
+   {
+      const LogWriter writer(file, std::chrono::milliseconds(1));
+      std::thread([]() { CPU_MINER_LOG_WARN("from thread {}", 2); }).join();
+      CPU_MINER_LOG_ERROR("from main {}", "thread");
+      CPU_MINER_LOG_DEBUG("debug {}", 1);
+   }
+
+   std::string text;
+   std::rewind(file);
+   for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+      text += static_cast<char>(c);
+   }
+   std::fclose(file);
+
+   REQUIRE(text.find("WARN from thread 2\n") != std::string::npos);
+   REQUIRE(text.find("ERROR from main thread\n") != std::string::npos);
+   REQUIRE((text.find("debug 1") != std::string::npos) ==
+           log_enabled(LogLevel::debug));
+}
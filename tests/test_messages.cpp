@@ -0,0 +1,131 @@
+// tests/test_messages.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <variant>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "stratum_client/messages.hpp"
+
+TEST_CASE("subscribe response round-trips with a session id", "[messages]") {
+   using namespace cpu_miner;
+
+   const std::string wire = to_wire_message(SubscribeResponse{
+      .id = 1,
+      .extranonce1 = "3f3eb26900000000",
+      .extranonce2_size = 8U,
+      .session_id = "3f3eb269",
+   });
+
+   const auto parsed = parse_incoming_message(wire);
+   REQUIRE(parsed.has_value());
+
+   const auto* sub = std::get_if<SubscribeResponse>(&*parsed);
+   REQUIRE(sub != nullptr);
+   REQUIRE(sub->id == 1);
+   REQUIRE(sub->extranonce1 == "3f3eb26900000000");
+   REQUIRE(sub->extranonce2_size == 8U);
+   REQUIRE(sub->session_id == "3f3eb269");
+}
+
+TEST_CASE("subscribe response session id is found in ckpool nesting",
+          "[messages]") {
+   using namespace cpu_miner;
+
+   const auto parsed = parse_incoming_message(
+      R"({"id":1,"result":[[["mining.set_difficulty","a1"],)"
+      R"(["mining.notify","b2"]],"00ff00ff",4],"error":null})");
+   REQUIRE(parsed.has_value());
+
+   const auto* sub = std::get_if<SubscribeResponse>(&*parsed);
+   REQUIRE(sub != nullptr);
+   REQUIRE(sub->session_id == "b2");
+}
+
+TEST_CASE("notify serialisation round-trips through the parser",
+          "[messages]") {
+   using namespace cpu_miner;
+
+   const auto job = make_accepted_job();
+   const NotifyMessage notify{
+      .job_id = job.job_id,
+      .prevhash = job.prevhash,
+      .coinb1 = job.coinb1,
+      .coinb2 = job.coinb2,
+      .merkle_branch = job.merkle_branch,
+      .version = job.version,
+      .nbits = job.nbits,
+      .ntime = job.ntime,
+      .clean_jobs = true,
+   };
+
+   const auto parsed = parse_incoming_message(to_wire_message(notify));
+   REQUIRE(parsed.has_value());
+
+   const auto* msg = std::get_if<NotifyMessage>(&*parsed);
+   REQUIRE(msg != nullptr);
+   REQUIRE(msg->job_id == notify.job_id);
+   REQUIRE(msg->prevhash == notify.prevhash);
+   REQUIRE(msg->coinb1 == notify.coinb1);
+   REQUIRE(msg->coinb2 == notify.coinb2);
+   REQUIRE(msg->merkle_branch == notify.merkle_branch);
+   REQUIRE(msg->version == notify.version);
+   REQUIRE(msg->nbits == notify.nbits);
+   REQUIRE(msg->ntime == notify.ntime);
+   REQUIRE(msg->clean_jobs);
+}
+
+TEST_CASE("client requests parse back from the miner's wire format",
+          "[messages]") {
+   using namespace cpu_miner;
+
+   const auto subscribe = parse_client_request(
+      to_wire_message(SubscribeRequest{.session_id = "b2"}, 1));
+   REQUIRE(subscribe.has_value());
+   REQUIRE(subscribe->id == 1);
+   REQUIRE(std::get<SubscribeRequest>(subscribe->body).session_id == "b2");
+
+   const auto authorize = parse_client_request(to_wire_message(
+      AuthorizeRequest{.user = "worker.cpu", .password = "x"}, 2));
+   REQUIRE(authorize.has_value());
+   REQUIRE(std::get<AuthorizeRequest>(authorize->body).user == "worker.cpu");
+
+   const auto submit = parse_client_request(to_wire_message(
+      SubmitShareRequest{
+         .worker_name = "worker.cpu",
+         .job_id = "69b23e1000005c34",
+         .extranonce2_hex = "0000000000000000",
+         .ntime_hex = "69bccef7",
+         .nonce_hex = "00293f3b",
+      },
+      3));
+   REQUIRE(submit.has_value());
+   REQUIRE(submit->id == 3);
+   const auto& share = std::get<SubmitShareRequest>(submit->body);
+   REQUIRE(share.job_id == "69b23e1000005c34");
+   REQUIRE(share.extranonce2_hex == "0000000000000000");
+   REQUIRE(share.ntime_hex == "69bccef7");
+   REQUIRE(share.nonce_hex == "00293f3b");
+
+   REQUIRE_FALSE(parse_client_request(R"({"id":4,"method":"mining.other"})"));
+   REQUIRE_FALSE(parse_client_request("not json"));
+}
+
+TEST_CASE("submit results carry ckpool-style errors", "[messages]") {
+   using namespace cpu_miner;
+
+   const auto accepted = parse_incoming_message(to_wire_result(7, true));
+   REQUIRE(accepted.has_value());
+   const auto& ok = std::get<SubmitResponse>(*accepted);
+   REQUIRE(ok.id == 7);
+   REQUIRE(ok.accepted);
+   REQUIRE_FALSE(ok.has_error);
+
+   const auto rejected = parse_incoming_message(
+      to_wire_result(8, false, 23, "Low difficulty share"));
+   REQUIRE(rejected.has_value());
+   const auto& bad = std::get<SubmitResponse>(*rejected);
+   REQUIRE_FALSE(bad.accepted);
+   REQUIRE(bad.has_error);
+   REQUIRE(bad.error_text == R"([23,"Low difficulty share",null])");
+}
@@ -0,0 +1,56 @@
+// tests/test_metrics_server.cpp
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "util/metrics_server.hpp"
+
+namespace {
+
+std::string http_get(std::uint16_t port, const std::string& request) {
+   namespace asio = boost::asio;
+
+   asio::io_context io;
+   asio::ip::tcp::socket socket(io);
+   socket.connect(
+      asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), port));
+   asio::write(socket, asio::buffer(request));
+
+   std::string response;
+   boost::system::error_code ec;
+   asio::read(socket, asio::dynamic_buffer(response), ec);
+   return response;
+}
+
+} // namespace
+
+TEST_CASE("metrics server answers GET /metrics", "[metrics_server]") {
+   int renders = 0;
+   cpu_miner::util::MetricsServer server("127.0.0.1", 0U, [&]() {
+      ++renders;
+      return std::string("up 1\n# EOF\n");
+   });
+   REQUIRE(server.port() != 0U);
+
+   const std::string ok =
+      http_get(server.port(), "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+   REQUIRE(ok.starts_with("HTTP/1.1 200 OK\r\n"));
+   REQUIRE(ok.find("application/openmetrics-text") != std::string::npos);
+   REQUIRE(ok.ends_with("\r\n\r\nup 1\n# EOF\n"));
+
+   const std::string missing =
+      http_get(server.port(), "GET / HTTP/1.1\r\nHost: x\r\n\r\n");
+   REQUIRE(missing.starts_with("HTTP/1.1 404"));
+
+   const std::string post =
+      http_get(server.port(), "POST /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+   REQUIRE(post.starts_with("HTTP/1.1 405"));
+
+   REQUIRE(renders == 1);
+}
@@ -0,0 +1,96 @@
+// tests/test_notify_parser.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <string_view>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/job.hpp"
+#include "mining_job/work_state.hpp"
+#include "stratum_client/notify_parser.hpp"
+#include "util/hex.hpp"
+
+TEST_CASE("notify parser decodes a captured ckpool notify", "[notify_parser]") {
+   using namespace cpu_miner;
+
+   NotifyMessage msg;
+   DecodedJob decoded;
+
+   REQUIRE(parse_notify_line(kAcceptedNotifyLine, msg, decoded));
+
+   const auto job = make_accepted_job();
+   REQUIRE(msg.job_id == job.job_id);
+   REQUIRE(msg.prevhash == job.prevhash);
+   REQUIRE(msg.coinb1 == job.coinb1);
+   REQUIRE(msg.coinb2 == job.coinb2);
+   REQUIRE(msg.merkle_branch == job.merkle_branch);
+   REQUIRE(msg.version == job.version);
+   REQUIRE(msg.nbits == job.nbits);
+   REQUIRE(msg.ntime == job.ntime);
+   REQUIRE_FALSE(msg.clean_jobs);
+
+   const auto expected = decode_job(job);
+   REQUIRE(decoded.version == expected.version);
+   REQUIRE(decoded.nbits == expected.nbits);
+   REQUIRE(decoded.ntime == expected.ntime);
+   REQUIRE(decoded.prevhash_sha_input == expected.prevhash_sha_input);
+   REQUIRE(decoded.coinb1 == expected.coinb1);
+   REQUIRE(decoded.coinb2 == expected.coinb2);
+   REQUIRE(decoded.merkle_branch == expected.merkle_branch);
+   REQUIRE(decoded.network_target == expected.network_target);
+}
+
+TEST_CASE("notify parser reuses storage across lines", "[notify_parser]") {
+   using namespace cpu_miner;
+
+   NotifyMessage msg;
+   DecodedJob decoded;
+
+   const std::string short_notify =
+      R"({"id":null,"method":"mining.notify","params":["j2",)"
+      R"("0000000000000000000000000000000000000000000000000000000000000000",)"
+      R"("01","02",[],"20000000","1d00ffff","65f2c2b0",true,"extra"]})";
+
+   REQUIRE(parse_notify_line(kAcceptedNotifyLine, msg, decoded));
+   REQUIRE(parse_notify_line(short_notify, msg, decoded));
+
+   REQUIRE(msg.job_id == "j2");
+   REQUIRE(msg.merkle_branch.empty());
+   REQUIRE(decoded.merkle_branch.empty());
+   REQUIRE(bytes_to_hex(decoded.coinb1) == "01");
+   REQUIRE(decoded.nbits == 0x1d00ffffU);
+   REQUIRE(msg.clean_jobs);
+}
+
+TEST_CASE("notify parser rejects lines the DOM path should handle",
+          "[notify_parser]") {
+   using namespace cpu_miner;
+
+   NotifyMessage msg;
+   DecodedJob decoded;
+
+   const std::string_view rejected[] = {
+      R"({"id":null,"method":"mining.set_difficulty","params":[1]})",
+      R"({"id":1,"result":true,"error":null})",
+      R"({"method":"mining.notify","params":["j"]})",
+      R"({"method":"mining.notify","params":["j\"","00","01","02",[],)"
+      R"("20000000","1d00ffff","65f2c2b0",true]})",
+      R"({"method":"mining.notify","params":["j","00","01","02",[],)"
+      R"("20000000","1d00ffff","65f2c2b0",true]})",
+      R"({"method":"mining.notify","params":["j",)"
+      R"("0000000000000000000000000000000000000000000000000000000000000000",)"
+      R"("0G","02",[],"20000000","1d00ffff","65f2c2b0",true]})",
+      R"({"method":"mining.notify","params":["j",)"
+      R"("0000000000000000000000000000000000000000000000000000000000000000",)"
+      R"("01","02",[],"20000000","1d00ffff","65f2c2b0",1]})",
+      R"({"method":"mining.notify","params":["j",)"
+      R"("0000000000000000000000000000000000000000000000000000000000000000",)"
+      R"("01","02",[],"20000000","1d00ffff","65f2c2b0",true]} trailing)",
+      "",
+      "not json",
+   };
+
+   for (const auto line : rejected) {
+      REQUIRE_FALSE(parse_notify_line(line, msg, decoded));
+   }
+}
@@ -0,0 +1,72 @@
+// tests/test_openmetrics.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <string>
+
+#include "util/openmetrics.hpp"
+
+using namespace cpu_miner::util;
+
+namespace {
+
+bool contains(const std::string& text, const std::string& needle) {
+   return text.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("counters and gauges follow the OpenMetrics layout",
+          "[openmetrics]") {
+   OpenMetricsWriter out;
+   out.counter("miner_shares", "Shares found.", 42U);
+   out.gauge("miner_age_seconds", "Job age.", 1.5, "seconds");
+   const std::string text = out.finish();
+
+   REQUIRE(contains(text, "# TYPE miner_shares counter\n"));
+   REQUIRE(contains(text, "# HELP miner_shares Shares found.\n"));
+   REQUIRE(contains(text, "miner_shares_total 42\n"));
+   REQUIRE(contains(text, "# TYPE miner_age_seconds gauge\n"));
+   REQUIRE(contains(text, "# UNIT miner_age_seconds seconds\n"));
+   REQUIRE(contains(text, "miner_age_seconds 1.5\n"));
+   REQUIRE(text.ends_with("# EOF\n"));
+}
+
+TEST_CASE("label values are escaped", "[openmetrics]") {
+   OpenMetricsWriter out;
+   out.family("miner_hashes", "counter", "Hashes.");
+   out.sample("miner_hashes_total", {{"worker", "a\"b\\c\nd"}},
+              std::uint64_t{7});
+   const std::string text = out.finish();
+
+   REQUIRE(contains(text,
+                    "miner_hashes_total{worker=\"a\\\"b\\\\c\\nd\"} 7\n"));
+}
+
+TEST_CASE("latency histogram renders cumulative buckets", "[openmetrics]") {
+   using namespace std::chrono_literals;
+
+   LatencyHistogram histogram;
+   histogram.observe(3ms);
+   histogram.observe(40ms);
+   histogram.observe(700ms);
+   histogram.observe(30s);
+
+   const auto snapshot = histogram.snapshot();
+   REQUIRE(snapshot.count == 4U);
+   REQUIRE(snapshot.buckets.front() == 1U);
+   REQUIRE(snapshot.buckets.back() == 1U);
+
+   OpenMetricsWriter out;
+   out.histogram("lat_seconds", "Submit latency.", "seconds", snapshot);
+   const std::string text = out.finish();
+
+   REQUIRE(contains(text, "# TYPE lat_seconds histogram\n"));
+   REQUIRE(contains(text, "lat_seconds_bucket{le=\"0.005\"} 1\n"));
+   REQUIRE(contains(text, "lat_seconds_bucket{le=\"0.05\"} 2\n"));
+   REQUIRE(contains(text, "lat_seconds_bucket{le=\"1.0\"} 3\n"));
+   REQUIRE(contains(text, "lat_seconds_bucket{le=\"10.0\"} 3\n"));
+   REQUIRE(contains(text, "lat_seconds_bucket{le=\"+Inf\"} 4\n"));
+   REQUIRE(contains(text, "lat_seconds_count 4\n"));
+   REQUIRE(contains(text, "lat_seconds_sum 30.743\n"));
+}
@@ -0,0 +1,118 @@
+// tests/test_pool_set.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "stratum_client/pool_set.hpp"
+
+namespace {
+
+using cpu_miner::PoolSelector;
+using namespace std::chrono_literals;
+
+} // namespace
+
+TEST_CASE("pool endpoint parses host, port and optional weight",
+          "[pool_set]") {
+   using namespace cpu_miner;
+
+   const auto plain = parse_pool_endpoint("192.168.0.104:3333");
+   REQUIRE(plain.host == "192.168.0.104");
+   REQUIRE(plain.port == "3333");
+   REQUIRE(plain.weight == 1U);
+
+   const auto weighted = parse_pool_endpoint("backup.example:3334,3");
+   REQUIRE(weighted.host == "backup.example");
+   REQUIRE(weighted.port == "3334");
+   REQUIRE(weighted.weight == 3U);
+
+   REQUIRE_THROWS_AS(parse_pool_endpoint("nohost"), std::invalid_argument);
+   REQUIRE_THROWS_AS(parse_pool_endpoint(":3333"), std::invalid_argument);
+   REQUIRE_THROWS_AS(parse_pool_endpoint("host:"), std::invalid_argument);
+   REQUIRE_THROWS_AS(parse_pool_endpoint("host:1,0"), std::invalid_argument);
+   REQUIRE_THROWS_AS(parse_pool_endpoint("host:1,x"), std::invalid_argument);
+}
+
+TEST_CASE("failover prefers the highest-priority healthy pool", "[pool_set]") {
+   using namespace cpu_miner;
+
+   PoolSelector selector({1U, 1U},
+                         PoolSelectorConfig{.mode = PoolMode::failover,
+                                            .notify_timeout = 60s});
+   const auto t0 = PoolSelector::clock::now();
+
+   REQUIRE_FALSE(selector.update(t0));
+   REQUIRE_FALSE(selector.active().has_value());
+
+   selector.note_notify(1U, t0);
+   REQUIRE(selector.update(t0));
+   REQUIRE(selector.active() == 1U);
+
+   selector.note_notify(0U, t0);
+   REQUIRE(selector.update(t0));
+   REQUIRE(selector.active() == 0U);
+
+   // Primary goes quiet; the standby has kept receiving notifies.
+   selector.note_notify(1U, t0 + 50s);
+   REQUIRE_FALSE(selector.update(t0 + 60s));
+   REQUIRE(selector.update(t0 + 61s));
+   REQUIRE(selector.active() == 1U);
+
+   // A dropped connection fails over immediately.
+   selector.note_notify(0U, t0 + 62s);
+   REQUIRE(selector.update(t0 + 62s));
+   REQUIRE(selector.active() == 0U);
+   selector.mark_down(0U);
+   REQUIRE(selector.update(t0 + 62s));
+   REQUIRE(selector.active() == 1U);
+}
+
+TEST_CASE("split mode rotates slices by weight", "[pool_set]") {
+   using namespace cpu_miner;
+
+   PoolSelector selector({3U, 1U},
+                         PoolSelectorConfig{.mode = PoolMode::split,
+                                            .notify_timeout = 1h,
+                                            .split_slice = 10s});
+   const auto t0 = PoolSelector::clock::now();
+   selector.note_notify(0U, t0);
+   selector.note_notify(1U, t0);
+
+   std::vector<std::size_t> picks(2U, 0U);
+   for (int slice = 0; slice < 8; ++slice) {
+      const auto now = t0 + slice * 10s;
+      (void)selector.update(now);
+      REQUIRE(selector.active().has_value());
+      ++picks[*selector.active()];
+
+      // Within a slice the active pool is stable.
+      REQUIRE_FALSE(selector.update(now + 5s));
+   }
+
+   REQUIRE(picks[0] == 6U);
+   REQUIRE(picks[1] == 2U);
+}
+
+TEST_CASE("split mode skips unhealthy pools", "[pool_set]") {
+   using namespace cpu_miner;
+
+   PoolSelector selector({1U, 1U},
+                         PoolSelectorConfig{.mode = PoolMode::split,
+                                            .notify_timeout = 1h,
+                                            .split_slice = 10s});
+   const auto t0 = PoolSelector::clock::now();
+   selector.note_notify(0U, t0);
+   selector.note_notify(1U, t0);
+   selector.mark_down(1U);
+
+   for (int slice = 0; slice < 4; ++slice) {
+      (void)selector.update(t0 + slice * 10s);
+      REQUIRE(selector.active() == 0U);
+   }
+
+   REQUIRE_THROWS_AS(PoolSelector({}, {}), std::invalid_argument);
+   REQUIRE_THROWS_AS(PoolSelector({1U, 0U}, {}), std::invalid_argument);
+}
@@ -0,0 +1,64 @@
+// tests/test_rapl.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "util/rapl.hpp"
+
+namespace {
+
+void write_file(const std::filesystem::path& file, const std::string& text) {
+   std::ofstream out(file);
+   out << text << '\n';
+}
+
+struct FakePowercap {
+   FakePowercap() {
+      root = std::filesystem::temp_directory_path() / "cpu_miner_rapl_test";
+      std::filesystem::remove_all(root);
+
+      const auto package = root / "intel-rapl:0";
+      const auto core = root / "intel-rapl:0:0";
+      std::filesystem::create_directories(package);
+      std::filesystem::create_directories(core);
+
+      write_file(package / "name", "package-0");
+      write_file(package / "energy_uj", "1000000");
+      write_file(package / "max_energy_range_uj", "2000000");
+
+      // A subzone is already counted in its package and must be skipped.
+      write_file(core / "name", "core");
+      write_file(core / "energy_uj", "5");
+      write_file(core / "max_energy_range_uj", "2000000");
+   }
+
+   ~FakePowercap() { std::filesystem::remove_all(root); }
+
+   std::filesystem::path root;
+};
+
+} // namespace
+
+TEST_CASE("rapl meter sums package energy across a counter wrap", "[rapl]") {
+   using cpu_miner::util::RaplEnergyMeter;
+
+   FakePowercap powercap;
+   auto meter = RaplEnergyMeter::open(powercap.root);
+   REQUIRE(meter.has_value());
+
+   write_file(powercap.root / "intel-rapl:0" / "energy_uj", "1250000");
+   REQUIRE(meter->joules_since_last() == 0.25);
+
+   // Wrapped past max_energy_range_uj back to 500000.
+   write_file(powercap.root / "intel-rapl:0" / "energy_uj", "500000");
+   REQUIRE(meter->joules_since_last() == 1.25);
+}
+
+TEST_CASE("rapl meter is unavailable without readable zones", "[rapl]") {
+   using cpu_miner::util::RaplEnergyMeter;
+
+   REQUIRE_FALSE(
+      RaplEnergyMeter::open("/nonexistent/cpu_miner/powercap").has_value());
+}
@@ -0,0 +1,147 @@
+// tests/test_scan.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/scan.hpp"
+#include "mining_job/target.hpp"
+#include "mining_job/work_state.hpp"
+
+TEST_CASE("check block size adapts in powers of two", "[scan]") {
+   using namespace cpu_miner;
+   using std::chrono::microseconds;
+
+   ScanControl control{};
+   control.check_budget = microseconds(100);
+   control.min_check_hashes = 64U;
+   control.max_check_hashes = 1024U;
+
+   // Fast blocks double up to the cap.
+   REQUIRE(next_check_hashes(64U, microseconds(10), control) == 128U);
+   REQUIRE(next_check_hashes(1024U, microseconds(10), control) == 1024U);
+
+   // Slow blocks halve down to the floor.
+   REQUIRE(next_check_hashes(512U, microseconds(500), control) == 256U);
+   REQUIRE(next_check_hashes(64U, microseconds(500), control) == 64U);
+
+   // Within [budget / 2, budget * 2] the size holds.
+   REQUIRE(next_check_hashes(256U, microseconds(100), control) == 256U);
+
+   // Odd inputs are rounded down to a power of two and clamped.
+   REQUIRE(next_check_hashes(300U, microseconds(100), control) == 256U);
+   REQUIRE(next_check_hashes(5000U, microseconds(100), control) == 1024U);
+}
+
+TEST_CASE("scan stops at the first block after the generation changes",
+          "[scan]") {
+   using namespace cpu_miner;
+
+   auto work = make_work_state(make_accepted_job(),
+                               make_accepted_subscription(), 0U);
+
+   std::atomic<std::uint64_t> generation{2U};
+   ScanControl control{};
+   control.work_generation = &generation;
+   control.expected_generation = 1U;
+   control.min_check_hashes = 64U;
+
+   const auto result =
+      scan_nonce_range(work, uint256{}, uint256{}, 0U, 100'000U, control,
+                       nullptr);
+
+   REQUIRE(result.stop_reason == ScanStopReason::stale);
+   // Only the single-hash first block ran.
+   REQUIRE(result.hashes_done == 1U);
+   REQUIRE(result.first_hash_at != std::chrono::steady_clock::time_point{});
+}
+
+TEST_CASE("scan covers the whole range across adaptive blocks", "[scan]") {
+   using namespace cpu_miner;
+
+   auto work = make_work_state(make_accepted_job(),
+                               make_accepted_subscription(), 0U);
+
+   std::atomic<std::uint64_t> generation{1U};
+   std::atomic<std::uint64_t> progress{0U};
+   ScanControl control{};
+   control.work_generation = &generation;
+   control.expected_generation = 1U;
+   control.min_check_hashes = 4U;
+   control.max_check_hashes = 64U;
+   control.progress_hashes_done = &progress;
+
+   const auto result = scan_nonce_range(work, uint256{}, uint256{}, 1000U,
+                                        2999U, control, nullptr);
+
+   REQUIRE(result.stop_reason == ScanStopReason::exhausted);
+   REQUIRE(result.hashes_done == 2000U);
+   REQUIRE(progress.load() == 2000U);
+   REQUIRE(work.nonce == 2999U);
+}
+
+TEST_CASE("abort word reasons are checked between blocks", "[scan]") {
+   using namespace cpu_miner;
+
+   auto work = make_work_state(make_accepted_job(),
+                               make_accepted_subscription(), 0U);
+
+   // A generation mismatch is ignored once an abort word is supplied.
+   std::atomic<std::uint64_t> generation{2U};
+   AbortFlag abort;
+   ScanControl control{};
+   control.work_generation = &generation;
+   control.expected_generation = 1U;
+   control.abort = &abort;
+   control.min_check_hashes = 16U;
+   control.max_check_hashes = 16U;
+
+   auto result =
+      scan_nonce_range(work, uint256{}, uint256{}, 0U, 99U, control, nullptr);
+   REQUIRE(result.stop_reason == ScanStopReason::exhausted);
+   REQUIRE(result.hashes_done == 100U);
+
+   abort.request_stale();
+   result =
+      scan_nonce_range(work, uint256{}, uint256{}, 0U, 99U, control, nullptr);
+   REQUIRE(result.stop_reason == ScanStopReason::stale);
+   REQUIRE(result.hashes_done == 1U);
+
+   // Stop wins over stale and survives clear_stale.
+   abort.request_stop();
+   abort.clear_stale();
+   result =
+      scan_nonce_range(work, uint256{}, uint256{}, 0U, 99U, control, nullptr);
+   REQUIRE(result.stop_reason == ScanStopReason::stop_requested);
+   REQUIRE((abort.load() & AbortFlag::stale) == 0U);
+}
+
+TEST_CASE("a swapped share target applies from the next block", "[scan]") {
+   using namespace cpu_miner;
+
+   auto work = make_work_state(make_accepted_job(),
+                               make_accepted_subscription(), 0U);
+
+   // Every hash meets the slot's target; the argument is ignored.
+   ShareTargetSlot slot;
+   slot.store(~uint256{});
+   ScanControl control{};
+   control.share_target = &slot;
+   control.min_check_hashes = 16U;
+   control.max_check_hashes = 16U;
+
+   // No hash meets zero; the first share swaps it in.
+   const auto result = scan_nonce_range(
+      work, uint256{}, uint256{}, 0U, 99U, control,
+      [&](std::uint32_t, const sha256::DigestBytes&, bool) {
+         slot.store(uint256{});
+      });
+
+   REQUIRE(result.stop_reason == ScanStopReason::exhausted);
+   REQUIRE(result.hashes_done == 100U);
+   // Only the single-hash first block ran on the old target.
+   REQUIRE(result.shares_found == 1U);
+   REQUIRE(slot.version() == 2U);
+}
@@ -0,0 +1,60 @@
+// tests/test_seen_shares.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+
+#include "mining_job/seen_shares.hpp"
+
+TEST_CASE("share fingerprint covers every field of the tuple",
+          "[seen_shares]") {
+   using namespace cpu_miner;
+
+   const ShareSubmission share{
+      .job_id = "b2",
+      .extranonce2_counter = 1U,
+      .extranonce2_size = 8U,
+      .ntime = 0x6553a1f4U,
+      .nonce = 0x1dac2b7cU,
+   };
+   const std::uint64_t fingerprint = share_fingerprint(share);
+   REQUIRE(share_fingerprint(share) == fingerprint);
+
+   auto other = share;
+   other.job_id = "b3";
+   REQUIRE(share_fingerprint(other) != fingerprint);
+
+   other = share;
+   other.extranonce2_counter = 2U;
+   REQUIRE(share_fingerprint(other) != fingerprint);
+
+   other = share;
+   other.ntime += 1U;
+   REQUIRE(share_fingerprint(other) != fingerprint);
+
+   other = share;
+   other.nonce += 1U;
+   REQUIRE(share_fingerprint(other) != fingerprint);
+}
+
+TEST_CASE("seen-share set reports repeats across growth", "[seen_shares]") {
+   using namespace cpu_miner;
+
+   SeenShareSet seen(2U);
+   for (std::uint64_t i = 0; i < 1000U; ++i) {
+      REQUIRE(seen.insert(i * 0x9e3779b97f4a7c15ULL));
+   }
+   REQUIRE(seen.size() == 1000U);
+
+   for (std::uint64_t i = 0; i < 1000U; ++i) {
+      REQUIRE(seen.contains(i * 0x9e3779b97f4a7c15ULL));
+      REQUIRE_FALSE(seen.insert(i * 0x9e3779b97f4a7c15ULL));
+   }
+   REQUIRE_FALSE(seen.contains(12345U));
+
+   // Zero is stored like any other fingerprint (i == 0 above).
+   REQUIRE(seen.contains(0U));
+
+   seen.clear();
+   REQUIRE(seen.size() == 0U);
+   REQUIRE(seen.insert(0U));
+}
@@ -0,0 +1,104 @@
+// tests/test_session.cpp
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "stratum_client/session.hpp"
+#include "stratum_client/stratum_client.hpp"
+
+namespace {
+
+// Listens without ever accepting: the kernel completes the TCP handshake,
+// but nothing is ever read or written.
+class SilentPool {
+ public:
+   SilentPool()
+      : acceptor_(io_, boost::asio::ip::tcp::endpoint(
+                          boost::asio::ip::make_address("127.0.0.1"), 0U)) {}
+
+   [[nodiscard]] std::string port() const {
+      return std::to_string(acceptor_.local_endpoint().port());
+   }
+
+ private:
+   boost::asio::io_context io_;
+   boost::asio::ip::tcp::acceptor acceptor_;
+};
+
+const cpu_miner::SessionCredentials kCredentials{
+   .user = "worker",
+   .password = "x",
+};
+
+} // namespace
+
+TEST_CASE("handshake with a silent pool times out", "[session]") {
+   using namespace std::chrono;
+
+   SilentPool pool;
+   cpu_miner::StratumClient client("127.0.0.1", pool.port());
+   cpu_miner::StratumSession session(client, kCredentials, {},
+                                     milliseconds(100));
+
+   const auto started = steady_clock::now();
+   try {
+      session.start();
+      FAIL("handshake with a silent pool returned");
+   } catch (const boost::system::system_error& ex) {
+      REQUIRE(ex.code() == boost::asio::error::timed_out);
+   }
+   REQUIRE(steady_clock::now() - started < seconds(5));
+}
+
+TEST_CASE("abort_io unblocks a handshake with no deadline", "[session]") {
+   using namespace std::chrono;
+
+   SilentPool pool;
+   cpu_miner::StratumClient client("127.0.0.1", pool.port());
+   cpu_miner::StratumSession session(client, kCredentials, {}, hours(1));
+
+   const std::jthread stopper([&client]() {
+      std::this_thread::sleep_for(milliseconds(100));
+      client.abort_io();
+   });
+
+   try {
+      session.start();
+      FAIL("handshake with a silent pool returned");
+   } catch (const boost::system::system_error& ex) {
+      REQUIRE(ex.code() == boost::asio::error::operation_aborted);
+   }
+}
+
+TEST_CASE("recover keeps retrying a silent pool until stop", "[session]") {
+   using namespace std::chrono;
+
+   SilentPool pool;
+   cpu_miner::StratumClient client("127.0.0.1", pool.port());
+   cpu_miner::StratumSession session(
+      client, kCredentials,
+      cpu_miner::BackoffConfig{.initial = milliseconds(10),
+                               .max = milliseconds(10),
+                               .multiplier = 1U},
+      milliseconds(50));
+
+   std::stop_source stop;
+   const std::jthread stopper([&stop]() {
+      std::this_thread::sleep_for(milliseconds(400));
+      stop.request_stop();
+   });
+
+   const auto started = steady_clock::now();
+   REQUIRE_FALSE(session.recover(stop.get_token()).has_value());
+   REQUIRE(steady_clock::now() - started >= milliseconds(400));
+   REQUIRE(steady_clock::now() - started < seconds(5));
+}
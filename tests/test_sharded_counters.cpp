@@ -0,0 +1,53 @@
+// tests/test_sharded_counters.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "util/sharded_counters.hpp"
+
+namespace {
+
+struct alignas(cpu_miner::util::kCacheLineBytes) TestBlock {
+   std::atomic<std::uint64_t> hashes{0};
+   std::atomic<std::uint64_t> shares{0};
+};
+
+} // namespace
+
+TEST_CASE("sharded counter blocks sit on separate cache lines",
+          "[sharded_counters]") {
+   cpu_miner::util::ShardedCounters<TestBlock> counters(4U);
+   REQUIRE(counters.size() == 4U);
+
+   for (std::size_t i = 0; i < counters.size(); ++i) {
+      const auto address = reinterpret_cast<std::uintptr_t>(&counters[i]);
+      REQUIRE(address % cpu_miner::util::kCacheLineBytes == 0U);
+   }
+   REQUIRE_THROWS_AS(cpu_miner::util::ShardedCounters<TestBlock>(0U),
+                     std::invalid_argument);
+}
+
+TEST_CASE("sharded counters sum each writer's block", "[sharded_counters]") {
+   constexpr std::size_t kWriters = 4U;
+   constexpr std::uint64_t kAdds = 10000U;
+
+   cpu_miner::util::ShardedCounters<TestBlock> counters(kWriters);
+   {
+      std::vector<std::jthread> writers;
+      for (std::size_t w = 0; w < kWriters; ++w) {
+         writers.emplace_back([&counters, w]() {
+            for (std::uint64_t i = 0; i < kAdds; ++i) {
+               cpu_miner::util::single_writer_add(counters[w].hashes, 3U);
+            }
+            cpu_miner::util::single_writer_add(counters[w].shares, w);
+         });
+      }
+   }
+
+   REQUIRE(counters.sum(&TestBlock::hashes) == kWriters * kAdds * 3U);
+   REQUIRE(counters.sum(&TestBlock::shares) == 0U + 1U + 2U + 3U);
+}
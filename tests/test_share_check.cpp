@@ -0,0 +1,68 @@
+// tests/test_share_check.cpp
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/share_check.hpp"
+#include "mining_job/target.hpp"
+#include "util/hex.hpp"
+
+namespace {
+
+using namespace cpu_miner;
+
+struct CheckFixture {
+   MiningJob job = make_accepted_job();
+   DecodedJob decoded = decode_job(job);
+   SubscriptionContext sub = make_accepted_subscription();
+   u256::uint256 target = share_target_from_difficulty(1.0);
+
+   [[nodiscard]] ShareCheck check(std::string_view extranonce2,
+                                  std::string_view ntime,
+                                  std::string_view nonce) const {
+      return check_share(job, decoded, sub, extranonce2, ntime, nonce, target);
+   }
+};
+
+} // namespace
+
+TEST_CASE("share check accepts the share ckpool accepted", "[share_check]") {
+   const CheckFixture f;
+
+   const auto check = f.check("0000000000000000", "69bccef7", "00293f3b");
+
+   REQUIRE(check.verdict == ShareVerdict::accepted);
+   REQUIRE(bytes_to_hex(check.hash) ==
+           "8bb6fe2d423e1030ca773a9e0f459f22bbbdb2f63bae0645e6118ca700000000");
+   REQUIRE_FALSE(check.block_candidate);
+}
+
+TEST_CASE("share check rejects hashes above the share target",
+          "[share_check]") {
+   const CheckFixture f;
+
+   REQUIRE(f.check("0000000000000000", "69bccef7", "00293f3c").verdict ==
+           ShareVerdict::above_target);
+   REQUIRE(f.check("0000000000000001", "69bccef7", "00293f3b").verdict ==
+           ShareVerdict::above_target);
+   // A rolled ntime changes the header, so the same nonce no longer wins.
+   REQUIRE(f.check("0000000000000000", "69bccef8", "00293f3b").verdict ==
+           ShareVerdict::above_target);
+}
+
+TEST_CASE("share check validates fields before hashing", "[share_check]") {
+   const CheckFixture f;
+
+   REQUIRE(f.check("00000000", "69bccef7", "00293f3b").verdict ==
+           ShareVerdict::invalid_extranonce2);
+   REQUIRE(f.check("000000000000000g", "69bccef7", "00293f3b").verdict ==
+           ShareVerdict::invalid_extranonce2);
+   REQUIRE(f.check("0000000000000000", "69bccef", "00293f3b").verdict ==
+           ShareVerdict::invalid_ntime);
+   REQUIRE(f.check("0000000000000000", "69bccef6", "00293f3b").verdict ==
+           ShareVerdict::ntime_out_of_range);
+   REQUIRE(f.check("0000000000000000", "69bcead0", "00293f3b").verdict ==
+           ShareVerdict::ntime_out_of_range);
+   REQUIRE(f.check("0000000000000000", "69bccef7", "293f3b").verdict ==
+           ShareVerdict::invalid_nonce);
+}
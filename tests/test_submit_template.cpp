@@ -0,0 +1,64 @@
+// tests/test_submit_template.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <string_view>
+
+#include "mining_job/accepted_fixture.hpp"
+#include "mining_job/work_state.hpp"
+#include "stratum_client/submit_template.hpp"
+#include "util/hex.hpp"
+
+TEST_CASE("submit template writes a ckpool mining.submit line",
+          "[submit_template]") {
+   using namespace cpu_miner;
+
+   SubmitTemplate tmpl("bc1qworker.cpu", "69b23e1000005c34", 8U);
+
+   REQUIRE(tmpl.fill(7, 0U, 0x69bccef7U, 0x00293f3bU) ==
+           R"({"id":         7,"method":"mining.submit","params":)"
+           R"(["bc1qworker.cpu","69b23e1000005c34","0000000000000000",)"
+           R"("69bccef7","00293f3b"]})");
+
+   const std::string_view first = tmpl.fill(1, 1U, 0U, 0U);
+   const std::string_view second =
+      tmpl.fill(2147483647, 0x0102030405060708ULL, 0xffffffffU, 0xa0b0c0d0U);
+
+   REQUIRE(first.data() == second.data());
+   REQUIRE(second == R"({"id":2147483647,"method":"mining.submit","params":)"
+                     R"(["bc1qworker.cpu","69b23e1000005c34","0102030405060708",)"
+                     R"("ffffffff","a0b0c0d0"]})");
+}
+
+TEST_CASE("submit template escapes worker and job strings",
+          "[submit_template]") {
+   using namespace cpu_miner;
+
+   SubmitTemplate tmpl("a\"b\\c", "j\n", 4U);
+
+   REQUIRE(tmpl.fill(3, 0xdeadbeefU, 1U, 2U) ==
+           R"({"id":         3,"method":"mining.submit","params":)"
+           R"(["a\"b\\c","j\u000a","deadbeef","00000001","00000002"]})");
+   REQUIRE(tmpl.matches("a\"b\\c", "j\n", 4U));
+   REQUIRE_FALSE(tmpl.matches("a\"b\\c", "j\n", 8U));
+   REQUIRE_FALSE(SubmitTemplate{}.matches("", "", 0U));
+}
+
+TEST_CASE("submit template agrees with the prepared work's hex fields",
+          "[submit_template]") {
+   using namespace cpu_miner;
+
+   const auto prepared =
+      prepare_work(make_accepted_job(), make_accepted_subscription(), 5U);
+   const auto share =
+      make_share_submission(prepared, u32_from_hex_be("00293f3b"));
+
+   SubmitTemplate tmpl("w", share.job_id, share.extranonce2_size);
+   const std::string expected =
+      R"({"id":        42,"method":"mining.submit","params":["w",")" +
+      prepared.job.job_id + R"(",")" + prepared.coinbase.extranonce2_hex +
+      R"(",")" + prepared.job.ntime + R"(",")" + "00293f3b" + R"("]})";
+
+   REQUIRE(tmpl.fill(42, share.extranonce2_counter, share.ntime,
+                     share.nonce) == expected);
+}
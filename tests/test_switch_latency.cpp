@@ -0,0 +1,94 @@
+// tests/test_switch_latency.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include "mining_job/switch_latency.hpp"
+
+TEST_CASE("latency summary uses nearest-rank percentiles", "[switch_latency]") {
+   using namespace cpu_miner;
+
+   std::vector<double> samples;
+   for (int i = 100; i >= 1; --i) {
+      samples.push_back(static_cast<double>(i));
+   }
+
+   const auto summary = summarize_latencies(samples);
+   REQUIRE(summary.count == 100U);
+   REQUIRE(summary.min_us == 1.0);
+   REQUIRE(summary.p50_us == 50.0);
+   REQUIRE(summary.p90_us == 90.0);
+   REQUIRE(summary.p99_us == 99.0);
+   REQUIRE(summary.max_us == 100.0);
+
+   REQUIRE(summarize_latencies({}).count == 0U);
+}
+
+TEST_CASE("switch latency completes once every worker hashes",
+          "[switch_latency]") {
+   using namespace cpu_miner;
+   using std::chrono::microseconds;
+
+   SwitchLatencyRecorder recorder(2U);
+   const auto t0 = SwitchLatencyRecorder::clock::now();
+
+   recorder.note_published(7U, t0, t0 + microseconds(10));
+   recorder.note_adopted(7U, 0U, t0 + microseconds(30));
+   recorder.note_adopted(7U, 1U, t0 + microseconds(50));
+   recorder.note_first_hash(7U, 0U, t0 + microseconds(40));
+
+   auto report = recorder.report();
+   REQUIRE(report.notify_to_publish.count == 1U);
+   REQUIRE(report.notify_to_publish.max_us == 10.0);
+   REQUIRE(report.publish_to_adopt.count == 2U);
+   REQUIRE(report.publish_to_adopt.min_us == 20.0);
+   REQUIRE(report.publish_to_adopt.max_us == 40.0);
+   REQUIRE(report.notify_to_all_hashing.count == 0U);
+
+   recorder.note_first_hash(7U, 1U, t0 + microseconds(90));
+   // Repeats and unknown generations are ignored.
+   recorder.note_first_hash(7U, 1U, t0 + microseconds(500));
+   recorder.note_adopted(99U, 0U, t0);
+
+   report = recorder.report();
+   REQUIRE(report.adopt_to_first_hash.count == 2U);
+   REQUIRE(report.adopt_to_first_hash.min_us == 10.0);
+   REQUIRE(report.adopt_to_first_hash.max_us == 40.0);
+   REQUIRE(report.notify_to_all_hashing.count == 1U);
+   REQUIRE(report.notify_to_all_hashing.max_us == 90.0);
+   REQUIRE(report.superseded == 0U);
+}
+
+TEST_CASE("late first-hash reports still match their generation",
+          "[switch_latency]") {
+   using namespace cpu_miner;
+   using std::chrono::microseconds;
+
+   SwitchLatencyRecorder recorder(1U);
+   const auto t0 = SwitchLatencyRecorder::clock::now();
+
+   recorder.note_published(1U, t0, t0);
+   recorder.note_adopted(1U, 0U, t0 + microseconds(5));
+   recorder.note_published(2U, t0 + microseconds(100), t0 + microseconds(100));
+   recorder.note_published(3U, t0 + microseconds(200), t0 + microseconds(200));
+
+   // The worker learns its first-hash time for generation 1 only when its
+   // chunk ends, after 2 and 3 were published.
+   recorder.note_first_hash(1U, 0U, t0 + microseconds(8));
+   recorder.note_adopted(3U, 0U, t0 + microseconds(210));
+   recorder.note_first_hash(3U, 0U, t0 + microseconds(215));
+
+   const auto report = recorder.report();
+   REQUIRE(report.notify_to_all_hashing.count == 2U);
+   REQUIRE(report.notify_to_all_hashing.min_us == 8.0);
+   REQUIRE(report.notify_to_all_hashing.max_us == 15.0);
+   REQUIRE(report.superseded == 1U);
+}
+
+TEST_CASE("switch latency recorder rejects a zero worker count",
+          "[switch_latency]") {
+   REQUIRE_THROWS_AS(cpu_miner::SwitchLatencyRecorder(0U),
+                     std::invalid_argument);
+}
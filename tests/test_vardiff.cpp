@@ -0,0 +1,145 @@
+// tests/test_vardiff.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#include "stratum_client/vardiff.hpp"
+
+namespace {
+
+// 2^32 hashes a second is one difficulty-10 share every 10 seconds.
+constexpr std::uint64_t kDifficulty10Rate = std::uint64_t{1} << 32;
+
+} // namespace
+
+TEST_CASE("vardiff suggests the difficulty for the target share rate",
+          "[vardiff]") {
+   using namespace cpu_miner;
+   using std::chrono::seconds;
+
+   VardiffController vardiff(VardiffConfig{.shares_per_minute = 6.0});
+   const auto t0 = VardiffController::clock::now();
+
+   std::optional<double> suggestion;
+   std::uint64_t hashes = 0U;
+   for (int s = 0; s <= 60; ++s) {
+      suggestion = vardiff.update(hashes, t0 + seconds(s));
+      // Nothing before min_interval has passed since the first sample.
+      if (s < 60) REQUIRE_FALSE(suggestion.has_value());
+      hashes += kDifficulty10Rate;
+   }
+
+   REQUIRE(suggestion.has_value());
+   // A steady rate leaves the average exact.
+   REQUIRE(*suggestion == 10.0);
+   REQUIRE(vardiff.hashrate_hps() == static_cast<double>(kDifficulty10Rate));
+   REQUIRE(vardiff.suggestions() == 1U);
+   REQUIRE(vardiff.suggested() == *suggestion);
+}
+
+TEST_CASE("vardiff holds its suggestion inside the hysteresis band",
+          "[vardiff]") {
+   using namespace cpu_miner;
+   using std::chrono::seconds;
+
+   VardiffController vardiff(VardiffConfig{
+      .shares_per_minute = 6.0,
+      .hysteresis = 2.0,
+      .averaging = seconds(1),
+      .min_interval = seconds(10),
+      .initial_difficulty = 10.0,
+   });
+   const auto t0 = VardiffController::clock::now();
+
+   // 1.5 times the rate for difficulty 10 stays within a factor of 2.
+   std::uint64_t hashes = 0U;
+   for (int s = 0; s <= 30; ++s) {
+      REQUIRE_FALSE(vardiff.update(hashes, t0 + seconds(s)).has_value());
+      hashes += kDifficulty10Rate + kDifficulty10Rate / 2U;
+   }
+
+   // Four times the rate leaves the band.
+   std::optional<double> suggestion;
+   for (int s = 31; s <= 60 && !suggestion; ++s) {
+      suggestion = vardiff.update(hashes, t0 + seconds(s));
+      hashes += 4U * kDifficulty10Rate;
+   }
+   REQUIRE(suggestion.has_value());
+   REQUIRE(*suggestion > 20.0);
+   REQUIRE(*suggestion <= 40.0);
+}
+
+TEST_CASE("vardiff never suggests below its initial difficulty",
+          "[vardiff]") {
+   using namespace cpu_miner;
+   using std::chrono::seconds;
+
+   VardiffController vardiff(VardiffConfig{
+      .initial_difficulty = 1.0,
+   });
+   const auto t0 = VardiffController::clock::now();
+
+   std::uint64_t hashes = 0U;
+   for (int s = 0; s <= 120; ++s) {
+      REQUIRE_FALSE(vardiff.update(hashes, t0 + seconds(s)).has_value());
+      hashes += 1'000'000U;
+   }
+   REQUIRE(vardiff.suggested() == 1.0);
+
+   REQUIRE_THROWS_AS(VardiffController(VardiffConfig{.shares_per_minute = 0}),
+                     std::invalid_argument);
+   REQUIRE_THROWS_AS(VardiffController(VardiffConfig{.hysteresis = 0.5}),
+                     std::invalid_argument);
+}
+
+TEST_CASE("split connections each suggest for their own hash slice",
+          "[vardiff]") {
+   using namespace cpu_miner;
+   using std::chrono::seconds;
+
+   // --split with weights 3:1 and a standby: each controller is fed only the
+   // hashes done on its own pool's work.
+   VardiffController heavy(VardiffConfig{.shares_per_minute = 6.0});
+   VardiffController light(VardiffConfig{.shares_per_minute = 6.0});
+   VardiffController standby(VardiffConfig{.shares_per_minute = 6.0});
+   const auto t0 = VardiffController::clock::now();
+
+   std::optional<double> heavy_suggestion;
+   std::optional<double> light_suggestion;
+   std::optional<double> standby_suggestion;
+   std::uint64_t heavy_hashes = 0U;
+   std::uint64_t light_hashes = 0U;
+   for (int s = 0; s <= 60; ++s) {
+      heavy_suggestion = heavy.update(heavy_hashes, t0 + seconds(s));
+      light_suggestion = light.update(light_hashes, t0 + seconds(s));
+      standby_suggestion = standby.update(0U, t0 + seconds(s));
+      heavy_hashes += 3U * kDifficulty10Rate;
+      light_hashes += kDifficulty10Rate;
+   }
+
+   // Each connection gets 6 shares a minute from its own slice.
+   REQUIRE(heavy_suggestion.has_value());
+   REQUIRE(*heavy_suggestion == 30.0);
+   REQUIRE(light_suggestion.has_value());
+   REQUIRE(*light_suggestion == 10.0);
+   REQUIRE_FALSE(standby_suggestion.has_value());
+   REQUIRE(standby.suggested() == 1.0);
+}
+
+TEST_CASE("vardiff savings are measured against difficulty 1", "[vardiff]") {
+   using namespace cpu_miner;
+
+   // 100 difficulty-1 shares' worth of hashes, 10 submits of 200 bytes.
+   const auto savings = estimate_vardiff_savings(
+      100U * (std::uint64_t{1} << 32), 1.0, 10U, 2000U);
+   REQUIRE(savings.baseline_submits == 100.0);
+   REQUIRE(savings.submits == 10U);
+   REQUIRE(savings.avoided_submits == 90.0);
+   REQUIRE(savings.avoided_bytes == 18000.0);
+
+   REQUIRE(estimate_vardiff_savings(0U, 1.0, 5U, 100U).avoided_submits ==
+           0.0);
+}
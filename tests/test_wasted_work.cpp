@@ -0,0 +1,123 @@
+// tests/test_wasted_work.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <optional>
+
+#include "mining_job/wasted_work.hpp"
+
+TEST_CASE("a scan straddling the notify is split by time", "[wasted_work]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   WastedWorkRecorder recorder;
+   const auto t0 = WastedWorkRecorder::clock::now();
+
+   recorder.note_published(1U, t0, false);
+   recorder.note_scan(1U, 1000U, t0, t0 + milliseconds(100));
+   recorder.note_published(2U, t0 + milliseconds(75), true);
+
+   auto report = recorder.report();
+   REQUIRE(report.hashes == 1000U);
+   REQUIRE(report.stale_hashes == 250U);
+   REQUIRE(report.clean_jobs_hashes == 250U);
+   REQUIRE(report.wasted_fraction() == 0.25);
+
+   // Scans on a superseded generation settle as they are reported.
+   recorder.note_scan(1U, 400U, t0 + milliseconds(100), t0 + milliseconds(120));
+   recorder.note_scan(2U, 600U, t0 + milliseconds(120), t0 + milliseconds(200));
+
+   report = recorder.report();
+   REQUIRE(report.hashes == 2000U);
+   REQUIRE(report.stale_hashes == 650U);
+
+   const auto first = recorder.generation_waste(1U);
+   REQUIRE(first.has_value());
+   REQUIRE(first->hashes == 1400U);
+   REQUIRE(first->stale_hashes == 650U);
+   REQUIRE(first->superseded);
+   REQUIRE(first->superseded_by_clean_jobs);
+
+   const auto second = recorder.generation_waste(2U);
+   REQUIRE(second.has_value());
+   REQUIRE(second->stale_hashes == 0U);
+   REQUIRE_FALSE(second->superseded);
+}
+
+TEST_CASE("only clean_jobs notifies count as rejected work", "[wasted_work]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   WastedWorkRecorder recorder;
+   const auto t0 = WastedWorkRecorder::clock::now();
+
+   recorder.note_published(1U, t0, false);
+   recorder.note_published(2U, t0 + milliseconds(10), false);
+   recorder.note_scan(1U, 100U, t0 + milliseconds(10), t0 + milliseconds(20));
+
+   const auto report = recorder.report();
+   REQUIRE(report.stale_hashes == 100U);
+   REQUIRE(report.clean_jobs_hashes == 0U);
+}
+
+TEST_CASE("discarded shares are counted per generation", "[wasted_work]") {
+   using namespace cpu_miner;
+
+   WastedWorkRecorder recorder;
+   const auto t0 = WastedWorkRecorder::clock::now();
+
+   recorder.note_published(1U, t0, false);
+   recorder.note_discarded_share(1U);
+   recorder.note_discarded_share(1U);
+   recorder.note_discarded_share(42U);
+
+   REQUIRE(recorder.report().discarded_shares == 3U);
+   REQUIRE(recorder.generation_waste(1U)->discarded_shares == 2U);
+   REQUIRE_FALSE(recorder.generation_waste(42U).has_value());
+}
+
+TEST_CASE("old generations are dropped but totals remain", "[wasted_work]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   WastedWorkRecorder recorder(2U);
+   const auto t0 = WastedWorkRecorder::clock::now();
+
+   REQUIRE(recorder.report().wasted_fraction() == 0.0);
+
+   recorder.note_published(1U, t0, false);
+   recorder.note_published(2U, t0 + milliseconds(10), false);
+   recorder.note_scan(1U, 50U, t0 + milliseconds(10), t0 + milliseconds(20));
+   recorder.note_published(3U, t0 + milliseconds(20), false);
+
+   REQUIRE_FALSE(recorder.generation_waste(1U).has_value());
+   REQUIRE(recorder.generation_waste(3U).has_value());
+
+   // Hashes on a dropped generation still count towards the total.
+   recorder.note_scan(1U, 50U, t0 + milliseconds(20), t0 + milliseconds(30));
+
+   const auto report = recorder.report();
+   REQUIRE(report.hashes == 100U);
+   REQUIRE(report.stale_hashes == 50U);
+   REQUIRE(report.wasted_fraction() == 0.5);
+}
+
+TEST_CASE("work that leaves earlier jobs valid makes nothing stale",
+          "[wasted_work]") {
+   using namespace cpu_miner;
+   using std::chrono::milliseconds;
+
+   WastedWorkRecorder recorder;
+   const auto t0 = WastedWorkRecorder::clock::now();
+
+   recorder.note_published(1U, t0, false);
+   recorder.note_published(2U, std::nullopt, false);
+   recorder.note_scan(1U, 100U, t0, t0 + milliseconds(20));
+   REQUIRE_FALSE(recorder.generation_waste(1U)->superseded);
+
+   // A later switch settles both, from its own notify time.
+   recorder.note_published(3U, t0 + milliseconds(10), true);
+   REQUIRE(recorder.generation_waste(1U)->superseded);
+   REQUIRE(recorder.generation_waste(2U)->superseded);
+   REQUIRE(recorder.report().stale_hashes == 50U);
+}
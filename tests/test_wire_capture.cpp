@@ -0,0 +1,103 @@
+// tests/test_wire_capture.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "stratum_client/wire_capture.hpp"
+
+using namespace cpu_miner;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<WireLine> parse(const std::string& text) {
+   std::istringstream in(text);
+   return parse_wire_capture(in);
+}
+
+} // namespace
+
+TEST_CASE("wire capture files round-trip through the parser",
+          "[wire_capture]") {
+   const auto dir =
+      std::filesystem::temp_directory_path() / "cpu_miner_wire_capture_test";
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir);
+   const auto path = dir / "session.capture";
+
+   {
+      WireCaptureWriter writer(path, "pool.example:3333");
+      writer.record(WireDirection::to_pool,
+                    R"({"id":1,"method":"mining.subscribe","params":[]})");
+      writer.record(WireDirection::from_pool, R"({"id":1,"result":true})");
+   }
+
+   const auto lines = load_wire_capture(path);
+   REQUIRE(lines.size() == 2U);
+   REQUIRE(lines[0].direction == WireDirection::to_pool);
+   REQUIRE(lines[0].text ==
+           R"({"id":1,"method":"mining.subscribe","params":[]})");
+   REQUIRE(lines[1].direction == WireDirection::from_pool);
+   REQUIRE(lines[1].text == R"({"id":1,"result":true})");
+   REQUIRE(lines[1].offset >= lines[0].offset);
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("wire capture parser skips comments and rejects bad lines",
+          "[wire_capture]") {
+   const auto lines = parse("# header\n"
+                            "\n"
+                            "15 < {\"a\":1}\r\n"
+                            "20 > {\"b\":2}\n");
+   REQUIRE(lines.size() == 2U);
+   REQUIRE(lines[0] == WireLine{.offset = 15us,
+                                .direction = WireDirection::from_pool,
+                                .text = "{\"a\":1}"});
+   REQUIRE(lines[1].direction == WireDirection::to_pool);
+
+   REQUIRE_THROWS_AS(parse("x < {}\n"), std::runtime_error);
+   REQUIRE_THROWS_AS(parse("5 ? {}\n"), std::runtime_error);
+   REQUIRE_THROWS_AS(parse("5 <{}\n"), std::runtime_error);
+   REQUIRE_THROWS_AS(parse("-5 < {}\n"), std::runtime_error);
+}
+
+TEST_CASE("replay delivers pool lines at their scaled offsets",
+          "[wire_capture]") {
+   WireReplay replay(parse("0 > {\"out\":1}\n"
+                           "1000 < {\"in\":1}\n"
+                           "2000 > {\"out\":2}\n"
+                           "4000 < {\"in\":2}\n"),
+                     2.0);
+
+   const auto start = WireReplay::clock::time_point{} + 1s;
+   replay.start(start);
+
+   REQUIRE(replay.next_due() == start + 500us);
+   REQUIRE_FALSE(replay.take_due(start + 499us).has_value());
+   REQUIRE(replay.take_due(start + 500us) == "{\"in\":1}");
+
+   REQUIRE(replay.next_due() == start + 2ms);
+   REQUIRE(replay.take_due(start + 3ms) == "{\"in\":2}");
+
+   REQUIRE(replay.finished());
+   REQUIRE(replay.delivered() == 2U);
+   REQUIRE_FALSE(replay.next_due().has_value());
+}
+
+TEST_CASE("replay at speed zero never waits", "[wire_capture]") {
+   WireReplay replay(parse("5000000 < {}\n9000000 < {}\n"), 0.0);
+   const auto start = WireReplay::clock::now();
+   replay.start(start);
+
+   REQUIRE(replay.take_due(start).has_value());
+   REQUIRE(replay.take_due(start).has_value());
+   REQUIRE(replay.finished());
+
+   REQUIRE_THROWS_AS(WireReplay({}, -1.0), std::invalid_argument);
+}
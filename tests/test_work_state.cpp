@@ -98,3 +98,63 @@ TEST_CASE("work_state remains a thin convenience wrapper", "[work_state]") {
    REQUIRE(bytes_to_hex(work.merkle_root_sha_input) ==
            bytes_to_hex(prepared.merkle_root_sha_input));
 }
+
+TEST_CASE("decoded job carries binary notify fields", "[work_state]") {
+   using namespace cpu_miner;
+
+   const auto job = make_fixture_job();
+   const auto decoded = decode_job(job);
+
+   REQUIRE(decoded.version == 0x20000000U);
+   REQUIRE(decoded.nbits == 0x1701f0ccU);
+   REQUIRE(decoded.ntime == 0x69bc9e60U);
+   REQUIRE(bytes_to_hex(decoded.prevhash_sha_input) ==
+           "fb03a060e68d5436225d39ed24a60873c5d1b088d76901000000000000000000");
+   REQUIRE(bytes_to_hex(decoded.coinb1) == job.coinb1);
+   REQUIRE(bytes_to_hex(decoded.coinb2) == job.coinb2);
+   REQUIRE(decoded.merkle_branch.size() == job.merkle_branch.size());
+   REQUIRE(bytes_to_hex(decoded.merkle_branch.back()) ==
+           job.merkle_branch.back());
+   REQUIRE(decoded.network_target ==
+           expand_compact_target(u32_from_hex_be(job.nbits)));
+}
+
+TEST_CASE("prepared work from a decoded job matches the hex path",
+          "[work_state]") {
+   using namespace cpu_miner;
+
+   const auto job = make_fixture_job();
+   const auto sub = make_fixture_subscription();
+   const auto decoded = decode_job(job);
+
+   const auto from_hex = prepare_work(job, sub, 3U);
+   const auto from_decoded = prepare_work(job, decoded, sub, 3U);
+
+   REQUIRE(from_decoded.extranonce2_hex == "0000000000000003");
+   REQUIRE(from_decoded.coinbase.coinbase_hex ==
+           from_hex.coinbase.coinbase_hex);
+   REQUIRE(from_decoded.merkle_root_raw_hex == from_hex.merkle_root_raw_hex);
+   REQUIRE(from_decoded.header_template.midstate ==
+           from_hex.header_template.midstate);
+   REQUIRE(from_decoded.header_template.block1 ==
+           from_hex.header_template.block1);
+}
+
+TEST_CASE("extranonce2 epochs start in disjoint regions", "[work_state]") {
+   using namespace cpu_miner;
+
+   REQUIRE(extranonce2_epoch_start(0U, 8U) == 0U);
+   REQUIRE(extranonce2_epoch_start(1U, 8U) == 0x0001000000000000ULL);
+   REQUIRE(extranonce2_epoch_start(0xffffU, 8U) == 0xffff000000000000ULL);
+   REQUIRE(extranonce2_epoch_start(0x10000U, 8U) == 0U);
+
+   REQUIRE(extranonce2_epoch_start(3U, 4U) == 0x00030000ULL);
+   REQUIRE(extranonce2_epoch_start(0x1234U, 2U) == 0x1234U);
+   REQUIRE(extranonce2_epoch_start(0x1234U, 1U) == 0x34U);
+
+   const auto sub = make_fixture_subscription();
+   const auto prepared = prepare_work(
+      make_fixture_job(), sub,
+      extranonce2_epoch_start(2U, sub.extranonce2_size));
+   REQUIRE(prepared.extranonce2_hex == "0002000000000000");
+}
@@ -0,0 +1,112 @@
+// tests/test_write_batch.cpp
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <string>
+
+#include "stratum_client/write_batch.hpp"
+
+TEST_CASE("write batch frames queued lines in order", "[write_batch]") {
+   using namespace cpu_miner;
+
+   WriteBatch batch(WriteBatchConfig{.max_linger = std::chrono::milliseconds(1),
+                                     .max_messages = 4U});
+   const auto t0 = WriteBatch::clock::now();
+
+   REQUIRE(batch.empty());
+   REQUIRE_FALSE(batch.due(t0));
+
+   batch.append("{\"id\":1}", t0);
+   batch.append("{\"id\":2}", t0);
+
+   REQUIRE(batch.size() == 2U);
+   REQUIRE(batch.buffers().size() == 4U);
+   REQUIRE(boost::asio::buffer_size(batch.buffers()) == 18U);
+
+   std::string joined(boost::asio::buffer_size(batch.buffers()), '\0');
+   boost::asio::buffer_copy(boost::asio::buffer(joined), batch.buffers());
+   REQUIRE(joined == "{\"id\":1}\n{\"id\":2}\n");
+}
+
+TEST_CASE("write batch is due on linger expiry or message count",
+          "[write_batch]") {
+   using namespace cpu_miner;
+
+   WriteBatch batch(WriteBatchConfig{.max_linger = std::chrono::milliseconds(1),
+                                     .max_messages = 3U});
+   const auto t0 = WriteBatch::clock::now();
+
+   batch.append("a", t0);
+   REQUIRE_FALSE(batch.due(t0));
+   REQUIRE_FALSE(batch.due(t0 + std::chrono::microseconds(999)));
+   REQUIRE(batch.due(t0 + std::chrono::milliseconds(1)));
+   REQUIRE(batch.deadline() == t0 + std::chrono::milliseconds(1));
+
+   // The linger clock starts with the oldest line, not the newest.
+   batch.append("b", t0 + std::chrono::microseconds(900));
+   REQUIRE(batch.deadline() == t0 + std::chrono::milliseconds(1));
+
+   batch.append("c", t0 + std::chrono::microseconds(950));
+   REQUIRE(batch.due(t0 + std::chrono::microseconds(950)));
+
+   batch.clear();
+   REQUIRE(batch.empty());
+   REQUIRE_FALSE(batch.due(t0 + std::chrono::seconds(1)));
+}
+
+TEST_CASE("default write batch flushes every message", "[write_batch]") {
+   using namespace cpu_miner;
+
+   WriteBatch batch;
+   const auto t0 = WriteBatch::clock::now();
+
+   batch.append("x", t0);
+   REQUIRE(batch.due(t0));
+
+   batch.configure(WriteBatchConfig{.max_linger = std::chrono::milliseconds(5),
+                                    .max_messages = 0U});
+   REQUIRE(batch.config().max_messages == 1U);
+}
+
+TEST_CASE("write batch sends several lines in one gather write",
+          "[write_batch]") {
+   using namespace cpu_miner;
+   using boost::asio::local::stream_protocol;
+
+   boost::asio::io_context io;
+   stream_protocol::socket writer(io);
+   stream_protocol::socket reader(io);
+   boost::asio::local::connect_pair(writer, reader);
+
+   WriteBatch batch(WriteBatchConfig{.max_linger = std::chrono::milliseconds(1),
+                                     .max_messages = 8U});
+   const auto now = WriteBatch::clock::now();
+   batch.append("first", now);
+   batch.append("second", now);
+   batch.append("third", now);
+
+   const std::string expected = "first\nsecond\nthird\n";
+   REQUIRE(batch.write_to(writer) == expected.size());
+   REQUIRE(batch.empty());
+   REQUIRE(batch.stats().gather_writes == 1U);
+   REQUIRE(batch.stats().lines_written == 3U);
+
+   std::string received(expected.size(), '\0');
+   boost::asio::read(reader, boost::asio::buffer(received));
+   REQUIRE(received == expected);
+
+   // Slots are reused for the next batch.
+   batch.append("fourth", now);
+   REQUIRE(batch.write_to(writer) == 7U);
+   REQUIRE(batch.stats().gather_writes == 2U);
+   REQUIRE(batch.stats().lines_written == 4U);
+
+   std::string tail(7U, '\0');
+   boost::asio::read(reader, boost::asio::buffer(tail));
+   REQUIRE(tail == "fourth\n");
+}